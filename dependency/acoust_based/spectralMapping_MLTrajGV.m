@@ -1,4 +1,4 @@
-function [targetMFCCs_GV_EM] =spectralMapping_MLTrajGV(test_MFCC,mix,trUttGVs,nonSilenceFrames)
+function [targetMFCCs_GV_EM] =spectralMapping_MLTrajGV(test_MFCC,mix,trUttGVs,nonSilenceFrames,cache,topK,segLengths)
 
 % The trajectory optimization methd considering the dynamics and GVs 
 % as described in Toda et al. voice conversion paper, 2008
@@ -11,41 +11,62 @@ x_ind = 1:size(test_MFCC,2); y_ind = (size(test_MFCC,2)+1):mix.nin;
 T = size(test_MFCC,1); % number of frames
 D = length(y_ind)/2;  % dimension of y ie 24 in our case.
 
-o.P= [];o.M=1:size(test_MFCC,2); % calculate probability p(X) % marginalize over all Y
-[~,~,~,pm_x] = GMpdf_SA_test(test_MFCC,mix.centres, mix.covars ,mix.priors',o); % pm_x gives me the p(m|X)
+if nargin < 6 || isempty(topK) || topK >= M
+    o.P= [];o.M=1:size(test_MFCC,2); % calculate probability p(X) % marginalize over all Y
+    [~,~,~,pm_x] = GMpdf_SA_test(test_MFCC,mix.centres, mix.covars ,mix.priors',o); % pm_x gives me the p(m|X)
+    sel_ind = repmat(1:M,T,1);
+else
+    % Gaussian selection, only the top-K mixtures of each frame are used,
+    % pm_x(t,k) is the posterior of mixture sel_ind(t,k)
+    [sel_ind,pm_x] = selectGaussians(mix,test_MFCC,topK);
+end
+K = size(sel_ind,2);
+% entries of sel_ind that use each mixture
+sel_entries = accumarray(sel_ind(:),(1:numel(sel_ind))',[M 1],@(v) {v});
 disp('calculate probability p(m|X)')
 %  [p,px_m,pxm,pm_x] = GMpdf(test_Ar ...
 % get the suboptimum sequence of mixture using argmax(p(m|x,model))
-[~,m_hat] =max(pm_x, [],2);
+[~,k_hat] =max(pm_x, [],2);
+m_hat = sel_ind(sub2ind([T K],(1:T)',k_hat));
 % 2b mmse --  use MMSE criteria to estimate MFCC
 % for each mixture find the Expected value of y for each time frame
 
-Ey_xm = nan(2*D,T,M);
+Ey_xm = nan(2*D,T,K); % Ey_xm(:,t,k) is for mixture sel_ind(t,k)
 DY_m = nan(2*D,2*D,M);
 Dy_m_inv = DY_m;
-for i = 1:mix.ncentres
-    % E(y)
-    muY_m = mix.centres(i,y_ind)';
-    switch mix.covar_type
-        case 'full'
-            covYX_m = mix.covars(y_ind,x_ind,i);
-            covXX_m = mix.covars(x_ind,x_ind,i);
-            covXY_m = mix.covars(x_ind,y_ind,i);
-            covYY_m = mix.covars(y_ind,y_ind,i);
-            DY_m(:,:,i) = covYY_m-covYX_m/covXX_m*covXY_m;
-            Dy_m_inv(:,:,i) = inv(DY_m(:,:,i));
+if nargin < 5 || isempty(cache)
+    for i = 1:mix.ncentres
+        % E(y)
+        muY_m = mix.centres(i,y_ind)';
+        switch mix.covar_type
+            case 'full'
+                covYX_m = mix.covars(y_ind,x_ind,i);
+                covXX_m = mix.covars(x_ind,x_ind,i);
+                covXY_m = mix.covars(x_ind,y_ind,i);
+                covYY_m = mix.covars(y_ind,y_ind,i);
+                DY_m(:,:,i) = covYY_m-covYX_m/covXX_m*covXY_m;
+                Dy_m_inv(:,:,i) = inv(DY_m(:,:,i));
             
-        case 'diag'
-            covYX_m = zeros(length(y_ind),length(x_ind));
-            covXX_m = diag(mix.covars(i,x_ind));
-            covXY_m = zeros(length(x_ind),length(y_ind));
-            covYY_m = diag(mix.covars(i,y_ind));
-            DY_m(:,:,i) = covYY_m;
-            Dy_m_inv(:,:,i) = inv(DY_m(:,:,i));
+            case 'diag'
+                covYX_m = zeros(length(y_ind),length(x_ind));
+                covXX_m = diag(mix.covars(i,x_ind));
+                covXY_m = zeros(length(x_ind),length(y_ind));
+                covYY_m = diag(mix.covars(i,y_ind));
+                DY_m(:,:,i) = covYY_m;
+                Dy_m_inv(:,:,i) = inv(DY_m(:,:,i));
+        end
+        % equation 11 from Toda voice conversion paper
+        sel = sel_entries{i}; t_ind = mod(sel-1,T)+1;
+        dist_fromMix_center = bsxfun(@minus,test_MFCC(t_ind,:)',mix.centres(i,x_ind)');
+        Ey_xm(:,sel) = bsxfun(@plus,muY_m,(covYX_m/covXX_m)*dist_fromMix_center);
+    end
+else
+    % Precomputed by warmConversionModel
+    Dy_m_inv = cache.DyInv;
+    for i = 1:mix.ncentres
+        sel = sel_entries{i}; t_ind = mod(sel-1,T)+1;
+        Ey_xm(:,sel) = bsxfun(@plus, cache.regression(:,:,i)*test_MFCC(t_ind,:)', cache.bias(:,i));
     end
-    % equation 11 from Toda voice conversion paper
-    dist_fromMix_center = test_MFCC' - repmat(mix.centres(i,x_ind)',1,T);
-    Ey_xm(:,:,i) = repmat(muY_m,1,T) + (covYX_m/covXX_m)*dist_fromMix_center;
 end
 % sum up the Ey weighted with priors pm_x to get MMSE estimate which will
 % be used as initial point for EM iteration
@@ -63,7 +84,12 @@ disp('done with the MMSE portion')
 % delta_multiplierMat = conv2(eye(T), d1ker, 'same');
 % W_elem = reshape([eye_W(:) ,delta_multiplierMat(:) ]', 2*T, T);
 % sparse matrix implementation to make it faster (?)
-W = generateW(T, D);
+% segLengths: the frames are separate segments, e.g., speech with the
+% silence cut out, and the trajectories do not cross them
+if nargin < 7
+    segLengths = [];
+end
+W = generateW(T, D, segLengths);
 % W = sparse(2*D*T,D*T);
 % for i_row = 1:2*T
     % for i_col = 1:T
@@ -79,7 +105,7 @@ DYt_inv_EYtBar = nan(size(Ymmse));
 for t_sample = 1:size(test_MFCC,1)
     % calculate mean and Variance of Y using suboptimum most likely
     % mixture sequence for a given sequence of articulatory sequence
-    DYt_inv_EYtBar(:,t_sample)= squeeze(Dy_m_inv(:,:,m_hat(t_sample)))*squeeze(Ey_xm(:,t_sample,m_hat(t_sample)));
+    DYt_inv_EYtBar(:,t_sample)= squeeze(Dy_m_inv(:,:,m_hat(t_sample)))*squeeze(Ey_xm(:,t_sample,k_hat(t_sample)));
     diagElemInd = (t_sample-1)*2*D+(1:2*D);
     DY_invBar(diagElemInd, diagElemInd) = Dy_m_inv(:,:,m_hat(t_sample));
 end
@@ -114,12 +140,18 @@ for iter = 1:20 % maximum number of iterations
     Y_newSerial =W*y_newSerial; % new value of Y , iterate the process, get new pm_xy and continue
     Y = reshape(Y_newSerial,numel(Y_newSerial)/T,T);
     
-    o.P= [];o.M=1:size(mix.centres,2); % calculate probability p(X,Y)
-    [pxy,~,~,pm_xy] = GMpdf_SA_test([test_MFCC Y'],mix.centres, mix.covars ,mix.priors',o); % pm_XY gives me the p(m|X,Y)
+    if K == M
+        o.P= [];o.M=1:size(mix.centres,2); % calculate probability p(X,Y)
+        [pxy,~,~,pm_xy] = GMpdf_SA_test([test_MFCC Y'],mix.centres, mix.covars ,mix.priors',o); % pm_XY gives me the p(m|X,Y)
+    else
+        % p(m|X,Y) over the selected mixtures only
+        logp_xym = gmmLogDensity(mix,[test_MFCC Y'],1:mix.nin,sel_ind);
+        pm_xy = exp(bsxfun(@minus,logp_xym,max(logp_xym,[],2)));
+        pm_xy = bsxfun(@rdivide,pm_xy,sum(pm_xy,2));
+    end
        
     % get p(m,Y |X,model)
     % log likelihood of data
-    mean(log(pxy));
     % log likelihood of GV
     % mean(log(mvnpdf(var(Y(1:D,nonSilenceFrames),0,2)', mu_gv,cov(trUttGVs))))
     
@@ -127,9 +159,10 @@ for iter = 1:20 % maximum number of iterations
     for t_sample = 1:size(test_MFCC,1)
         DY_inv_msum = zeros(length(y_ind),length(y_ind));
         DY_inv_EYt_msum = zeros(length(y_ind),1);
-        for i_mix = 1:M
-            DY_inv_msum = DY_inv_msum+ pm_xy(t_sample,i_mix).* Dy_m_inv(:,:,i_mix);
-            DY_inv_EYt_msum = DY_inv_EYt_msum + pm_xy(t_sample,i_mix).* squeeze(Dy_m_inv(:,:,i_mix))*squeeze(Ey_xm(:,t_sample,i_mix));
+        for i_mix = 1:K
+            m_ind = sel_ind(t_sample,i_mix);
+            DY_inv_msum = DY_inv_msum+ pm_xy(t_sample,i_mix).* Dy_m_inv(:,:,m_ind);
+            DY_inv_EYt_msum = DY_inv_EYt_msum + pm_xy(t_sample,i_mix).* squeeze(Dy_m_inv(:,:,m_ind))*squeeze(Ey_xm(:,t_sample,i_mix));
         end
         
         DYt_inv_EYtBar(:,t_sample)= DY_inv_EYt_msum;
@@ -1,4 +1,4 @@
-function [targetMFCCs_MMSE] =spectralMapping_MMSE(test_MFCC,mix)
+function [targetMFCCs_MMSE] =spectralMapping_MMSE(test_MFCC,mix,cache,topK)
 
 % using approximation method to estimate minimum mean square error estimate 
 % as described in Toda Black Tokuda Voice conversion 2008 paper
@@ -11,40 +11,59 @@ x_ind = 1:size(test_MFCC,2); y_ind = (size(test_MFCC,2)+1):mix.nin;
 T = size(test_MFCC,1); % number of frames
 D = length(y_ind)/2;  % dimension of y ie 24 in our case.
 
-o.P= [];o.M=1:size(test_MFCC,2); % calculate probability p(X) % marginalize over all Y
-[~,~,~,pm_x] = GMpdf_SA_test(test_MFCC,mix.centres, mix.covars ,mix.priors',o); % pm_x gives me the p(m|X)
+if nargin < 4 || isempty(topK) || topK >= M
+    o.P= [];o.M=1:size(test_MFCC,2); % calculate probability p(X) % marginalize over all Y
+    [~,~,~,pm_x] = GMpdf_SA_test(test_MFCC,mix.centres, mix.covars ,mix.priors',o); % pm_x gives me the p(m|X)
+    sel_ind = repmat(1:M,T,1);
+else
+    % Gaussian selection, only the top-K mixtures of each frame are used,
+    % pm_x(t,k) is the posterior of mixture sel_ind(t,k)
+    [sel_ind,pm_x] = selectGaussians(mix,test_MFCC,topK);
+end
+K = size(sel_ind,2);
+% entries of sel_ind that use each mixture
+sel_entries = accumarray(sel_ind(:),(1:numel(sel_ind))',[M 1],@(v) {v});
 %  [p,px_m,pxm,pm_x] = GMpdf(test_Ar ...
 % get the suboptimum sequence of mixture using argmax(p(m|x,model))
 % [~,m_hat] =max(pm_x, [],2);
 % 2b mmse --  use MMSE criteria to estimate MFCC
 % for each mixture find the Expected value of y for each time frame
 
-Ey_xm = nan(2*D,T,M);
+Ey_xm = nan(2*D,T,K); % Ey_xm(:,t,k) is for mixture sel_ind(t,k)
 % DY_m = nan(2*D,2*D,M);
 % Dy_m_inv = DY_m;
-for i = 1:mix.ncentres
-    % E(y)
-    muY_m = mix.centres(i,y_ind)';
-    switch mix.covar_type
-        case 'full'
-            covYX_m = mix.covars(y_ind,x_ind,i);
-            covXX_m = mix.covars(x_ind,x_ind,i);
-           % covXY_m = mix.covars(x_ind,y_ind,i);
-           % covYY_m = mix.covars(y_ind,y_ind,i);
-           % DY_m(:,:,i) = covYY_m-covYX_m/covXX_m*covXY_m;
-           % Dy_m_inv(:,:,i) = inv(DY_m(:,:,i));
+if nargin < 3 || isempty(cache)
+    for i = 1:mix.ncentres
+        % E(y)
+        muY_m = mix.centres(i,y_ind)';
+        switch mix.covar_type
+            case 'full'
+                covYX_m = mix.covars(y_ind,x_ind,i);
+                covXX_m = mix.covars(x_ind,x_ind,i);
+               % covXY_m = mix.covars(x_ind,y_ind,i);
+               % covYY_m = mix.covars(y_ind,y_ind,i);
+               % DY_m(:,:,i) = covYY_m-covYX_m/covXX_m*covXY_m;
+               % Dy_m_inv(:,:,i) = inv(DY_m(:,:,i));
             
-        case 'diag'
-            covYX_m = zeros(length(y_ind),length(x_ind));
-            covXX_m = diag(mix.covars(i,x_ind));
-           % covXY_m = zeros(length(x_ind),length(y_ind));
-           % covYY_m = diag(mix.covars(i,y_ind));
-           % DY_m(:,:,i) = covYY_m;
-           % Dy_m_inv(:,:,i) = inv(DY_m(:,:,i));
+            case 'diag'
+                covYX_m = zeros(length(y_ind),length(x_ind));
+                covXX_m = diag(mix.covars(i,x_ind));
+               % covXY_m = zeros(length(x_ind),length(y_ind));
+               % covYY_m = diag(mix.covars(i,y_ind));
+               % DY_m(:,:,i) = covYY_m;
+               % Dy_m_inv(:,:,i) = inv(DY_m(:,:,i));
+        end
+        % equation 11 from Toda voice conversion paper
+        sel = sel_entries{i}; t_ind = mod(sel-1,T)+1;
+        dist_fromMix_center = bsxfun(@minus,test_MFCC(t_ind,:)',mix.centres(i,x_ind)');
+        Ey_xm(:,sel) = bsxfun(@plus,muY_m,(covYX_m/covXX_m)*dist_fromMix_center);
+    end
+else
+    % Precomputed by warmConversionModel
+    for i = 1:mix.ncentres
+        sel = sel_entries{i}; t_ind = mod(sel-1,T)+1;
+        Ey_xm(:,sel) = bsxfun(@plus, cache.regression(:,:,i)*test_MFCC(t_ind,:)', cache.bias(:,i));
     end
-    % equation 11 from Toda voice conversion paper
-    dist_fromMix_center = test_MFCC' - repmat(mix.centres(i,x_ind)',1,T);
-    Ey_xm(:,:,i) = repmat(muY_m,1,T) + (covYX_m/covXX_m)*dist_fromMix_center;
 end
 % sum up the Ey weighted with priors pm_x to get MMSE estimate which will
 % be used as initial point for EM iteration
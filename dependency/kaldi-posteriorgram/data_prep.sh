@@ -22,6 +22,7 @@
 # │   ├── 0003.wav
 
 n_split=8
+nj=8  # number of parallel jobs for MFCC extraction
 
 echo "$0 $@"  # Print the command line for logging
 
@@ -37,6 +38,7 @@ if [ "$#" -ne 2 ]; then
   echo "e.g.: $0 /export/data/speaker data/speaker"
   echo "options:"
   echo "  --n_split 8"
+  echo "  --nj 8"
   exit 1
 fi
 
@@ -82,7 +84,7 @@ splits=$n_split
 mkdir -p $dst/make_mfcc_log/
 mkdir -p $dst/mfcc/
 for part in $(seq $splits); do 
-  steps/make_mfcc.sh --cmd utils/run.pl --mfcc-config ./conf/mfcc.conf --nj 8 --write-utt2num-frames true \
+  steps/make_mfcc.sh --cmd utils/run.pl --mfcc-config ./conf/mfcc.conf --nj $nj --write-utt2num-frames true \
     $dst/split$n_split\utt/$part/ $dst/make_mfcc_log/$part $dst/mfcc/$part
 
 # Get CMVN stats
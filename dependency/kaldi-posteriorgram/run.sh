@@ -35,14 +35,15 @@ cd $SCRIPTPATH
 n_split=1   # how many splits you want
 input_dir=$1
 output_dir=$2
+nj=${3:-8}  # number of parallel jobs, should not exceed the number of utterances
 
-./data_prep.sh --n_split $n_split ${input_dir} ${output_dir}
+./data_prep.sh --n_split $n_split --nj $nj ${input_dir} ${output_dir}
 
 # Get posteriors
 for part in $(seq $n_split); do 
-    ./make_posteriors.sh --nj 8 ${output_dir}/split$n_split\utt/$part ${output_dir}/split$n_split\utt/$part/post ./exp/nnet7a_960_gpu ${output_dir}/split$n_split\utt/$part/post ${output_dir}/dump_post_log/$part
+    ./make_posteriors.sh --nj $nj ${output_dir}/split$n_split\utt/$part ${output_dir}/split$n_split\utt/$part/post ./exp/nnet7a_960_gpu ${output_dir}/split$n_split\utt/$part/post ${output_dir}/dump_post_log/$part
 done
 
 cd -
 
-# Sample code: ./run.sh input_dir output_dir
\ No newline at end of file
+# Sample code: ./run.sh input_dir output_dir [nj]
\ No newline at end of file
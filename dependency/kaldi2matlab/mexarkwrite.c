@@ -0,0 +1,516 @@
+/******************************************************************
+ * mexarkwrite: write matrices to a Kaldi binary ark file, as float
+ * matrices ('FM') or as Kaldi compressed matrices ('CM', one byte per
+ * value with per-column percentile headers, which is what
+ * 'copy-feats --compress=true' writes for speech features; 'CM2', two
+ * bytes per value with a global range). The output can be read by Kaldi
+ * tools and by readArk.m.
+ *
+ * The entries are packed into a large buffer and written with one fwrite
+ * per buffer instead of a few small writes per utterance. The ark and the
+ * scp are first written to temp files and renamed when everything has
+ * been written, so readers never see a partial archive or an index that
+ * points past the end of the archive. The scp offsets are counted while
+ * packing, they do not depend on ftell.
+ *
+ * Use mex to compile this function and then call it from matlab using the
+ * syntax below (or use writeArk.m),
+ * offsets = mexarkwrite(arkFile, scpFile, keys, mats, format);
+ *
+ * Inputs:
+ *  arkFile: path to the output ark file, overwritten
+ *  scpFile: path to the output scp file, '' for none
+ *  keys: cell array of N utterance ids, no whitespace
+ *  mats: cell array of N matrices, single or double, D*T with one frame
+ *  per column (i.e., a T*D Kaldi matrix with one frame per row)
+ *  format: 'float' | 'cm' | 'cm2'
+ *
+ * Output:
+ *  offsets: N*1 vector, the byte offset of each matrix in the ark, as in
+ *  the scp
+ *
+ * The core functions do not depend on Matlab, the gateway is only built
+ * under MATLAB_MEX_FILE, see script/benchNativeKernels.c.
+ *
+ * Compilation (from Matlab, in this folder):
+ *  mex mexarkwrite.c
+ *
+ * Guanlong Zhao (gzhao@tamu.edu)
+ * Created: 10/18/2026
+ * Last Modified: 10/18/2026
+ * Revision log:
+ *  10/18/2026: function creation, GZ
+ *
+ * Copyright 2026 Guanlong Zhao
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+****************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+
+#ifdef MATLAB_MEX_FILE
+#include "mex.h"
+#endif
+
+#define ARK_FLOAT 0
+#define ARK_CM 1
+#define ARK_CM2 2
+
+/* Default size of the write buffer */
+#define ARK_BUFFER_SIZE (8 << 20)
+
+typedef struct {
+   FILE *fp;
+   unsigned char *buf;
+   size_t used;
+   size_t size;
+   long long offset;  /* bytes packed so far, flushed or not */
+   int failed;
+} ArkWriter;
+
+static int arkOpen(ArkWriter *w, const char *path, size_t bufSize)
+{
+   memset(w, 0, sizeof(ArkWriter));
+   w->buf = (unsigned char *) malloc(bufSize);
+   if (w->buf == NULL)
+      return -1;
+   w->size = bufSize;
+   w->fp = fopen(path, "wb");
+   if (w->fp == NULL) {
+      free(w->buf);
+      w->buf = NULL;
+      return -1;
+   }
+   return 0;
+}
+
+static void arkFlush(ArkWriter *w)
+{
+   if (w->used > 0 && fwrite(w->buf, 1, w->used, w->fp) != w->used)
+      w->failed = 1;
+   w->used = 0;
+}
+
+/* Make room for n bytes in the buffer, return where to write them */
+static unsigned char *arkReserve(ArkWriter *w, size_t n)
+{
+   unsigned char *dst;
+
+   if (w->used + n > w->size) {
+      arkFlush(w);
+      if (n > w->size) {
+         dst = (unsigned char *) realloc(w->buf, n);
+         if (dst == NULL) {
+            w->failed = 1;
+            return NULL;
+         }
+         w->buf = dst;
+         w->size = n;
+      }
+   }
+   dst = w->buf + w->used;
+   w->used += n;
+   w->offset += (long long) n;
+   return dst;
+}
+
+static void arkPut(ArkWriter *w, const void *data, size_t n)
+{
+   unsigned char *dst = arkReserve(w, n);
+
+   if (dst != NULL)
+      memcpy(dst, data, n);
+}
+
+static void arkPutInt32(ArkWriter *w, int32_t v)
+{
+   unsigned char size = 4;
+
+   arkPut(w, &size, 1);
+   arkPut(w, &v, 4);
+}
+
+/* Returns 0 on success */
+static int arkClose(ArkWriter *w)
+{
+   int failed;
+
+   if (w->fp != NULL) {
+      arkFlush(w);
+      if (fclose(w->fp) != 0)
+         w->failed = 1;
+   }
+   free(w->buf);
+   failed = w->failed;
+   memset(w, 0, sizeof(ArkWriter));
+   return failed ? -1 : 0;
+}
+
+/* The value of rank k (0-based) of v[0..n-1], v is reordered */
+static float arkSelect(float *v, int n, int k)
+{
+   int lo = 0, hi = n - 1, i, j;
+   float pivot, t;
+
+   while (lo < hi) {
+      pivot = v[lo + (hi - lo) / 2];
+      i = lo;
+      j = hi;
+      while (i <= j) {
+         while (v[i] < pivot)
+            i++;
+         while (v[j] > pivot)
+            j--;
+         if (i <= j) {
+            t = v[i];
+            v[i] = v[j];
+            v[j] = t;
+            i++;
+            j--;
+         }
+      }
+      if (k <= j)
+         hi = j;
+      else if (k >= i)
+         lo = i;
+      else
+         break;
+   }
+   return v[k];
+}
+
+/* Same rounding as Kaldi's CompressedMatrix */
+static uint16_t arkFloatToUint16(float minValue, float range, float value)
+{
+   float f = (value - minValue) / range;
+
+   if (f > 1.0f)
+      f = 1.0f;
+   if (f < 0.0f)
+      f = 0.0f;
+   return (uint16_t) (int) (f * 65535 + 0.499f);
+}
+
+static float arkUint16ToFloat(float minValue, float range, uint16_t value)
+{
+   return minValue + range * 1.52590218966964e-05F * value;
+}
+
+static uint8_t arkFloatToChar(float p0, float p25, float p75, float p100,
+                              float value)
+{
+   int ans;
+   float f;
+
+   if (value < p25) {
+      f = (value - p0) / (p25 - p0);
+      ans = (int) (f * 64 + 0.5f);
+      if (ans < 0)
+         ans = 0;
+      if (ans > 64)
+         ans = 64;
+   } else if (value < p75) {
+      f = (value - p25) / (p75 - p25);
+      ans = 64 + (int) (f * 128 + 0.5f);
+      if (ans < 64)
+         ans = 64;
+      if (ans > 192)
+         ans = 192;
+   } else {
+      f = (value - p75) / (p100 - p75);
+      ans = 192 + (int) (f * 63 + 0.5f);
+      if (ans < 192)
+         ans = 192;
+      if (ans > 255)
+         ans = 255;
+   }
+   return (uint8_t) ans;
+}
+
+static uint16_t arkMin16(int a, int b)
+{
+   return (uint16_t) (a < b ? a : b);
+}
+
+static uint16_t arkMax16(int a, int b)
+{
+   return (uint16_t) (a > b ? a : b);
+}
+
+/* Per-column header of 'CM': the 0, 25, 75, and 100th percentiles of the
+ * column, as Kaldi's ComputeColHeader; sdata is a copy of the column */
+static void arkColHeader(float minValue, float range, float *sdata,
+                         int numRows, uint16_t header[4])
+{
+   int quarter;
+   float q0, q25, q75, q100;
+
+   if (numRows >= 5) {
+      quarter = numRows / 4;
+      q25 = arkSelect(sdata, numRows, quarter);
+      q0 = arkSelect(sdata, quarter, 0);
+      q75 = arkSelect(sdata + quarter + 1, numRows - quarter - 1,
+                      3 * quarter - quarter - 1);
+      q100 = arkSelect(sdata + 3 * quarter + 1, numRows - 3 * quarter - 1,
+                       numRows - 3 * quarter - 2);
+      header[0] = arkMin16(arkFloatToUint16(minValue, range, q0), 65532);
+      header[1] = arkMin16(arkMax16(arkFloatToUint16(minValue, range, q25),
+                                    header[0] + 1), 65533);
+      header[2] = arkMin16(arkMax16(arkFloatToUint16(minValue, range, q75),
+                                    header[1] + 1), 65534);
+      header[3] = arkMax16(arkFloatToUint16(minValue, range, q100),
+                           header[2] + 1);
+   } else {
+      /* Sort the few values, they are at most 4 */
+      int i, j;
+      float t;
+      for (i = 1; i < numRows; i++)
+         for (j = i; j > 0 && sdata[j - 1] > sdata[j]; j--) {
+            t = sdata[j];
+            sdata[j] = sdata[j - 1];
+            sdata[j - 1] = t;
+         }
+      header[0] = arkMin16(arkFloatToUint16(minValue, range, sdata[0]),
+                           65532);
+      if (numRows > 1)
+         header[1] = arkMin16(arkMax16(arkFloatToUint16(minValue, range,
+                              sdata[1]), header[0] + 1), 65533);
+      else
+         header[1] = header[0] + 1;
+      if (numRows > 2)
+         header[2] = arkMin16(arkMax16(arkFloatToUint16(minValue, range,
+                              sdata[2]), header[1] + 1), 65534);
+      else
+         header[2] = header[1] + 1;
+      if (numRows > 3)
+         header[3] = arkMax16(arkFloatToUint16(minValue, range, sdata[3]),
+                              header[2] + 1);
+      else
+         header[3] = header[2] + 1;
+   }
+}
+
+/* Write one entry, 'data' is numRows*numCols, row-major (one frame per
+ * row), 'work' holds at least numRows floats. Returns the offset of the
+ * matrix in the ark, i.e., what goes into the scp, or -1 on error. */
+static long long arkWriteMatrix(ArkWriter *w, const char *key,
+                                const float *data, int numRows,
+                                int numCols, int format, float *work)
+{
+   long long offset;
+   long numValues = (long) numRows * numCols;
+   float minValue, maxValue, range, header[2];
+   int32_t dims[2];
+   long i;
+   int r, c;
+
+   arkPut(w, key, strlen(key));
+   arkPut(w, " ", 1);
+   offset = w->offset;
+   arkPut(w, "\0B", 2);
+   if (format == ARK_FLOAT) {
+      arkPut(w, "FM ", 3);
+      arkPutInt32(w, numRows);
+      arkPutInt32(w, numCols);
+      arkPut(w, data, sizeof(float) * numValues);
+      return w->failed ? -1 : offset;
+   }
+
+   arkPut(w, format == ARK_CM ? "CM " : "CM2 ", format == ARK_CM ? 3 : 4);
+   minValue = 0.0f;
+   maxValue = 0.0f;
+   for (i = 0; i < numValues; i++) {
+      if (data[i] != data[i] || data[i] - data[i] != 0.0f)
+         return -1;  /* NaN or Inf, Kaldi cannot compress them either */
+      if (i == 0 || data[i] < minValue)
+         minValue = data[i];
+      if (i == 0 || data[i] > maxValue)
+         maxValue = data[i];
+   }
+   if (maxValue == minValue)
+      maxValue = minValue + (1.0f + (float) fabs(minValue));
+   range = maxValue - minValue;
+   if (numValues == 0) {
+      minValue = 0.0f;
+      range = 0.0f;
+      numRows = 0;
+      numCols = 0;
+   }
+   header[0] = minValue;
+   header[1] = range;
+   dims[0] = numRows;
+   dims[1] = numCols;
+   arkPut(w, header, sizeof(header));
+   arkPut(w, dims, sizeof(dims));
+
+   if (format == ARK_CM2) {
+      unsigned char *dst = arkReserve(w, 2 * (size_t) numValues);
+      uint16_t v;
+      if (dst == NULL)
+         return -1;
+      for (i = 0; i < numValues; i++) {
+         v = arkFloatToUint16(minValue, range, data[i]);
+         memcpy(dst + 2 * i, &v, 2);
+      }
+   } else {
+      /* Column headers, then the bytes of each column, reserved at once
+       * so that a flush cannot split them */
+      unsigned char *colHeaders =
+          arkReserve(w, 8 * (size_t) numCols + (size_t) numValues);
+      unsigned char *dst = colHeaders + 8 * (size_t) numCols;
+      uint16_t colHeader[4];
+      float p0, p25, p75, p100;
+      if (colHeaders == NULL)
+         return -1;
+      for (c = 0; c < numCols; c++) {
+         for (r = 0; r < numRows; r++)
+            work[r] = data[(long) r * numCols + c];
+         arkColHeader(minValue, range, work, numRows, colHeader);
+         memcpy(colHeaders + 8 * c, colHeader, 8);
+         p0 = arkUint16ToFloat(minValue, range, colHeader[0]);
+         p25 = arkUint16ToFloat(minValue, range, colHeader[1]);
+         p75 = arkUint16ToFloat(minValue, range, colHeader[2]);
+         p100 = arkUint16ToFloat(minValue, range, colHeader[3]);
+         for (r = 0; r < numRows; r++)
+            dst[(long) c * numRows + r] =
+                arkFloatToChar(p0, p25, p75, p100,
+                               data[(long) r * numCols + c]);
+      }
+   }
+   return w->failed ? -1 : offset;
+}
+
+#ifdef MATLAB_MEX_FILE
+/* The gateway function */
+void mexFunction(int nlhs, mxArray *plhs[],
+                 int nrhs, const mxArray *prhs[])
+{
+   char *arkFile, *scpFile, *formatName, *key, *tempArk, *tempScp;
+   const mxArray *keys, *mats, *mat;
+   ArkWriter w;
+   FILE *scp = NULL;
+   float *floats = NULL, *work = NULL;
+   size_t numFloats = 0, numWork = 0, numValues, j;
+   double *offsets, *values;
+   mwSize numUtts, i;
+   int format, numRows, numCols, failed = 0;
+
+   if (nrhs != 5)
+      mexErrMsgIdAndTxt("mexarkwrite:nrhs", "Five inputs required.");
+   if (!mxIsChar(prhs[0]) || !mxIsChar(prhs[1]) || !mxIsChar(prhs[4]))
+      mexErrMsgIdAndTxt("mexarkwrite:notString",
+                        "arkFile, scpFile, and format must be strings.");
+   if (!mxIsCell(prhs[2]) || !mxIsCell(prhs[3])
+       || mxGetNumberOfElements(prhs[2]) != mxGetNumberOfElements(prhs[3]))
+      mexErrMsgIdAndTxt("mexarkwrite:notCell",
+                        "keys and mats must be cell arrays of equal size.");
+   formatName = mxArrayToString(prhs[4]);
+   if (strcmp(formatName, "float") == 0)
+      format = ARK_FLOAT;
+   else if (strcmp(formatName, "cm") == 0)
+      format = ARK_CM;
+   else if (strcmp(formatName, "cm2") == 0)
+      format = ARK_CM2;
+   else
+      mexErrMsgIdAndTxt("mexarkwrite:format", "Unknown format '%s'.",
+                        formatName);
+   mxFree(formatName);
+
+   arkFile = mxArrayToString(prhs[0]);
+   scpFile = mxArrayToString(prhs[1]);
+   keys = prhs[2];
+   mats = prhs[3];
+   numUtts = mxGetNumberOfElements(keys);
+   tempArk = (char *) mxCalloc(strlen(arkFile) + 5, 1);
+   sprintf(tempArk, "%s.tmp", arkFile);
+   tempScp = (char *) mxCalloc(strlen(scpFile) + 5, 1);
+   sprintf(tempScp, "%s.tmp", scpFile);
+   if (arkOpen(&w, tempArk, ARK_BUFFER_SIZE) != 0)
+      mexErrMsgIdAndTxt("mexarkwrite:open", "Cannot write %s.", tempArk);
+   if (scpFile[0] != '\0' && (scp = fopen(tempScp, "w")) == NULL) {
+      arkClose(&w);
+      remove(tempArk);
+      mexErrMsgIdAndTxt("mexarkwrite:open", "Cannot write %s.", tempScp);
+   }
+   plhs[0] = mxCreateDoubleMatrix(numUtts, 1, mxREAL);
+   offsets = mxGetPr(plhs[0]);
+
+   for (i = 0; i < numUtts && !failed; i++) {
+      mat = mxGetCell(mats, i);
+      if (mxGetCell(keys, i) == NULL || !mxIsChar(mxGetCell(keys, i))
+          || mat == NULL || mxIsComplex(mat)
+          || (!mxIsSingle(mat) && !mxIsDouble(mat))
+          || mxGetNumberOfDimensions(mat) != 2) {
+         failed = 1;
+         break;
+      }
+      /* A D*T Matlab matrix is a T*D row-major Kaldi matrix */
+      numCols = (int) mxGetM(mat);
+      numRows = (int) mxGetN(mat);
+      numValues = mxGetNumberOfElements(mat);
+      if (!mxIsSingle(mat)) {
+         if (numValues > numFloats) {
+            mxFree(floats);
+            floats = (float *) mxMalloc(numValues * sizeof(float));
+            numFloats = numValues;
+         }
+         values = mxGetPr(mat);
+         for (j = 0; j < numValues; j++)
+            floats[j] = (float) values[j];
+      }
+      if ((size_t) numRows > numWork) {
+         mxFree(work);
+         work = (float *) mxMalloc(numRows * sizeof(float));
+         numWork = numRows;
+      }
+      key = mxArrayToString(mxGetCell(keys, i));
+      offsets[i] = (double) arkWriteMatrix(&w, key, mxIsSingle(mat)
+                                           ? (const float *) mxGetData(mat)
+                                           : floats, numRows, numCols,
+                                           format, work);
+      if (offsets[i] < 0)
+         failed = 1;
+      else if (scp != NULL)
+         fprintf(scp, "%s %s:%.0f\n", key, arkFile, offsets[i]);
+      mxFree(key);
+   }
+   mxFree(floats);
+   mxFree(work);
+
+   /* Publish the ark, then its index */
+   if (arkClose(&w) != 0)
+      failed = 1;
+   if (scp != NULL && fclose(scp) != 0)
+      failed = 1;
+   if (!failed && rename(tempArk, arkFile) != 0)
+      failed = 1;
+   if (!failed && scp != NULL && rename(tempScp, scpFile) != 0)
+      failed = 1;
+   if (failed) {
+      remove(tempArk);
+      if (scp != NULL)
+         remove(tempScp);
+      mexErrMsgIdAndTxt("mexarkwrite:write",
+                        "Failed to write %s (utterance %d).", arkFile,
+                        (int) i + 1);
+   }
+   mxFree(tempArk);
+   mxFree(tempScp);
+   mxFree(arkFile);
+   mxFree(scpFile);
+}
+#endif
@@ -0,0 +1,77 @@
+% readKaldiMatrix: read a single Kaldi matrix file, e.g., the LDA
+% transform 'final.mat' written by 'est-lda' or 'copy-matrix'. Both the
+% binary ('FM'/'DM') and the text format are supported.
+%
+% Syntax: mat = readKaldiMatrix(fileName)
+%
+% Inputs:
+%   fileName: A string. Path to the Kaldi matrix file.
+%
+% Outputs:
+%   mat: A R*C double matrix, same layout as in Kaldi.
+%
+% Other m-files required: None
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function mat = readKaldiMatrix(fileName)
+    fid = fopen(fileName, 'r', 'ieee-le');
+    if fid == -1
+        error('Could not open Kaldi matrix file %s', fileName);
+    end
+    header = fread(fid, 2, '*uint8')';
+    if isequal(header, uint8([0, 'B']))
+        % Binary: "FM " or "DM ", then <4><int32 rows> <4><int32 cols>,
+        % then the data in row-major order
+        matType = char(fread(fid, 3, '*uint8')');
+        switch matType
+            case 'FM '
+                precision = 'float32';
+            case 'DM '
+                precision = 'float64';
+            otherwise
+                fclose(fid);
+                error('Unsupported Kaldi matrix type ''%s'' in %s',...
+                    strtrim(matType), fileName);
+        end
+        fread(fid, 1, 'uint8');
+        numRows = fread(fid, 1, 'int32');
+        fread(fid, 1, 'uint8');
+        numCols = fread(fid, 1, 'int32');
+        mat = fread(fid, [numCols, numRows], precision)';
+        fclose(fid);
+    else
+        % Text: "[ a b c \n d e f ]", one row per line
+        fclose(fid);
+        txt = fileread(fileName);
+        body = regexp(txt, '\[([^\]]*)\]', 'tokens', 'once');
+        assert(~isempty(body), 'Malformed Kaldi matrix file %s', fileName);
+        rows = regexp(strtrim(body{1}), '\s*\n\s*', 'split');
+        rows = rows(~cellfun(@isempty, rows));
+        numRows = length(rows);
+        vals = sscanf(body{1}, '%f');
+        mat = reshape(vals, [], numRows)';
+    end
+end
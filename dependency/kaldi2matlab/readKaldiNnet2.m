@@ -0,0 +1,230 @@
+% readKaldiNnet2: read a raw Kaldi nnet2 model, e.g., 'final.raw' written
+% by 'nnet-am-copy --raw=true', into a Matlab struct that can be run by
+% 'nnet2Forward'. Only the binary format is supported, which is the
+% default output format of Kaldi; a text model can be converted by
+% 'nnet-copy --binary=true final.txt final.raw'.
+%
+% Each component becomes a struct with a 'type' field (e.g.,
+% 'AffineComponentPreconditionedOnline') and one field per token written by
+% Kaldi (e.g., 'LinearParams', 'BiasParams'). Matrices and vectors are kept
+% in single precision, same as Kaldi. Fields that are only used in
+% training are read but ignored by the forward pass.
+%
+% Syntax: nnet = readKaldiNnet2(fileName)
+%
+% Inputs:
+%   fileName: A string. Path to the binary nnet2 raw model.
+%
+% Outputs:
+%   nnet: A struct,
+%       - components: a cell array of component structs
+%       - leftContext: number of past frames needed by the network
+%       - rightContext: number of future frames needed by the network
+%       - inputDim: input feature dimension
+%       - outputDim: output dimension
+%
+% Other m-files required: None
+%
+% Subfunctions: readToken, readComponent, readValue, getDim
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function nnet = readKaldiNnet2(fileName)
+    fid = fopen(fileName, 'r', 'ieee-le');
+    if fid == -1
+        error('Could not open nnet2 model %s', fileName);
+    end
+    buf = fread(fid, Inf, '*uint8')';
+    fclose(fid);
+    if length(buf) < 2 || ~isequal(buf(1:2), uint8([0, 'B']))
+        error(['%s is not a binary Kaldi model, convert it with ',...
+            '''nnet-copy --binary=true''.'], fileName);
+    end
+    pos = 3;
+
+    [token, pos] = readToken(buf, pos);
+    if strcmp(token, '<TransitionModel>')
+        error(['%s is an acoustic model, extract the raw nnet with ',...
+            '''nnet-am-copy --raw=true''.'], fileName);
+    end
+    assert(strcmp(token, '<Nnet>'), 'Expected <Nnet>, got %s', token);
+    [token, pos] = readToken(buf, pos);
+    assert(strcmp(token, '<NumComponents>'),...
+        'Expected <NumComponents>, got %s', token);
+    [numComponents, pos] = readValue(buf, pos, 'NumComponents');
+    [token, pos] = readToken(buf, pos);
+    assert(strcmp(token, '<Components>'),...
+        'Expected <Components>, got %s', token);
+    components = cell(numComponents, 1);
+    for cc = 1:numComponents
+        [components{cc}, pos] = readComponent(buf, pos);
+    end
+    [token, ~] = readToken(buf, pos);
+    assert(strcmp(token, '</Components>'),...
+        'Expected </Components>, got %s', token);
+
+    % Temporal context comes from the splicing components
+    leftContext = 0;
+    rightContext = 0;
+    for cc = 1:numComponents
+        comp = components{cc};
+        if any(strcmp(comp.type, {'SpliceComponent', 'SpliceMaxComponent'}))
+            if isfield(comp, 'Context')
+                context = double(comp.Context);
+            else
+                % Older models store the left and right context instead
+                context = -double(comp.LeftContext):double(comp.RightContext);
+            end
+            components{cc}.Context = context;
+            leftContext = leftContext - min(context);
+            rightContext = rightContext + max(context);
+        elseif strcmp(comp.type, 'SumGroupComponent')
+            % Precompute the group summation as a sparse matrix
+            sizes = double(comp.Sizes(:));
+            groupIdx = repelem((1:length(sizes))', sizes);
+            components{cc}.groupMatrix = sparse(groupIdx,...
+                (1:sum(sizes))', 1, length(sizes), sum(sizes));
+        end
+    end
+
+    nnet.components = components;
+    nnet.leftContext = leftContext;
+    nnet.rightContext = rightContext;
+    nnet.inputDim = getDim(components{1}, 'input');
+    nnet.outputDim = getDim(components{end}, 'output');
+end
+
+% Binary tokens are terminated by a single space
+function [token, pos] = readToken(buf, pos)
+    while pos <= length(buf) && isspace(char(buf(pos)))
+        pos = pos + 1;
+    end
+    endPos = pos;
+    while endPos <= length(buf) && buf(endPos) ~= uint8(' ')
+        endPos = endPos + 1;
+    end
+    token = char(buf(pos:(endPos-1)));
+    pos = endPos + 1;
+end
+
+% Read tokens and values until the closing tag of the component
+function [comp, pos] = readComponent(buf, pos)
+    [token, pos] = readToken(buf, pos);
+    assert(~isempty(regexp(token, '^<\w+>$', 'once')),...
+        'Expected a component, got %s', token);
+    comp.type = token(2:(end-1));
+    closeTag = sprintf('</%s>', comp.type);
+    while true
+        [token, pos] = readToken(buf, pos);
+        if strcmp(token, closeTag)
+            break;
+        end
+        assert(~isempty(regexp(token, '^<\w+>$', 'once')),...
+            'Could not parse %s near byte %d', comp.type, pos);
+        name = token(2:(end-1));
+        [comp.(name), pos] = readValue(buf, pos, name);
+    end
+end
+
+% Kaldi binary values are self-describing except for the int/float
+% ambiguity of 4-byte scalars, which is resolved by the token name
+function [value, pos] = readValue(buf, pos, name)
+    intVectorNames = {'Context', 'Sizes', 'Reorder'};
+    intNames = {'NumComponents', 'InputDim', 'OutputDim', 'Dim',...
+        'ConstComponentDim', 'LeftContext', 'RightContext', 'Rank',...
+        'RankIn', 'RankOut', 'UpdatePeriod'};
+    head = char(buf(pos:min(pos+2, length(buf))));
+    if head(1) == '<'
+        value = []; % a flag without a value
+    elseif length(head) == 3 && any(head(1) == 'FD') &&...
+            any(head(2) == 'MV') && head(3) == ' '
+        if head(1) == 'F'
+            numBytes = 4;
+            precision = 'single';
+        else
+            numBytes = 8;
+            precision = 'double';
+        end
+        pos = pos + 4; % type token and the size byte
+        numRows = double(typecast(buf(pos:(pos+3)), 'int32'));
+        pos = pos + 4;
+        if head(2) == 'M'
+            numCols = double(typecast(buf((pos+1):(pos+4)), 'int32'));
+            pos = pos + 5;
+        else
+            numCols = numRows;
+            numRows = 1;
+        end
+        numVals = numRows*numCols;
+        value = typecast(buf(pos:(pos+numVals*numBytes-1)), precision);
+        value = single(reshape(value, numCols, numRows)');
+        if head(2) == 'V'
+            value = value(:);
+        end
+        pos = pos + numVals*numBytes;
+    elseif head(1) == 'T' || head(1) == 'F'
+        value = head(1) == 'T';
+        pos = pos + 1;
+    else
+        numBytes = double(buf(pos));
+        if ismember(name, intVectorNames)
+            numVals = double(typecast(buf((pos+1):(pos+4)), 'int32'));
+            pos = pos + 5;
+            value = typecast(buf(pos:(pos+numVals*numBytes-1)), 'int32');
+            pos = pos + numVals*numBytes;
+        elseif numBytes == 4
+            if ismember(name, intNames)
+                value = typecast(buf((pos+1):(pos+4)), 'int32');
+            else
+                value = typecast(buf((pos+1):(pos+4)), 'single');
+            end
+            pos = pos + 5;
+        elseif numBytes == 8
+            value = typecast(buf((pos+1):(pos+8)), 'double');
+            pos = pos + 9;
+        else
+            error('Unexpected value of <%s> near byte %d', name, pos);
+        end
+        value = double(value);
+    end
+end
+
+% Input or output dimension of a component, used for sanity checks
+function dim = getDim(comp, side)
+    dim = [];
+    if isfield(comp, 'LinearParams')
+        if strcmp(side, 'input')
+            dim = size(comp.LinearParams, 2);
+        else
+            dim = size(comp.LinearParams, 1);
+        end
+    elseif isfield(comp, 'InputDim') && strcmp(side, 'input')
+        dim = comp.InputDim;
+    elseif isfield(comp, 'OutputDim') && strcmp(side, 'output')
+        dim = comp.OutputDim;
+    elseif isfield(comp, 'Dim')
+        dim = comp.Dim;
+    elseif isfield(comp, 'Sizes') && strcmp(side, 'output')
+        dim = length(comp.Sizes);
+    end
+end
@@ -0,0 +1,235 @@
+/* ----------------------------------------------------------------- */
+/*             The Speech Signal Processing Toolkit (SPTK)           */
+/*             developed by SPTK Working Group                       */
+/*             http://sp-tk.sourceforge.net/                         */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 1984-2007  Tokyo Institute of Technology           */
+/*                           Interdisciplinary Graduate School of    */
+/*                           Science and Engineering                 */
+/*                                                                   */
+/*                1996-2016  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the SPTK working group nor the names of its */
+/*   contributors may be used to endorse or promote products derived */
+/*   from this software without specific prior written permission.   */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+/* ----------------------------------------------------------------- */
+
+
+/******************************************************************
+ * Fixed-shape instances of the SPTK kernels. Every production call runs
+ * the same shapes: 513 spectrum bins (FFT length 1024), 24th order
+ * mel-cepstra, so the orders are compile-time constants here, the
+ * workspaces and the delay lines are fixed-size arrays on the stack, and
+ * the loops have constant trip counts that the compiler can unroll.
+ * Each macro defines one static function, e.g.,
+ *   FIXED_FREQT(freqt512to24, 512, 24)
+ * defines 'static void freqt512to24(const double *c1, double *c2,
+ * const double a)', which is 'freqt(c1, 512, c2, 24, a)'. The arithmetic
+ * is done in the same order as the generic kernels, so the results are
+ * the same bit for bit. The caller dispatches on the shape and falls back
+ * to the generic kernel for any other one.
+ *
+ *   FIXED_FREQT(NAME, M1, M2): freqt, 'NAME(c1, c2, a)'
+ *   FIXED_FRQTR(NAME, M1, M2): frqtr, 'NAME(c1, c2, a)'
+ *   FIXED_THEQ(NAME, N): theq, 'NAME(t, h, a, b, eps)', needs the 2x2
+ *   helpers mv_mul, mm_mul, inverse, and crstrns of theq.c
+ *
+ * fftr is left generic, a fixed length version was not faster.
+ *
+ * Guanlong Zhao (gzhao@tamu.edu)
+ * Created: 10/18/2026
+ * Last Modified: 10/18/2026
+ * Revision log:
+ *  10/18/2026: function creation, GZ
+ *  10/18/2026: drop FIXED_FFTR, it was not faster than fftr, GZ
+ *  10/18/2026: correct the note on the delay lines, GZ
+****************************************************************/
+
+#ifndef FIXED_KERNELS_H
+#define FIXED_KERNELS_H
+
+#define FIXED_FREQT(NAME, M1, M2) \
+static void NAME(const double *c1, double *c2, const double a) \
+{ \
+   double g[(M2) + 1]; \
+   double t, u; \
+   const double b = 1 - a * a; \
+   int i, j; \
+ \
+   for (j = 0; j <= (M2); j++) \
+      g[j] = 0.0; \
+ \
+   for (i = -(M1); i <= 0; i++) { \
+      t = g[0]; \
+      g[0] = c1[-i] + a * t; \
+      u = g[1]; \
+      g[1] = b * t + a * u; \
+      t = u; \
+      for (j = 2; j <= (M2); j++) { \
+         u = g[j]; \
+         g[j] = t + a * (u - g[j - 1]); \
+         t = u; \
+      } \
+   } \
+ \
+   for (j = 0; j <= (M2); j++) \
+      c2[j] = g[j]; \
+}
+
+#define FIXED_FRQTR(NAME, M1, M2) \
+static void NAME(const double *c1, double *c2, const double a) \
+{ \
+   double g[(M2) + 1]; \
+   double t, u; \
+   int i, j; \
+ \
+   for (j = 0; j <= (M2); j++) \
+      g[j] = 0.0; \
+ \
+   for (i = -(M1); i <= 0; i++) { \
+      t = g[0]; \
+      g[0] = c1[-i]; \
+      for (j = 1; j <= (M2); j++) { \
+         u = g[j]; \
+         g[j] = t + a * (u - g[j - 1]); \
+         t = u; \
+      } \
+   } \
+ \
+   for (j = 0; j <= (M2); j++) \
+      c2[j] = g[j]; \
+}
+
+#define FIXED_THEQ(NAME, N) \
+static int NAME(const double *t, const double *h, double *a, \
+                const double *b, double eps) \
+{ \
+   double r[N][4], x[N][4], xx[N][4], p[N][2]; \
+   double ex[4], ep[2], vx[4], bx[4], g[2], s[4], u[4], w[4], v[2]; \
+   int i, j; \
+ \
+   if (eps < 0.0) \
+      eps = 1.0e-6; \
+ \
+   /* make r */ \
+   for (i = 0; i < (N); i++) { \
+      r[i][0] = r[i][3] = t[i]; \
+      r[i][1] = h[(N) - 1 + i]; \
+      r[i][2] = h[(N) - 1 - i]; \
+   } \
+ \
+   /* step 1 */ \
+   x[0][0] = x[0][3] = 1.0; \
+   x[0][1] = x[0][2] = 0.0; \
+   if (inverse(w, r[0], eps) == -1) \
+      return (-1); \
+   v[0] = b[0]; \
+   v[1] = b[(N) - 1]; \
+   mv_mul(p[0], w, v); \
+   vx[0] = r[0][0]; \
+   vx[1] = r[0][1]; \
+   vx[2] = r[0][2]; \
+   vx[3] = r[0][3]; \
+ \
+   /* step 2 */ \
+   for (i = 1; i < (N); i++) { \
+      /* ex, ep */ \
+      ex[0] = ex[1] = ex[2] = ex[3] = 0.; \
+      for (j = 0; j < i; j++) { \
+         mm_mul(w, r[i - j], x[j]); \
+         ex[0] += w[0]; \
+         ex[1] += w[1]; \
+         ex[2] += w[2]; \
+         ex[3] += w[3]; \
+      } \
+      ep[0] = ep[1] = 0.; \
+      for (j = 0; j < i; j++) { \
+         mv_mul(v, r[i - j], p[j]); \
+         ep[0] += v[0]; \
+         ep[1] += v[1]; \
+      } \
+      /* bx */ \
+      crstrns(w, vx); \
+      if (inverse(s, w, eps) == -1) \
+         return (-1); \
+      mm_mul(bx, s, ex); \
+      /* x */ \
+      for (j = 1; j < i; j++) { \
+         crstrns(w, xx[i - j]); \
+         mm_mul(s, w, bx); \
+         x[j][0] -= s[0]; \
+         x[j][1] -= s[1]; \
+         x[j][2] -= s[2]; \
+         x[j][3] -= s[3]; \
+      } \
+      for (j = 1; j < i; j++) { \
+         xx[j][0] = x[j][0]; \
+         xx[j][1] = x[j][1]; \
+         xx[j][2] = x[j][2]; \
+         xx[j][3] = x[j][3]; \
+      } \
+      x[i][0] = xx[i][0] = -bx[0]; \
+      x[i][1] = xx[i][1] = -bx[1]; \
+      x[i][2] = xx[i][2] = -bx[2]; \
+      x[i][3] = xx[i][3] = -bx[3]; \
+      /* vx */ \
+      crstrns(w, ex); \
+      mm_mul(s, w, bx); \
+      vx[0] -= s[0]; \
+      vx[1] -= s[1]; \
+      vx[2] -= s[2]; \
+      vx[3] -= s[3]; \
+      /* g */ \
+      v[0] = b[i] - ep[0]; \
+      v[1] = b[(N) - 1 - i] - ep[1]; \
+      crstrns(s, vx); \
+      if (inverse(u, s, eps) == -1) \
+         return (-1); \
+      mv_mul(g, u, v); \
+      /* p */ \
+      for (j = 0; j < i; j++) { \
+         crstrns(w, x[i - j]); \
+         mv_mul(v, w, g); \
+         p[j][0] += v[0]; \
+         p[j][1] += v[1]; \
+      } \
+      p[i][0] = g[0]; \
+      p[i][1] = g[1]; \
+   } \
+ \
+   /* step 3 */ \
+   for (i = 0; i < (N); i++) \
+      a[i] = p[i][0]; \
+ \
+   return (0); \
+}
+
+#endif                          /* FIXED_KERNELS_H */
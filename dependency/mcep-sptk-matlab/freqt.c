@@ -68,14 +68,22 @@
  * so use it at your own risk.
  * Guanlong Zhao (gzhao@tamu.edu)
  * Created: 06/09/2017
- * Last Modified: 06/09/2017
+ * Last Modified: 10/18/2026
  * Revision log:
  *  06/09/2017: function creation, GZ
+ *  10/18/2026: only build the gateway function under MATLAB_MEX_FILE, so
+ *  that the kernel can be built without Matlab for benchmarking, GZ
+ *  10/18/2026: dispatch the production shapes to the fixed-shape
+ *  kernels, GZ
+ *  10/18/2026: the order of the input is the number of rows minus one, GZ
 ****************************************************************/
 
 #include <stdio.h>
 #include <stdlib.h>
+#ifdef MATLAB_MEX_FILE
 #include "mex.h"
+#endif
+#include "fixedKernels.h"
 
 char *getmem(const size_t leng, const size_t size)
 {
@@ -158,7 +166,24 @@ void freqt(double *c1, const int m1, double *c2, const int m2, const double a)
    return;
 }
 
+/* spec2mcep.m: cepstrum (513) -> mel-cepstrum (order 24), and back */
+FIXED_FREQT(freqt512to24, 512, 24)
+FIXED_FREQT(freqt24to512, 24, 512)
 
+/* freqt, with the fixed-shape kernel if there is one */
+void freqtDispatch(double *c1, const int m1, double *c2, const int m2,
+                   const double a)
+{
+   if (m1 == 512 && m2 == 24)
+      freqt512to24(c1, c2, a);
+   else if (m1 == 24 && m2 == 512)
+      freqt24to512(c1, c2, a);
+   else
+      freqt(c1, m1, c2, m2, a);
+}
+
+
+#ifdef MATLAB_MEX_FILE
 /* The gateway function */
 void mexFunction(int nlhs, mxArray *plhs[],
                  int nrhs, const mxArray *prhs[])
@@ -196,5 +221,6 @@ void mexFunction(int nlhs, mxArray *plhs[],
 	plhs[0] = mxCreateDoubleMatrix((m2+1), 1, mxREAL);
 	c2 = mxGetPr(plhs[0]);
     
-    freqt(c1, nrow, c2, m2, a);
+    freqtDispatch(c1, nrow - 1, c2, m2, a);
 }
+#endif
@@ -66,15 +66,23 @@
  * so use it at your own risk.
  * Guanlong Zhao (gzhao@tamu.edu)
  * Created: 06/09/2017
- * Last Modified: 06/09/2017
+ * Last Modified: 10/18/2026
  * Revision log:
  *  06/09/2017: function creation, GZ
+ *  10/18/2026: only build the gateway function under MATLAB_MEX_FILE, so
+ *  that the kernel can be built without Matlab for benchmarking, GZ
+ *  10/18/2026: dispatch the production shape to the fixed-shape kernel,
+ *  GZ
+ *  10/18/2026: the order of the input is the number of rows minus one, GZ
 ****************************************************************/
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#ifdef MATLAB_MEX_FILE
 #include "mex.h"
+#endif
+#include "fixedKernels.h"
 
 char *getmem(const size_t leng, const size_t size)
 {
@@ -156,7 +164,20 @@ void frqtr(double *c1, int m1, double *c2, int m2, const double a)
    return;
 }
 
+/* spec2mcep.m: IFFT (1024) -> r(k) (order 48) */
+FIXED_FRQTR(frqtr1023to48, 1023, 48)
 
+/* frqtr, with the fixed-shape kernel if there is one */
+void frqtrDispatch(double *c1, int m1, double *c2, int m2, const double a)
+{
+   if (m1 == 1023 && m2 == 48)
+      frqtr1023to48(c1, c2, a);
+   else
+      frqtr(c1, m1, c2, m2, a);
+}
+
+
+#ifdef MATLAB_MEX_FILE
 /* The gateway function */
 void mexFunction(int nlhs, mxArray *plhs[],
                  int nrhs, const mxArray *prhs[])
@@ -194,5 +215,6 @@ void mexFunction(int nlhs, mxArray *plhs[],
 	plhs[0] = mxCreateDoubleMatrix((m2+1), 1, mxREAL);
 	c2 = mxGetPr(plhs[0]);
     
-    frqtr(c1, nrow, c2, m2, a);
+    frqtrDispatch(c1, nrow - 1, c2, m2, a);
 }
+#endif
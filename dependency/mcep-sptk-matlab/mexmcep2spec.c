@@ -63,16 +63,26 @@
  * so use it at your own risk.
  * Guanlong Zhao (gzhao@tamu.edu)
  * Created: 06/09/2017
- * Last Modified: 06/09/2017
+ * Last Modified: 10/18/2026
  * Revision log:
  *  06/09/2017: function creation, GZ
+ *  10/18/2026: only build the gateway function under MATLAB_MEX_FILE, so
+ *  that the kernel can be built without Matlab for benchmarking, GZ
+ *  10/18/2026: use the fixed-shape kernels for 24th order mel-cepstra
+ *  with a 1024 point FFT, GZ
+ *  10/18/2026: free the work buffer, do not write past the spectrum, GZ
+ *  10/18/2026: drop the unused work buffer argument of mexmcep2spec, GZ
+ *  10/18/2026: use the generic fftr in the fixed-shape path, GZ
 ****************************************************************/
 
 /*  Standard C Libraries  */
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#ifdef MATLAB_MEX_FILE
 #include "mex.h"
+#endif
+#include "fixedKernels.h"
 
 #ifndef PI
 #define PI  3.14159265358979323846
@@ -498,24 +508,57 @@ void mgc2sp(double *mgc, const int m, const double a, const double g, double *x,
    return;
 }
 
-int mexmcep2spec(double *c, const int m, const double alpha, const double gamma, double *x, 
-				double *y, const int l)
+FIXED_FREQT(mgc2spFreqt24to512, 24, 512)
+
+/* mgc2sp for 24th order mel-cepstra and a 1024 point FFT. With gamma = 0
+   and a target all-pass constant of 0, mgc2mgc is freqt with -alpha, and
+   gnorm, gc2gc, and ignorm leave the cepstrum as it is (up to the rounding
+   of exp and log on c[0]), so they are skipped. */
+static void mcep2spec24to1024(double *c, const double alpha, double *x)
+{
+	double xp[1024], y[1024];
+	int i;
+
+	mgc2spFreqt24to512(c, xp, -alpha);
+	for (i = 513; i < 1024; i++)
+		xp[i] = 0.0;
+	fftr(xp, y, 1024);
+
+	for (i = 0; i < 513; i++)
+		x[i] = exp(2 * xp[i]);
+}
+
+static void mcep2specGeneric(double *c, const int m, const double alpha,
+				const double gamma, double *x, const int l)
 {
 	int no, i;
+	double *xp, *y;
 
-	double *xp = dgetmem(l + l);
+	xp = dgetmem(l + l);
 	y = xp + l;
 
 	no = l / 2 + 1;
 
 	mgc2sp(c, m, alpha, gamma, xp, y, l);
 
-	for (i = no; i>=0; i--)
+	for (i = no - 1; i >= 0; i--)
 		x[i] = exp(2 * xp[i]);
 
+	free(xp);
+}
+
+int mexmcep2spec(double *c, const int m, const double alpha, const double gamma, double *x, 
+				const int l)
+{
+	if (m == 24 && l == 1024 && gamma == 0.0)
+		mcep2spec24to1024(c, alpha, x);
+	else
+		mcep2specGeneric(c, m, alpha, gamma, x, l);
+
 	return (0);
 }
 
+#ifdef MATLAB_MEX_FILE
 /* The gateway function */
 void mexFunction(int nlhs, mxArray *plhs[],
                  int nrhs, const mxArray *prhs[])
@@ -554,7 +597,7 @@ void mexFunction(int nlhs, mxArray *plhs[],
 	/* get outputs */
 	plhs[0] = mxCreateDoubleMatrix(nfeq, 1, mxREAL);
 	x = mxGetPr(plhs[0]);
-	double *y = NULL;
 
-	mexmcep2spec(c, m, alpha, gamma, x, y, l);
+	mexmcep2spec(c, m, alpha, gamma, x, l);
 }
+#endif
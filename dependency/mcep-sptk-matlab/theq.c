@@ -75,15 +75,22 @@
  * so use it at your own risk.
  * Guanlong Zhao (gzhao@tamu.edu)
  * Created: 06/09/2017
- * Last Modified: 06/09/2017
+ * Last Modified: 10/18/2026
  * Revision log:
  *  06/09/2017: function creation, GZ
+ *  10/18/2026: only build the gateway function under MATLAB_MEX_FILE, so
+ *  that the kernel can be built without Matlab for benchmarking, GZ
+ *  10/18/2026: dispatch the production order to the fixed-shape kernel,
+ *  GZ
 ****************************************************************/
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#ifdef MATLAB_MEX_FILE
 #include "mex.h"
+#endif
+#include "fixedKernels.h"
 
 static void mv_mul(double *t, double *x, double *y)
 {
@@ -372,6 +379,19 @@ int theq(double *t, double *h, double *a, double *b, const int n, double eps)
    return (0);
 }
 
+/* spec2mcep.m: 24th order mel-cepstra */
+FIXED_THEQ(theq25, 25)
+
+/* theq, with the fixed-shape kernel if there is one */
+int theqDispatch(double *t, double *h, double *a, double *b, const int n,
+                 double eps)
+{
+   if (n == 25)
+      return (theq25(t, h, a, b, eps));
+   return (theq(t, h, a, b, n, eps));
+}
+
+#ifdef MATLAB_MEX_FILE
 /* The gateway function */
 void mexFunction(int nlhs, mxArray *plhs[],
                  int nrhs, const mxArray *prhs[])
@@ -413,5 +433,6 @@ void mexFunction(int nlhs, mxArray *plhs[],
 	plhs[0] = mxCreateDoubleMatrix(nrow, 1, mxREAL);
 	a = mxGetPr(plhs[0]);
     
-    theq(t, h, a, b, n, eps);
+    theqDispatch(t, h, a, b, n, eps);
 }
+#endif
@@ -2,10 +2,14 @@
 % implementation.
 %
 % Syntax: D = KLDiv5(x, y)
+%         D = KLDiv5(x, y, logy, ylogy)
 %
 % Inputs:
 %   x: d*m matrix, each column is a sample
 %   y: d*n matrix, each column is a sample
+%   logy: (optional) d*n matrix, log(y+eps), precomputed, e.g., by
+%   'pairingIndex'
+%   ylogy: (optional) 1*n vector, dot(y, logy, 1), precomputed
 %
 % Output:
 %   D: m*n matrix, D(i, j) = KL(x(:, i), y(:, j))
@@ -18,10 +22,11 @@
 %
 % Author: Guanlong Zhao
 % Email: gzhao@tamu.edu
-% Created: 2017; Last revision: 04/23/2019
+% Created: 2017; Last revision: 10/18/2026
 % Revision log:
 %   2017: function creation, Guanlong Zhao
 %   04/23/2019: fix docs, GZ
+%   10/18/2026: accept the precomputed target terms, GZ
 
 % Copyright 2017 Guanlong Zhao
 % 
@@ -37,9 +42,14 @@
 % See the License for the specific language governing permissions and
 % limitations under the License.
 
-function D = KLDiv5(x, y)
+function D = KLDiv5(x, y, logy, ylogy)
     logx = log(x+eps);
-    logy = log(y+eps);
+    if nargin < 3
+        logy = log(y+eps);
+    end
+    if nargin < 4
+        ylogy = dot(y,logy,1);
+    end
     
-    D = bsxfun(@plus,dot(y,logy,1),dot(x,logx,1)')-x'*logy-logx'*y;
+    D = bsxfun(@plus,ylogy,dot(x,logx,1)')-x'*logy-logx'*y;
 end
\ No newline at end of file
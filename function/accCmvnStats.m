@@ -0,0 +1,51 @@
+% accCmvnStats: accumulate CMVN statistics of a feature matrix, in the same
+% layout as Kaldi's 'compute-cmvn-stats', so that the stats of several
+% utterances (e.g., all the utterances of a speaker) can be summed up.
+%
+% Syntax: stats = accCmvnStats(feats)
+%         stats = accCmvnStats(feats, stats)
+%
+% Inputs:
+%   feats: A D*T matrix.
+%   stats: A 2*(D+1) matrix. Stats to add to. Default to zeros.
+%
+% Outputs:
+%   stats: A 2*(D+1) matrix. The first row holds the sum of the features
+%   and the frame count, the second row holds the sum of squares.
+%
+% Other m-files required: None
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function stats = accCmvnStats(feats, stats)
+    feats = double(feats);
+    dim = size(feats, 1);
+    if nargin < 2 || isempty(stats)
+        stats = zeros(2, dim+1);
+    end
+    stats(1, 1:dim) = stats(1, 1:dim) + sum(feats, 2)';
+    stats(1, end) = stats(1, end) + size(feats, 2);
+    stats(2, 1:dim) = stats(2, 1:dim) + sum(feats.^2, 2)';
+end
@@ -0,0 +1,94 @@
+% buildGMMmodelBatchGSB: build the GMM models of many source speakers
+% against one target speaker, e.g., every non-native speaker of a corpus
+% against the same native speaker. The target side is prepared once, as a
+% pairing index (see 'pairingIndex'), which is built if it does not exist
+% or is stale, and is then shared by all the models. The index is kept, so
+% later runs with new source speakers reuse it too.
+%
+% Syntax: [modelPaths, status] = buildGMMmodelBatchGSB(srcSpkrFileSets, tgtSpkrFiles, indexDir, modelPaths)
+%
+% Inputs:
+%   srcSpkrFileSets: A cell array. Each element is a cell array of paths
+%   to the mat files of one source speaker.
+%   tgtSpkrFiles: A cell array. Each element is a path to a mat file from
+%   the target speaker. Can be {} to use the index in 'indexDir' as it is.
+%   indexDir: A string. Dir of the pairing index of the target speaker.
+%   modelPaths: A cell array. Path of the model of each source speaker.
+%
+%   [Optional name-value pairs]
+%   'InMemory': true | false (*), keep the target PPGs of the index in
+%   memory for the whole batch, instead of reading them from disk for each
+%   model
+%   'NumWorkers': number of parallel workers that read the mat files,
+%   default to 0, read them in serial
+%   Everything else is passed to 'buildGMMmodelGSB'.
+%
+% Outputs:
+%   modelPaths: A cell array. Path to each trained model, '' if it failed.
+%   status: A vector. Status flag of each model, '1' for success and '0'
+%   for failure.
+%
+% Other m-files required: pairingIndex, buildGMMmodelGSB
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function [modelPaths, status] = buildGMMmodelBatchGSB(srcSpkrFileSets, tgtSpkrFiles, indexDir, modelPaths, varargin)
+    p = inputParser;
+    p.KeepUnmatched = true;
+    addRequired(p, 'srcSpkrFileSets', @(x) iscell(x) &&...
+        all(cellfun(@iscellstr, x)));
+    addRequired(p, 'tgtSpkrFiles', @iscellstr);
+    addRequired(p, 'indexDir', @ischar);
+    addRequired(p, 'modelPaths', @iscellstr);
+    addParameter(p, 'InMemory', false, @islogical);
+    addParameter(p, 'NumWorkers', 0, @(x) isnumeric(x) && x>=0);
+    parse(p, srcSpkrFileSets, tgtSpkrFiles, indexDir, modelPaths,...
+        varargin{:});
+    isInMemory = p.Results.InMemory;
+    numWorkers = p.Results.NumWorkers;
+    buildArgs = [fieldnames(p.Unmatched), struct2cell(p.Unmatched)]';
+    buildArgs = [buildArgs(:)', {'NumWorkers', numWorkers}];
+    numModels = length(srcSpkrFileSets);
+    assert(length(modelPaths) == numModels,...
+        'Need one model path per source speaker.');
+
+    % Prepare the target side once
+    if ~isempty(tgtSpkrFiles) &&...
+            ~pairingIndex('isValid', indexDir, tgtSpkrFiles)
+        fprintf('Building the pairing index of the target speaker...\n')
+        pairingIndex('build', tgtSpkrFiles, indexDir, 'NumWorkers',...
+            numWorkers);
+        fprintf('Building the pairing index finished.\n')
+    end
+    tgtIndex = pairingIndex('load', indexDir, 'InMemory', isInMemory);
+
+    status = zeros(numModels, 1);
+    for ii = 1:numModels
+        fprintf('Building model %d of %d...\n', ii, numModels);
+        [modelPaths{ii}, status(ii)] = buildGMMmodelGSB(...
+            srcSpkrFileSets{ii}, {}, modelPaths{ii}, 'TargetIndex',...
+            tgtIndex, buildArgs{:});
+    end
+end
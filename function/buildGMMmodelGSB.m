@@ -6,7 +6,7 @@
 %   srcSpkrFiles: A cell array. Each element is a path to a mat file from
 %   the source speaker.
 %   tgtSpkrFiles: A cell array. Each element is a path to a mat file from
-%   the target speaker.
+%   the target speaker. Can be {} if 'TargetIndex' is set.
 %   modelPath: A string. Path to where you want to save the model, will
 %   overwrite the existing file.
 %
@@ -20,9 +20,46 @@
 %   than MIN_COVAR which has the value eps). With '0' no action is taken.
 %   'Epsilon': early stopping criteria, default is 1e-4
 %   'Verbose': 1 (*) | 0, set to '1' to get some printouts
-%   'SplitSize': number of frames in a batch, default to 3000 frames. if
-%   the input is less than 3000 frames then run in a single batch. This is
-%   used in the frame-pairing part to avoid out-of-memory issues.
+%   'SplitSize': number of frames in a batch, or 'auto' (*), which picks
+%   the largest batch that fits 'PairingMemory'. If the input is less than
+%   the batch size then run in a single batch. This is used in the
+%   frame-pairing part to avoid out-of-memory issues.
+%   'PairingMemory': memory budget of the frame pairing in bytes, default
+%   to [], half of the available memory, see 'framePairingPPG'
+%   'PhoneBuckets': 'off' (*) | 'exact' | 'broad', limit the frame pairing
+%   to frames of the same phone ('exact'), or of the same broad phonetic
+%   class ('broad'), using the phone labels of the utts. Much faster, but
+%   a few pairs can differ from the exhaustive search, see
+%   'reportPhonePairing'
+%   'PostStore': A string. A dir for file-backed PPG stores, which the
+%   frame pairing reads tile by tile, so that the PPGs of both speakers do
+%   not have to fit in memory. The files are deleted after the pairing.
+%   Default to '', keep the PPGs in memory
+%   'TargetIndex': A string or a struct. A pairing index of the target
+%   speaker from 'pairingIndex', or its dir. The target data are then
+%   taken from the index instead of being loaded and prepared again, and
+%   'tgtSpkrFiles', if given, must be the files of the index. Default to
+%   '', use 'tgtSpkrFiles'
+%   'NumWorkers': number of parallel workers that read the mat files,
+%   default to 0, read them in serial
+%   'EMWorkers': number of worker processes for the EM, default to 0, train
+%   in this Matlab process. Otherwise the E-step is spread over the
+%   workers, see 'gmmemDistributed'
+%   'EMPort': port of the distributed EM, default to 0, any free port, and
+%   the workers are started as local Matlab processes. If set, wait for
+%   'EMWorkers' workers started by hand with 'gmmWorker', which can be on
+%   other machines
+%   'EMPrecision': 'netlab' (*) | 'double' | 'single', the E-step of the
+%   EM. 'netlab' uses 'gmmem' as is; 'double' and 'single' use the
+%   log-domain E-step of 'gmmEStep', which does not produce NaNs when a
+%   frame is far from every Gaussian, with the log-densities in double or
+%   in single precision, see 'reportEStepParity'. The distributed EM uses
+%   'double' for 'netlab'
+%   'NumStarts': number of initializations trained at once, default to 1.
+%   With more, the best of them is kept, and the worse ones are stopped
+%   early, see 'gmmemMultiStart'. Not with 'EMWorkers'
+%   'StartWorkers': number of parallel workers that train the starts,
+%   default to [], one per start up to the size of the local cluster
 %   'MaxRetry': sometimes the GMM training will diverge, and this may
 %   happen for various reasons, e.g., the source and target speakers have
 %   drastically different amount of data; the model is too complex for the
@@ -30,26 +67,59 @@
 %   option allows the function to check after the training, if the model
 %   diverges, then it will retry with a new initialization. The default
 %   maximum retry count is '3'
+%   'CheckpointDir': A string. If set, the frame pairing maps, the
+%   training features and global variances, and the GMM every
+%   'CheckpointEvery' EM iterations are saved in this dir, and a run with
+%   the same inputs and options resumes from the latest ones, e.g., after
+%   a crash. A checkpoint is used only if its content matches the digest
+%   recorded after it was written, so a half-written one is never loaded.
+%   The EM of 'NumStarts' > 1 is not checkpointed. The dir is kept, remove
+%   it once the model is saved. Default to '', no checkpoints
+%   'CheckpointEvery': number of EM iterations between checkpoints,
+%   default to 5
+%   'TracePath': A string. Path to a Chrome trace JSON file. If set, the
+%   function records the time, frames, and peak memory of each stage (load,
+%   prepare, pair, GV, EM iterations, or the whole EM with 'netlab', save),
+%   saves the trace, and prints a summary table. Default to '', no trace
+%   unless one is already started by the caller, see 'traceSpan'
 %
 % Outputs:
 %   modelPath: path to the trained model
 %   status: status flag. '1' for success and '0' for failure.
 %
 % Other m-files required: tryCreateDir, loadUttGSB, prepareDataGMM,
-% framePairingPPG, calculateGlobalVar, trySaveStructFields, netlab files
+% framePairingPPG, calculateGlobalVar, trySaveStructFields, traceSpan,
+% writeTrace, gmmemDistributed, gmmemLogDomain, gmmemMultiStart,
+% pairingIndex, readFrames, hashContent, isStageCached, markStageCached,
+% fileSignature, netlab files
 %
-% Subfunctions: None
+% Subfunctions: trainEM, isCheckpointValid, markCheckpoint
 %
 % MAT-file required: None
 %
 % Author: Guanlong Zhao
 % Email: gzhao@tamu.edu
-% Created: 10/19/2018; Last revision: 04/23/2019
+% Created: 10/19/2018; Last revision: 10/18/2026
 % Revision log:
 %   10/19/2018: function creation, Guanlong Zhao
 %   10/23/2018: change to let the user specify the output path, GZ
 %   10/24/2018: fixed a bug and add validation for input type, GZ
 %   04/23/2019: fix docs, GZ
+%   10/18/2026: add stage-level tracing, GZ
+%   10/18/2026: size the frame pairing batches to a memory budget, GZ
+%   10/18/2026: build the training set without copies, add 'PostStore', GZ
+%   10/18/2026: load only the needed fields, in parallel, GZ
+%   10/18/2026: add the distributed EM, GZ
+%   10/18/2026: add the log-domain E-step, 'EMPrecision', GZ
+%   10/18/2026: add the phone-bucketed frame pairing, GZ
+%   10/18/2026: add 'TargetIndex', GZ
+%   10/18/2026: add the multi-start training, 'NumStarts', GZ
+%   10/18/2026: add the resumable checkpoints, 'CheckpointDir', GZ
+%   10/18/2026: trace netlab's EM as one span, GZ
+%   10/18/2026: test the EM convergence across checkpoints, GZ
+%   10/18/2026: write and read the feature checkpoint in blocks, GZ
+%   10/18/2026: keep alternating the EM checkpoint slots after a resume, GZ
+%   10/18/2026: use the shared fileSignature, GZ
 
 % Copyright 2018 Guanlong Zhao
 % 
@@ -77,8 +147,25 @@ function [modelPath, status] = buildGMMmodelGSB(srcSpkrFiles, tgtSpkrFiles, mode
     addParameter(p, 'CheckCov', 1, @isnumeric);
     addParameter(p, 'Epsilon', 1e-4, @isnumeric);
     addParameter(p, 'Verbose', 1, @isnumeric);
-    addParameter(p, 'SplitSize', 3e3, @isnumeric);
+    addParameter(p, 'SplitSize', 'auto',...
+        @(x) isnumeric(x) || strcmp(x, 'auto'));
+    addParameter(p, 'PairingMemory', [], @isnumeric);
+    addParameter(p, 'PhoneBuckets', 'off', @(x) ismember(x,...
+        {'off', 'exact', 'broad'}));
+    addParameter(p, 'PostStore', '', @ischar);
+    addParameter(p, 'TargetIndex', '', @(x) ischar(x) || isstruct(x));
+    addParameter(p, 'NumWorkers', 0, @(x) isnumeric(x) && x>=0);
+    addParameter(p, 'EMWorkers', 0, @(x) isnumeric(x) && x>=0);
+    addParameter(p, 'EMPort', 0, @isnumeric);
+    addParameter(p, 'EMPrecision', 'netlab', @(x) ismember(x,...
+        {'netlab', 'double', 'single'}));
+    addParameter(p, 'NumStarts', 1, @(x) isnumeric(x) && x>=1);
+    addParameter(p, 'StartWorkers', [],...
+        @(x) isempty(x) || (isnumeric(x) && x>=0));
     addParameter(p, 'MaxRetry', 3, @isnumeric);
+    addParameter(p, 'CheckpointDir', '', @ischar);
+    addParameter(p, 'CheckpointEvery', 5, @(x) isnumeric(x) && x>=1);
+    addParameter(p, 'TracePath', '', @ischar);
     parse(p, srcSpkrFiles, tgtSpkrFiles, modelPath, varargin{:});
     nMix = p.Results.NumMixtures; % # of Gaussian mixtures
     covType = p.Results.CovType; % Cov type for the GMMs
@@ -92,39 +179,286 @@ function [modelPath, status] = buildGMMmodelGSB(srcSpkrFiles, tgtSpkrFiles, mode
     gmmOptions(5) = isCheckCov;
     gmmOptions(14) = nIter;
     splitSize = p.Results.SplitSize; % See docstring
+    pairingMemory = p.Results.PairingMemory; % See docstring
+    phoneBuckets = p.Results.PhoneBuckets; % See docstring
+    postStore = p.Results.PostStore; % See docstring
+    tgtIndex = p.Results.TargetIndex; % See docstring
+    numWorkers = p.Results.NumWorkers; % See docstring
+    emWorkers = p.Results.EMWorkers; % See docstring
+    emPort = p.Results.EMPort; % See docstring
+    emPrecision = p.Results.EMPrecision; % See docstring
+    numStarts = p.Results.NumStarts; % See docstring
+    startWorkers = p.Results.StartWorkers; % See docstring
+    assert(numStarts == 1 || emWorkers == 0,...
+        'Multiple starts cannot be trained with the distributed EM.');
     maxRetry = p.Results.MaxRetry; % See docstring
+    checkpointDir = p.Results.CheckpointDir; % See docstring
+    checkpointEvery = p.Results.CheckpointEvery; % See docstring
+    blockFrames = 65536; % frames per block of the feature checkpoint
+    tracePath = p.Results.TracePath; % See docstring
     status = 0;
+    isTraceOwner = ~isempty(tracePath) && ~traceSpan('isOn');
+    if isTraceOwner
+        traceSpan('start');
+        traceGuard = onCleanup(@() traceSpan('stop'));
+    end
+    rootSpan = traceSpan('begin', 'buildGMMmodelGSB');
     
-    % Load training data
-    srcUtts = loadUttGSB(srcSpkrFiles); % struct
-    tgtUtts = loadUttGSB(tgtSpkrFiles); % struct
+    % The checkpoints of the data are keyed on the input files and the
+    % pairing options, the ones of the EM also on the GMM options
+    isCheckpointed = ~isempty(checkpointDir);
+    isResumed = false;
+    if isCheckpointed
+        if ~exist(checkpointDir, 'dir')
+            tryCreateDir(checkpointDir);
+        end
+        keyFiles = [srcSpkrFiles(:); tgtSpkrFiles(:)];
+        if ischar(tgtIndex) && ~isempty(tgtIndex)
+            keyFiles{end+1} = fullfile(tgtIndex, 'index.mat');
+        elseif isstruct(tgtIndex)
+            keyFiles = [keyFiles; tgtIndex.files(:)];
+        end
+        dataKey = hashContent({}, [fileSignature(keyFiles), phoneBuckets]);
+        emKey = hashContent({}, sprintf('%s|%d|%s|%g|%g|%s', dataKey,...
+            nMix, covType, isCheckCov, epsilon, emPrecision));
+        pairFile = fullfile(checkpointDir, 'pairing.mat');
+        featFiles = {fullfile(checkpointDir, 'features.bin'),...
+            fullfile(checkpointDir, 'features.mat')};
+        isResumed = isCheckpointValid(checkpointDir, 'features', dataKey,...
+            featFiles);
+    end
+
+    if isResumed
+        % The training features are ready, skip the data preparation
+        fprintf('Resuming from the checkpoint in %s...\n', checkpointDir)
+        span = traceSpan('begin', 'load');
+        info = load(featFiles{2});
+        tgtGVs = info.tgtGVs;
+        tgtSpkrFiles = info.tgtSpkrFiles;
+        numFrames = info.numFrames;
+        % Transposed a block of frames at a time, not as a whole copy
+        featStore = struct('file', featFiles{1}, 'precision', 'double',...
+            'dim', info.dim, 'numFrames', numFrames);
+        feats = zeros(numFrames, info.dim);
+        for first = 1:blockFrames:numFrames
+            last = min([first + blockFrames - 1, numFrames]);
+            feats(first:last, :) = readFrames(featStore, first, last)';
+        end
+        clear info featStore
+        traceSpan('end', span, numFrames);
+    else
+        % Load training data, only what the training uses, and leave the
+        % PPGs on disk until the frames are prepared
+        span = traceSpan('begin', 'load');
+        isIndexed = ~isempty(tgtIndex);
+        if isIndexed
+            if ischar(tgtIndex)
+                assert(isempty(tgtSpkrFiles) ||...
+                    pairingIndex('isValid', tgtIndex, tgtSpkrFiles),...
+                    ['The pairing index in %s is not built from ',...
+                    'tgtSpkrFiles.'], tgtIndex);
+                tgtIndex = pairingIndex('load', tgtIndex);
+            else
+                assert(isempty(tgtSpkrFiles) ||...
+                    isequal(tgtIndex.files, tgtSpkrFiles(:)),...
+                    'The pairing index is not built from tgtSpkrFiles.');
+            end
+            tgtSpkrFiles = tgtIndex.files;
+        else
+            assert(~isempty(tgtSpkrFiles),...
+                'Need tgtSpkrFiles or a ''TargetIndex''.');
+        end
+        srcUtts = loadUttGSB(srcSpkrFiles, 'VarList', {'mcep', 'lab'},...
+            'Lazy', true, 'NumWorkers', numWorkers); % struct
+        if ~isIndexed
+            tgtUtts = loadUttGSB(tgtSpkrFiles, 'VarList', {'mcep', 'lab'},...
+                'Lazy', true, 'NumWorkers', numWorkers); % struct
+        end
+        traceSpan('end', span);
     
-    % Convert raw data to training ready format
-    [concSrcMcep, srcPost] = prepareDataGMM(srcUtts);
-    [concTgtMcep, tgtPost] = prepareDataGMM(tgtUtts);
+        % Convert raw data to training ready format
+        span = traceSpan('begin', 'prepare');
+        srcPostStore = '';
+        tgtPostStore = '';
+        if ~isempty(postStore)
+            srcPostStore = fullfile(postStore, 'src_post.bin');
+            tgtPostStore = fullfile(postStore, 'tgt_post.bin');
+        end
+        [concSrcMcep, srcPost, srcLab] = prepareDataGMM(srcUtts,...
+            'PostStore', srcPostStore);
+        if isIndexed
+            concTgtMcep = tgtIndex.mcep;
+            tgtPost = tgtIndex;
+            tgtLab = tgtIndex.lab;
+            tgtIndex = [];
+        else
+            [concTgtMcep, tgtPost, tgtLab] = prepareDataGMM(tgtUtts,...
+                'PostStore', tgtPostStore);
+        end
+        numSrcFrames = size(concSrcMcep, 2);
+        numTgtFrames = size(concTgtMcep, 2);
+        numFrames = numSrcFrames + numTgtFrames;
+        traceSpan('end', span, numFrames);
     
-    % Perform PPG-based frame pairing
-    [mapToSrc, mapToTgt] = framePairingPPG(srcPost, tgtPost, splitSize,...
-        true);
+        % Perform PPG-based frame pairing
+        span = traceSpan('begin', 'pair');
+        pairingArgs = {'MemoryBudget', pairingMemory};
+        if ~strcmp(phoneBuckets, 'off')
+            pairingArgs = [pairingArgs, {'SrcLabels', srcLab, 'TgtLabels',...
+                tgtLab, 'Neighbors', strrep(phoneBuckets, 'exact', 'none')}];
+        end
+        if isCheckpointed && isCheckpointValid(checkpointDir, 'pairing',...
+                dataKey, {pairFile})
+            load(pairFile, 'mapToSrc', 'mapToTgt');
+        else
+            [mapToSrc, mapToTgt] = framePairingPPG(srcPost, tgtPost,...
+                splitSize, true, pairingArgs{:});
+            if isCheckpointed
+                save(pairFile, 'mapToSrc', 'mapToTgt', '-v7.3');
+                markCheckpoint(checkpointDir, 'pairing', dataKey,...
+                    {pairFile});
+            end
+        end
+        traceSpan('end', span, numFrames);
+        if isIndexed
+            tgtGVs = tgtPost.gvs;
+        end
+        clear srcPost tgtPost
+        if ~isempty(postStore)
+            delete(srcPostStore);
+            if ~isIndexed
+                delete(tgtPostStore);
+            end
+        end
     
-    % Get the training acoustics
-    srcMcep = [concSrcMcep'; concSrcMcep(:, mapToTgt)'];
-    tgtMcep = [concTgtMcep(:, mapToSrc)'; concTgtMcep'];
+        % Get the training acoustics, written straight into the joint
+        % [source, target] matrix that the GMM is trained on
+        srcDim = size(concSrcMcep, 1);
+        feats = zeros(numFrames, srcDim + size(concTgtMcep, 1));
+        feats(1:numSrcFrames, 1:srcDim) = concSrcMcep';
+        feats((numSrcFrames+1):end, 1:srcDim) = concSrcMcep(:, mapToTgt)';
+        feats(1:numSrcFrames, (srcDim+1):end) = concTgtMcep(:, mapToSrc)';
+        feats((numSrcFrames+1):end, (srcDim+1):end) = concTgtMcep';
+        clear concSrcMcep concTgtMcep
     
-    % Get GV
-    fprintf('Calculating global variance...\n')
-    tgtGVs = calculateGlobalVar(tgtUtts, 2:25, 'mcep');
-    fprintf('Calculating global variance finished.\n')
+        % Get GV
+        if ~isIndexed
+            fprintf('Calculating global variance...\n')
+            span = traceSpan('begin', 'gv');
+            tgtGVs = calculateGlobalVar(tgtUtts, 2:25, 'mcep');
+            traceSpan('end', span, numTgtFrames);
+            fprintf('Calculating global variance finished.\n')
+        end
+
+        % Keep the features, as a frame store of the joint frames
+        if isCheckpointed
+            span = traceSpan('begin', 'checkpoint');
+            fid = fopen(featFiles{1}, 'w');
+            if fid < 0
+                error('Cannot write the checkpoint in %s.', checkpointDir);
+            end
+            for first = 1:blockFrames:numFrames
+                last = min([first + blockFrames - 1, numFrames]);
+                fwrite(fid, feats(first:last, :)', 'double');
+            end
+            fclose(fid);
+            dim = size(feats, 2);
+            save(featFiles{2}, 'tgtGVs', 'tgtSpkrFiles', 'numFrames', 'dim');
+            markCheckpoint(checkpointDir, 'features', dataKey, featFiles);
+            traceSpan('end', span, numFrames);
+        end
+    end
 
     % Training GMM, will retry if failes
     fprintf('Training a GMM model for spectral conversion...\n')
-    feats = [srcMcep, tgtMcep];
     isTrainModelSucceed = false;
     for ii = 1:maxRetry
-        dim = size(srcMcep, 2) + size(tgtMcep, 2);
+        trainSpan = traceSpan('begin', 'gmm/train');
+        dim = size(feats, 2);
         mix = gmm(dim, nMix, covType);
-        mix = gmminit(mix, feats, gmmOptions);
-        [mix, gmmOptions, errlog] = gmmem(mix, feats, gmmOptions);
+        if numStarts > 1
+            % Every start is initialized on its own, with new seeds on
+            % each retry
+            [mix, gmmOptions, errlog] = gmmemMultiStart(mix, feats,...
+                gmmOptions, 'NumStarts', numStarts, 'NumWorkers',...
+                startWorkers, 'Seed', (ii-1)*numStarts, 'Precision',...
+                strrep(emPrecision, 'netlab', 'double'));
+        else
+            % Resume from the latest EM checkpoint of the first try
+            errlog = [];
+            isConverged = false;
+            lastSlot = 0;
+            if isCheckpointed && ii == 1
+                for slot = 1:2
+                    emFile = fullfile(checkpointDir, sprintf('em_%d.mat',...
+                        slot));
+                    if isCheckpointValid(checkpointDir,...
+                            sprintf('em_%d', slot), emKey, {emFile})
+                        checkpoint = load(emFile);
+                        if length(checkpoint.errlog) > length(errlog)
+                            mix = checkpoint.mix;
+                            errlog = checkpoint.errlog;
+                            isConverged = checkpoint.isConverged;
+                            lastSlot = slot;
+                        end
+                    end
+                end
+                clear checkpoint
+            elseif isCheckpointed
+                delete(fullfile(checkpointDir, 'checkpoint', 'em_*.md5'));
+            end
+            if isempty(errlog)
+                span = traceSpan('begin', 'gmm/init');
+                mix = gmminit(mix, feats, gmmOptions);
+                traceSpan('end', span, size(feats, 1));
+            else
+                fprintf('Resuming the EM from iteration %d...\n',...
+                    length(errlog));
+            end
+            % The EM runs 'CheckpointEvery' iterations at a time, and
+            % stops early as 'gmmem' does, the error of the last iteration
+            % is passed on so that the convergence is tested across chunks
+            totalIters = nIter;
+            if totalIters == 0
+                totalIters = 100; % as in 'gmmem'
+            end
+            emIters = totalIters;
+            if isCheckpointed
+                emIters = checkpointEvery;
+            end
+            while length(errlog) < totalIters && ~isConverged &&...
+                    ~any(isnan(errlog))
+                chunkOptions = gmmOptions;
+                chunkOptions(14) = min([emIters,...
+                    totalIters - length(errlog)]);
+                prevError = NaN;
+                if ~isempty(errlog)
+                    prevError = errlog(end);
+                end
+                [mix, chunkOptions, chunkErrlog] = trainEM(mix, feats,...
+                    chunkOptions, emWorkers, emPort, emPrecision, prevError);
+                numDone = find(chunkErrlog ~= 0, 1, 'last');
+                errlog = [errlog, chunkErrlog(1:numDone)]; %#ok<AGROW>
+                % The same test as in 'gmmem', on the whole errlog
+                isConverged = numDone < chunkOptions(14) ||...
+                    (epsilon > 0 && length(errlog) > 1 &&...
+                    abs(errlog(end) - errlog(end-1)) < epsilon);
+                gmmOptions(8) = chunkOptions(8);
+                if isCheckpointed && ~any(isnan(errlog))
+                    % Two slots, so that the previous checkpoint is still
+                    % there if this one is cut short, the other one than
+                    % the latest, also after a resume
+                    slot = mod(lastSlot, 2) + 1;
+                    lastSlot = slot;
+                    emFile = fullfile(checkpointDir, sprintf('em_%d.mat',...
+                        slot));
+                    save(emFile, 'mix', 'errlog', 'isConverged');
+                    markCheckpoint(checkpointDir, sprintf('em_%d', slot),...
+                        emKey, {emFile});
+                end
+            end
+        end
+        traceSpan('end', trainSpan, size(feats, 1));
         if sum(isnan(errlog)) == 0
             isTrainModelSucceed = true;
             status = 1;
@@ -141,6 +475,10 @@ function [modelPath, status] = buildGMMmodelGSB(srcSpkrFiles, tgtSpkrFiles, mode
             'amount of data.'], maxRetry);
         modelPath = '';
         status = 0;
+        traceSpan('end', rootSpan, numFrames);
+        if isTraceOwner
+            writeTrace(traceSpan('stop'), tracePath);
+        end
         return
     end
     fprintf('Training GMM model finished.\n')
@@ -159,6 +497,55 @@ function [modelPath, status] = buildGMMmodelGSB(srcSpkrFiles, tgtSpkrFiles, mode
     model.status = status;
     
     % Save the model
+    span = traceSpan('begin', 'save');
     status = trySaveStructFields(model, modelPath);
+    traceSpan('end', span);
     fprintf('Compiling spectral conversion model finished.\n')
-end
\ No newline at end of file
+    traceSpan('end', rootSpan, numFrames);
+    if isTraceOwner
+        writeTrace(traceSpan('stop'), tracePath);
+    end
+end
+
+% One run of the EM, in this process, or spread over worker processes
+function [mix, options, errlog] = trainEM(mix, feats, options, emWorkers, emPort, emPrecision, prevError)
+    if emWorkers > 0
+        [mix, options, errlog] = gmmemDistributed(mix, feats, options,...
+            'NumWorkers', emWorkers, 'Port', emPort, 'Spawn', emPort == 0,...
+            'Precision', strrep(emPrecision, 'netlab', 'double'),...
+            'InitialError', prevError);
+    elseif ~strcmp(emPrecision, 'netlab')
+        [mix, options, errlog] = gmmemLogDomain(mix, feats, options,...
+            'Precision', emPrecision, 'InitialError', prevError);
+    else
+        % 'gmmem' cannot be given the previous error, so its first
+        % iteration is tested here, with the same error as in 'gmmem'
+        if options(3) > 0 && ~isnan(prevError)
+            [~, act] = gmmpost(mix, feats);
+            e = -sum(log(act*(mix.priors)' + eps));
+            if abs(e - prevError) < options(3)
+                errlog = zeros(1, max([options(14), 1]));
+                errlog(1) = e;
+                options(8) = e;
+                return
+            end
+        end
+        % netlab's 'gmmem' is traced as a whole, it is vendored as it is
+        span = traceSpan('begin', 'em/netlab');
+        [mix, options, errlog] = gmmem(mix, feats, options);
+        traceSpan('end', span, size(feats, 1)*nnz(errlog));
+    end
+end
+
+% A checkpoint is valid if the digest of its files, recorded after they
+% were written, matches
+function isValid = isCheckpointValid(checkpointDir, name, key, files)
+    isValid = all(cellfun(@(x) exist(x, 'file') == 2, files)) &&...
+        isStageCached(checkpointDir, 'checkpoint', name,...
+        hashContent(files, key), files);
+end
+
+function markCheckpoint(checkpointDir, name, key, files)
+    markStageCached(checkpointDir, 'checkpoint', name,...
+        hashContent(files, key));
+end
@@ -12,12 +12,20 @@
 %   'Mode': 'heq' (*) | 'log'; 'log' mode builds the model using the
 %   log-scale mean and variance normalization. 'heq' mode builds the model
 %   using f0 histogram equalization.
+%   'Streaming': 1 | 0 (*), only used by the 'heq' mode. Set to '1' to
+%   train the model with trainF0HEQStream, which does not concatenate the
+%   F0 values of all utterances in memory, and does not save them in the
+%   model (no 'data' field).
+%   'NumWorkers': An interger. How many parallel workers to use in the
+%   streaming mode. Default to 0, which tells Matlab not to run parallel
+%   computing.
 %
 % Outputs:
 %   modelPath: path to the trained model
 %   status: status flag. '1' for success and '0' for failure.
 %
-% Other m-files required: trainF0HEQ, loadUttGSB, trySaveStructFields
+% Other m-files required: trainF0HEQ, trainF0HEQStream, loadUttGSB,
+% trySaveStructFields
 %
 % Subfunctions: None
 %
@@ -25,7 +33,7 @@
 %
 % Author: Guanlong Zhao
 % Email: gzhao@tamu.edu
-% Created: 04/24/2017; Last revision: 10/24/2018
+% Created: 04/24/2017; Last revision: 10/18/2026
 % Revision log:
 %   04/24/2017: function creation, Guanlong Zhao
 %   07/03/2017: added mode 'hertz', GZ
@@ -34,6 +42,7 @@
 %   10/02/2018: filter abnormal F0 values, GZ
 %   10/23/2018: change for GSB server, GZ
 %   10/24/2018: refine input validation, GZ
+%   10/18/2026: added the streaming 'heq' mode, GZ
 
 % Copyright 2017 Guanlong Zhao
 % 
@@ -55,10 +64,32 @@ function [modelPath, status] = buildPitchModelGSB(spkrFiles, modelPath, varargin
     addRequired(p, 'spkrFiles', @iscellstr);
     addRequired(p, 'modelPath', @ischar);
     addParameter(p, 'Mode', 'heq', @(x) ismember(x, {'heq', 'log'}));
+    addParameter(p, 'Streaming', 0, @isnumeric);
+    addParameter(p, 'NumWorkers', 0, @(x) isnumeric(x) && x>=0);
     parse(p, spkrFiles, modelPath, varargin{:});
     mode = p.Results.Mode;
+    isStreaming = p.Results.Streaming;
+    numWorkers = p.Results.NumWorkers;
     status = 0;
     
+    % Streaming HEQ, never holds all the F0 values in memory
+    if strcmp(mode, 'heq') && isStreaming
+        [model, invalidIdx] = trainF0HEQStream(spkrFiles,...
+            'NumWorkers', numWorkers);
+        if length(invalidIdx) == length(spkrFiles)
+            disp('No valid training data!');
+            modelPath = '';
+            return
+        end
+        model.utts = spkrFiles;
+        model.utts(invalidIdx) = []; % delete utt indices that do not exist
+        model.mode = mode;
+        model.procedure = 'buildPitchModelGSB';
+        model.timestamp = datestr(clock, 30);
+        status = trySaveStructFields(model, modelPath);
+        return
+    end
+    
     % Get training data
     [utts, invalidIdx] = loadUttGSB(spkrFiles, 'VarList', {'source'});
     if isempty(utts)
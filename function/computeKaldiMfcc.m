@@ -0,0 +1,212 @@
+% computeKaldiMfcc: compute MFCCs the same way as Kaldi's 'compute-mfcc-feats',
+% so that the features can be fed to a Kaldi-trained acoustic model
+% without calling Kaldi. The options use the names of the Kaldi
+% command-line options in camel case, e.g., '--frame-shift=5' becomes
+% 'frameShift', see 'loadPpgModel' for reading them from a Kaldi config
+% file. Options that are not given take the Kaldi default values, except
+% for 'dither', which defaults to 0 so that the features are
+% deterministic.
+%
+% Syntax: mfcc = computeKaldiMfcc(wav, opts)
+%
+% Inputs:
+%   wav: A vector. The waveform, in 16-bit sample scale (i.e., the output
+%   of 'audioread' multiplied by 32768), same as Kaldi.
+%   opts: A struct. MFCC options, any of
+%       - sampleFrequency: default to 16000
+%       - frameShift: in ms, default to 10
+%       - frameLength: in ms, default to 25
+%       - dither: default to 0
+%       - preemphasisCoefficient: default to 0.97
+%       - removeDcOffset: default to true
+%       - windowType: 'povey' (*) | 'hamming' | 'hanning' | 'rectangular' |
+%       'blackman' | 'sine'
+%       - blackmanCoeff: default to 0.42
+%       - roundToPowerOfTwo: default to true
+%       - snipEdges: default to true
+%       - numMelBins: default to 23
+%       - lowFreq: default to 20
+%       - highFreq: default to 0, non-positive values are offsets from the
+%       Nyquist frequency
+%       - numCeps: default to 13
+%       - useEnergy: default to true
+%       - energyFloor: default to 0
+%       - rawEnergy: default to true
+%       - cepstralLifter: default to 22
+%
+% Outputs:
+%   mfcc: A numCeps*T matrix.
+%
+% Other m-files required: None
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function mfcc = computeKaldiMfcc(wav, opts)
+    if nargin < 2
+        opts = struct();
+    end
+    % Kaldi defaults
+    defaults = struct('sampleFrequency', 16000, 'frameShift', 10,...
+        'frameLength', 25, 'dither', 0, 'preemphasisCoefficient', 0.97,...
+        'removeDcOffset', true, 'windowType', 'povey',...
+        'blackmanCoeff', 0.42, 'roundToPowerOfTwo', true,...
+        'snipEdges', true, 'numMelBins', 23, 'lowFreq', 20,...
+        'highFreq', 0, 'numCeps', 13, 'useEnergy', true,...
+        'energyFloor', 0, 'rawEnergy', true, 'cepstralLifter', 22);
+    optNames = fieldnames(defaults);
+    for ii = 1:length(optNames)
+        if ~isfield(opts, optNames{ii})
+            opts.(optNames{ii}) = defaults.(optNames{ii});
+        end
+    end
+
+    fs = opts.sampleFrequency;
+    frameShift = fix(fs*0.001*opts.frameShift);
+    frameLength = fix(fs*0.001*opts.frameLength);
+    if opts.roundToPowerOfTwo
+        fftLength = 2^nextpow2(frameLength);
+    else
+        fftLength = frameLength;
+    end
+    wav = double(wav(:));
+    numSamples = length(wav);
+
+    % Framing, refer to feature-window.cc
+    if opts.snipEdges
+        if numSamples < frameLength
+            numFrames = 0;
+        else
+            numFrames = 1 + floor((numSamples - frameLength)/frameShift);
+        end
+        frameStarts = (0:(numFrames-1))*frameShift;
+    else
+        numFrames = floor((numSamples + floor(frameShift/2))/frameShift);
+        frameStarts = (0:(numFrames-1))*frameShift +...
+            floor(frameShift/2) - floor(frameLength/2);
+    end
+    mfcc = zeros(opts.numCeps, numFrames);
+    if numFrames == 0
+        return
+    end
+    sampleIdx = bsxfun(@plus, (0:(frameLength-1))', frameStarts);
+    % Samples outside of the waveform are reflected at the edges
+    isOutside = sampleIdx < 0 | sampleIdx >= numSamples;
+    while any(isOutside(:))
+        isNeg = sampleIdx < 0;
+        sampleIdx(isNeg) = -sampleIdx(isNeg) - 1;
+        isOver = sampleIdx >= numSamples;
+        sampleIdx(isOver) = 2*numSamples - 1 - sampleIdx(isOver);
+        isOutside = sampleIdx < 0 | sampleIdx >= numSamples;
+    end
+    frames = wav(sampleIdx + 1);
+    frames = reshape(frames, frameLength, numFrames);
+
+    % Window processing, same order as ProcessWindow
+    if opts.dither ~= 0
+        frames = frames + opts.dither*randn(size(frames));
+    end
+    if opts.removeDcOffset
+        frames = bsxfun(@minus, frames, mean(frames, 1));
+    end
+    if opts.useEnergy && opts.rawEnergy
+        logEnergy = log(max(sum(frames.^2, 1), realmin('single')));
+    end
+    if opts.preemphasisCoefficient ~= 0
+        frames(2:end, :) = frames(2:end, :) -...
+            opts.preemphasisCoefficient*frames(1:(end-1), :);
+        frames(1, :) = frames(1, :)*(1 - opts.preemphasisCoefficient);
+    end
+    n = (0:(frameLength-1))';
+    a = 2*pi/(frameLength - 1);
+    switch opts.windowType
+        case 'povey'
+            win = (0.5 - 0.5*cos(a*n)).^0.85;
+        case 'hanning'
+            win = 0.5 - 0.5*cos(a*n);
+        case 'hamming'
+            win = 0.54 - 0.46*cos(a*n);
+        case 'sine'
+            win = sin(0.5*a*n);
+        case 'rectangular'
+            win = ones(frameLength, 1);
+        case 'blackman'
+            win = opts.blackmanCoeff - 0.5*cos(a*n) +...
+                (0.5 - opts.blackmanCoeff)*cos(2*a*n);
+        otherwise
+            error('Unknown window type %s', opts.windowType);
+    end
+    frames = bsxfun(@times, frames, win);
+    if opts.useEnergy && ~opts.rawEnergy
+        logEnergy = log(max(sum(frames.^2, 1), realmin('single')));
+    end
+
+    % Power spectrum, Kaldi leaves out the Nyquist bin for the mel banks
+    spec = fft(frames, fftLength, 1);
+    numFftBins = fftLength/2;
+    powerSpec = abs(spec(1:numFftBins, :)).^2;
+
+    % Mel banks, refer to mel-computations.cc
+    melScale = @(f) 1127*log(1 + f/700);
+    nyquist = 0.5*fs;
+    if opts.highFreq > 0
+        highFreq = opts.highFreq;
+    else
+        highFreq = nyquist + opts.highFreq;
+    end
+    melLow = melScale(opts.lowFreq);
+    melHigh = melScale(highFreq);
+    melDelta = (melHigh - melLow)/(opts.numMelBins + 1);
+    binMel = melScale((0:(numFftBins-1))*fs/fftLength);
+    melBanks = zeros(opts.numMelBins, numFftBins);
+    for bb = 1:opts.numMelBins
+        leftMel = melLow + (bb-1)*melDelta;
+        centerMel = leftMel + melDelta;
+        rightMel = centerMel + melDelta;
+        isUp = binMel > leftMel & binMel <= centerMel;
+        isDown = binMel > centerMel & binMel < rightMel;
+        melBanks(bb, isUp) = (binMel(isUp) - leftMel)/(centerMel - leftMel);
+        melBanks(bb, isDown) =...
+            (rightMel - binMel(isDown))/(rightMel - centerMel);
+    end
+    melEnergies = log(max(melBanks*powerSpec, eps('single')));
+
+    % DCT and liftering
+    numBins = opts.numMelBins;
+    dctMat = sqrt(2/numBins)*cos(pi/numBins*...
+        ((0:(opts.numCeps-1))'*((0:(numBins-1)) + 0.5)));
+    dctMat(1, :) = sqrt(1/numBins);
+    mfcc = dctMat*melEnergies;
+    if opts.cepstralLifter ~= 0
+        q = opts.cepstralLifter;
+        lifter = 1 + 0.5*q*sin(pi*(0:(opts.numCeps-1))'/q);
+        mfcc = bsxfun(@times, mfcc, lifter);
+    end
+    if opts.useEnergy
+        if opts.energyFloor > 0
+            logEnergy = max(logEnergy, log(opts.energyFloor));
+        end
+        mfcc(1, :) = logEnergy;
+    end
+end
@@ -0,0 +1,88 @@
+% computePpg: compute the posteriorgram (PPG) of an utterance in process,
+% replacing the Kaldi pipeline in 'make_posteriors.sh',
+%   apply-cmvn | splice-feats | transform-feats | nnet-compute
+% The input is the MFCCs from 'computeKaldiMfcc', and the output is the
+% same as the Kaldi output, up to float rounding.
+%
+% Syntax: post = computePpg(mfcc, model, cmvnStats)
+%
+% Inputs:
+%   mfcc: A D*T matrix. MFCCs of the utterance, see 'computeKaldiMfcc'.
+%   model: A struct. Output of 'loadPpgModel'.
+%   cmvnStats: A 2*(D+1) matrix. CMVN stats of the speaker, see
+%   'accCmvnStats'. Kaldi computes them over all the utterances of a
+%   speaker. Default to the stats of this utterance.
+%
+%   [Optional name-value pairs]
+%   'BatchSize': Number of frames per nnet batch. Default to 1024, see
+%   'nnet2Forward'
+%
+% Outputs:
+%   post: A K*T single matrix, K is 5816 for the default model.
+%
+% Other m-files required: accCmvnStats, nnet2Forward
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function post = computePpg(mfcc, model, cmvnStats, varargin)
+    if nargin < 3 || isempty(cmvnStats)
+        cmvnStats = accCmvnStats(mfcc);
+    end
+    p = inputParser;
+    addParameter(p, 'BatchSize', 1024, @(x) isnumeric(x) && x>=1);
+    parse(p, varargin{:});
+    batchSize = p.Results.BatchSize;
+
+    % CMVN, same as 'apply-cmvn'
+    [dim, numFrames] = size(mfcc);
+    assert(size(cmvnStats, 2) == dim + 1, 'CMVN stats dim mismatch.');
+    count = cmvnStats(1, end);
+    cmvnMean = cmvnStats(1, 1:dim)'/count;
+    feats = bsxfun(@minus, double(mfcc), cmvnMean);
+    if model.normVars
+        cmvnVar = max(cmvnStats(2, 1:dim)'/count - cmvnMean.^2, 1e-20);
+        feats = bsxfun(@rdivide, feats, sqrt(cmvnVar));
+    end
+
+    % Splicing, same as 'splice-feats', the edge frames are repeated
+    context = (-model.leftContext):model.rightContext;
+    frameIdx = bsxfun(@plus, context', 1:numFrames);
+    frameIdx = min(max(frameIdx, 1), numFrames);
+    feats = reshape(feats(:, frameIdx), [], numFrames);
+
+    % LDA, same as 'transform-feats', linear or affine
+    lda = model.lda;
+    if size(lda, 2) == size(feats, 1)
+        feats = lda*feats;
+    elseif size(lda, 2) == size(feats, 1) + 1
+        feats = bsxfun(@plus, lda(:, 1:(end-1))*feats, lda(:, end));
+    else
+        error('LDA dim mismatch, %d-dim spliced features, %d*%d transform.',...
+            size(feats, 1), size(lda, 1), size(lda, 2));
+    end
+
+    % Forward pass, same as 'nnet-compute --apply-log=false'
+    post = nnet2Forward(model.nnet, feats, batchSize);
+end
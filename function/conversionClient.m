@@ -0,0 +1,118 @@
+% conversionClient: talk to a running 'conversionServer' on this machine,
+% to convert a wav, read the metrics of the server, or stop it. A job that
+% the server rejects because its queue is full raises the error
+% 'conversionClient:rejected', whose message has the suggested wait, so
+% that the caller can back off and retry.
+%
+% Syntax: [wav, fs, info] = conversionClient('convert', port, wav, fs, gmmMdl, srcPitchMdl, tgtPitchMdl)
+%         stats = conversionClient('stats', port)
+%         conversionClient('stop', port)
+%
+% Inputs:
+%   command: A string,
+%       - 'convert': convert a wav, and wait for the result
+%       - 'stats': read the metrics of the server
+%       - 'stop': stop the server once the queued jobs are done
+%   port: The port of the server, see 'conversionServer'.
+%   wav: A vector. The source audio, resampled to 16 kHz by the server if
+%   needed.
+%   fs: Sampling rate of 'wav'.
+%   gmmMdl, srcPitchMdl, tgtPitchMdl: Strings. Paths to the models on the
+%   server, which keeps them loaded for the next jobs.
+%
+%   [Optional name-value pairs]
+%   'TextGrid': ('convert') A string. Path to the TextGrid of the wav on
+%   the server, which marks the silence. Default to '', every frame is
+%   converted as speech
+%   'Timeout': seconds to wait for the reply. Default to 600
+%
+% Outputs:
+%   wav: A vector. The converted audio.
+%   fs: Sampling rate of the converted audio.
+%   info: A struct, with 'queueSec' (time the job waited for a worker) and
+%   'serviceSec' (time to convert it).
+%   stats: A struct,
+%       - numAccepted, numRejected, numDone, numFailed: job counts
+%       - modelHits, modelMisses: lookups of the model cache
+%       - p50total, p95total, p99total: latency percentiles of the last
+%       10000 jobs in seconds, from arrival to reply; likewise p50queue,
+%       ..., and p50service, ...
+%       - queueLength, numRunning, numModels: the current state
+%       - uptimeSec
+%
+% Other m-files required: socketMessage
+%
+% Subfunctions: request
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function varargout = conversionClient(command, port, varargin)
+    switch command
+        case 'convert'
+            p = inputParser;
+            addRequired(p, 'wav', @isnumeric);
+            addRequired(p, 'fs', @isnumeric);
+            addRequired(p, 'gmmMdl', @ischar);
+            addRequired(p, 'srcPitchMdl', @ischar);
+            addRequired(p, 'tgtPitchMdl', @ischar);
+            addParameter(p, 'TextGrid', '', @ischar);
+            addParameter(p, 'Timeout', 600, @(x) isnumeric(x) && x>0);
+            parse(p, varargin{:});
+            message = struct('command', 'convert', 'wav', p.Results.wav,...
+                'fs', p.Results.fs, 'gmmMdl', p.Results.gmmMdl,...
+                'srcPitchMdl', p.Results.srcPitchMdl, 'tgtPitchMdl',...
+                p.Results.tgtPitchMdl, 'textGrid', p.Results.TextGrid);
+            result = request(port, message, p.Results.Timeout);
+            switch result.status
+                case 'ok'
+                    varargout = {result.wav, result.fs,...
+                        struct('queueSec', result.queueSec,...
+                        'serviceSec', result.serviceSec)};
+                case 'rejected'
+                    error('conversionClient:rejected',...
+                        '%s Retry in %.1f s.', result.message,...
+                        result.retryAfterSec);
+                otherwise
+                    error('Conversion failed on the server: %s',...
+                        result.message);
+            end
+        case {'stats', 'stop'}
+            p = inputParser;
+            addParameter(p, 'Timeout', 600, @(x) isnumeric(x) && x>0);
+            parse(p, varargin{:});
+            varargout{1} = request(port, struct('command', command),...
+                p.Results.Timeout);
+        otherwise
+            error('Unknown conversion client command ''%s''.', command);
+    end
+end
+
+% Send one request on a new connection and wait for the reply
+function result = request(port, message, timeout)
+    sock = java.net.Socket('127.0.0.1', port);
+    sockGuard = onCleanup(@() sock.close());
+    sock.setTcpNoDelay(true);
+    sock.setSoTimeout(timeout*1000);
+    socketMessage('send', sock, message);
+    result = socketMessage('receive', sock);
+end
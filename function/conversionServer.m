@@ -0,0 +1,380 @@
+% conversionServer: a long-running conversion service, so that scripts
+% that convert audio do not pay for starting Matlab, loading the models,
+% and starting a parallel pool for every batch. It listens on a localhost
+% TCP port and takes wav-in/wav-out jobs from 'conversionClient', with the
+% messages of 'socketMessage'. The loaded (and warmed-up, see
+% 'warmConversionModel') models are kept in a least recently used cache
+% keyed by their paths. The jobs run on a fixed pool of workers, and the
+% ones that wait are held in a bounded queue; a job that arrives when the
+% queue is full is rejected right away with an estimate of when to retry,
+% instead of waiting for an unbounded time. The latency of every job (time
+% in the queue and time converting) is recorded and can be read with
+% conversionClient('stats', port). The requests are read a bit at a time
+% as their bytes arrive, so that a slow client does not hold up the
+% others.
+%
+% Syntax: report = conversionServer()
+%
+% Inputs:
+%   [Optional name-value pairs]
+%   'Port': port to listen on, on 127.0.0.1 only. Default to 0, any free
+%   port, which is printed and written to 'PortFile'
+%   'PortFile': A string. If set, the port is written to this file once
+%   the server is ready. Default to ''
+%   'NumWorkers': number of parallel workers that convert the jobs.
+%   Default to 2. With 0, the jobs are converted in this Matlab process,
+%   one at a time
+%   'QueueSize': number of jobs that can wait for a worker, on top of the
+%   ones being converted. Default to 16
+%   'ModelCacheSize': number of model sets (GMM, source pitch, and target
+%   pitch models) kept in memory. Default to 4
+%   'SpecCov': 'MLGV' (*) | 'MMSE' | 'MLPG', see 'voiceConversionGSB'
+%   'RequestTimeout': seconds a client has to send its whole request.
+%   Default to 30
+%   'MaxJobs': stop after this many jobs, e.g., for testing. Default to Inf
+%
+% Outputs:
+%   report: A struct, the final metrics, same as conversionClient('stats').
+%
+% Other m-files required: conversionClient, socketMessage, speechAnalysis,
+% voiceConversionGSB, warmConversionModel, mPraat library
+%
+% Subfunctions: pollRequests, getModels, startJob, convertJob, finishJobs,
+% reply, summarize, percentile
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: read the requests without waiting for slow clients, GZ
+%   10/18/2026: write the port file in one go, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function report = conversionServer(varargin)
+    p = inputParser;
+    addParameter(p, 'Port', 0, @isnumeric);
+    addParameter(p, 'PortFile', '', @ischar);
+    addParameter(p, 'NumWorkers', 2, @(x) isnumeric(x) && x>=0);
+    addParameter(p, 'QueueSize', 16, @(x) isnumeric(x) && x>=0);
+    addParameter(p, 'ModelCacheSize', 4, @(x) isnumeric(x) && x>=1);
+    addParameter(p, 'SpecCov', 'MLGV', @(x) ismember(x,...
+        {'MLGV', 'MLPG', 'MMSE'}));
+    addParameter(p, 'RequestTimeout', 30, @(x) isnumeric(x) && x>0);
+    addParameter(p, 'MaxJobs', Inf, @isnumeric);
+    parse(p, varargin{:});
+    numWorkers = p.Results.NumWorkers;
+    queueSize = p.Results.QueueSize;
+    config.modelCacheSize = p.Results.ModelCacheSize;
+    config.specCov = p.Results.SpecCov;
+    maxJobs = p.Results.MaxJobs;
+
+    % The pool is started before the port is opened, so that a client
+    % never waits for it
+    config.pool = [];
+    if numWorkers > 0
+        pool = gcp('nocreate');
+        if isempty(pool) || pool.NumWorkers ~= numWorkers
+            delete(pool);
+            pool = parpool('local', numWorkers);
+        end
+        config.pool = pool;
+    end
+    numSlots = max([numWorkers, 1]);
+
+    server = java.net.ServerSocket(p.Results.Port, 64,...
+        java.net.InetAddress.getLoopbackAddress());
+    serverGuard = onCleanup(@() server.close());
+    % Poll for connections, so that finished jobs are replied to quickly
+    server.setSoTimeout(20);
+    port = server.getLocalPort();
+    if ~isempty(p.Results.PortFile)
+        % Renamed once written, so that a client never reads half of it
+        tempFile = [p.Results.PortFile, '.tmp'];
+        fid = fopen(tempFile, 'w');
+        fprintf(fid, '%d\n', port);
+        fclose(fid);
+        movefile(tempFile, p.Results.PortFile, 'f');
+    end
+    fprintf(['Conversion server on 127.0.0.1:%d, %d worker(s), queue of ',...
+        '%d jobs\n'], port, numWorkers, queueSize);
+
+    models = struct('key', {}, 'value', {}, 'lastUsed', {});
+    job = struct('id', 0, 'sock', [], 'request', [], 'arrival', uint64(0),...
+        'queueSec', 0, 'future', [], 'output', [], 'errorMessage', '');
+    queue = job([]);
+    running = job([]);
+    % Connections whose request is not all there yet
+    incoming = struct('sock', {}, 'arrival', {}, 'state', {});
+    metrics = struct('startTime', tic, 'numAccepted', 0, 'numRejected', 0,...
+        'numDone', 0, 'numFailed', 0, 'modelHits', 0, 'modelMisses', 0,...
+        'totalSec', [], 'queueSec', [], 'serviceSec', []);
+    isStopping = false;
+    while ~isStopping || ~isempty(queue) || ~isempty(running)
+        [running, metrics] = finishJobs(running, metrics);
+        while ~isempty(queue) && length(running) < numSlots
+            [running(end+1), models, metrics] = startJob(queue(1),...
+                models, metrics, config); %#ok<AGROW>
+            queue(1) = [];
+        end
+        if metrics.numDone + metrics.numFailed >= maxJobs
+            isStopping = true;
+        end
+        if isStopping
+            for ii = 1:length(incoming)
+                incoming(ii).sock.close();
+            end
+            incoming(:) = [];
+            pause(0.02);
+            continue
+        end
+
+        try
+            sock = server.accept();
+            incoming(end+1) = struct('sock', sock, 'arrival', tic,...
+                'state', []); %#ok<AGROW>
+        catch
+            % Nothing to accept
+        end
+        [incoming, requests] = pollRequests(incoming,...
+            p.Results.RequestTimeout);
+        for ii = 1:length(requests)
+            sock = requests(ii).sock;
+            request = requests(ii).request;
+            switch request.command
+                case 'convert'
+                    % Backpressure: reject when every worker is busy and the
+                    % queue is full, with the expected wait
+                    if length(queue) + length(running) >= queueSize + numSlots
+                        metrics.numRejected = metrics.numRejected + 1;
+                        meanService = 0;
+                        if ~isempty(metrics.serviceSec)
+                            meanService = mean(metrics.serviceSec);
+                        end
+                        reply(sock, struct('status', 'rejected', 'message',...
+                            'The queue is full.', 'retryAfterSec',...
+                            meanService*(length(queue)/numSlots + 1)));
+                        continue
+                    end
+                    metrics.numAccepted = metrics.numAccepted + 1;
+                    newJob = job;
+                    newJob.id = metrics.numAccepted;
+                    newJob.sock = sock;
+                    newJob.request = request;
+                    newJob.arrival = tic;
+                    queue(end+1) = newJob; %#ok<AGROW>
+                case 'stats'
+                    stats = summarize(metrics);
+                    stats.queueLength = length(queue);
+                    stats.numRunning = length(running);
+                    stats.numModels = length(models);
+                    reply(sock, stats);
+                case 'stop'
+                    isStopping = true;
+                    reply(sock, struct('status', 'ok'));
+                otherwise
+                    reply(sock, struct('status', 'error', 'message',...
+                        sprintf('Unknown command ''%s''.', request.command)));
+            end
+        end
+    end
+    report = summarize(metrics);
+    fprintf('Conversion server stopped after %d jobs.\n',...
+        report.numDone + report.numFailed);
+end
+
+% Read what has arrived of each request, without waiting. A connection
+% that sends something else than a request, or not all of it in 'timeout'
+% seconds, is closed.
+function [incoming, requests] = pollRequests(incoming, timeout)
+    requests = struct('sock', {}, 'request', {});
+    isDone = false(1, length(incoming));
+    for ii = 1:length(incoming)
+        try
+            [request, incoming(ii).state] = socketMessage('poll',...
+                incoming(ii).sock, incoming(ii).state);
+            if incoming(ii).state.isDone
+                isDone(ii) = true;
+                assert(isstruct(request) && isfield(request, 'command'));
+                requests(end+1) = struct('sock', incoming(ii).sock,...
+                    'request', request); %#ok<AGROW>
+            elseif toc(incoming(ii).arrival) > timeout
+                error('The request timed out.');
+            end
+        catch
+            isDone(ii) = true;
+            incoming(ii).sock.close();
+        end
+    end
+    incoming(isDone) = [];
+end
+
+% Look up a model set in the cache, load and warm it up if it is not there,
+% and evict the least recently used set if the cache is full. With a pool,
+% the models are sent to each worker once, as a parallel.pool.Constant.
+function [value, models, isHit] = getModels(models, paths, config)
+    key = strjoin(paths, '|');
+    tick = max([models.lastUsed, 0]) + 1;
+    idx = find(strcmp({models.key}, key), 1);
+    isHit = ~isempty(idx);
+    if isHit
+        models(idx).lastUsed = tick;
+        value = models(idx).value;
+        return
+    end
+    value.gmmMdl = load(paths{1});
+    if ~isfield(value.gmmMdl, 'cache')
+        value.gmmMdl = warmConversionModel(value.gmmMdl);
+    end
+    value.srcPitchMdl = load(paths{2});
+    value.tgtPitchMdl = load(paths{3});
+    if ~isempty(config.pool)
+        value = parallel.pool.Constant(value);
+    end
+    if length(models) >= config.modelCacheSize
+        [~, lastUsed] = min([models.lastUsed]);
+        models(lastUsed) = [];
+    end
+    models(end+1) = struct('key', key, 'value', value, 'lastUsed', tick);
+end
+
+% Start a job on a worker, or convert it here if there is no pool
+function [job, models, metrics] = startJob(job, models, metrics, config)
+    job.queueSec = toc(job.arrival);
+    request = job.request;
+    try
+        [value, models, isHit] = getModels(models, {request.gmmMdl,...
+            request.srcPitchMdl, request.tgtPitchMdl}, config);
+        if isHit
+            metrics.modelHits = metrics.modelHits + 1;
+        else
+            metrics.modelMisses = metrics.modelMisses + 1;
+        end
+        textGrid = '';
+        if isfield(request, 'textGrid')
+            textGrid = request.textGrid;
+        end
+        if isempty(config.pool)
+            [wav, fs] = convertJob(value, request.wav, request.fs,...
+                textGrid, config.specCov);
+            job.output = struct('wav', wav, 'fs', fs);
+        else
+            job.future = parfeval(config.pool, @convertJob, 2, value,...
+                request.wav, request.fs, textGrid, config.specCov);
+        end
+    catch err
+        job.errorMessage = err.message;
+    end
+    job.request = [];
+end
+
+% Convert one wav. Without a TextGrid, every frame is taken as speech.
+function [wav, fs] = convertJob(models, wav, fs, textGrid, specCov)
+    if isa(models, 'parallel.pool.Constant')
+        models = models.Value;
+    end
+    wav = wav(:, 1);
+    if fs ~= 16000
+        wav = resample(wav, 16000, fs);
+        fs = 16000;
+    end
+    tg = [];
+    if ~isempty(textGrid)
+        tg = tgRead(textGrid);
+    end
+    utt = speechAnalysis(wav, fs, 'TextGrid', tg, 'Vocoder', 'WORLD');
+    if isempty(utt.lab)
+        utt.lab = zeros(1, size(utt.mcep, 2));
+    end
+    covUtt = voiceConversionGSB(utt, models.gmmMdl, models.srcPitchMdl,...
+        models.tgtPitchMdl, 'SpecCov', specCov, 'Outputs', {'wav'});
+    wav = covUtt.wav;
+    fs = covUtt.fs;
+end
+
+% Reply to the jobs that are done, and record their latency
+function [running, metrics] = finishJobs(running, metrics)
+    isDone = false(1, length(running));
+    for ii = 1:length(running)
+        job = running(ii);
+        if ~isempty(job.future)
+            if ~strcmp(job.future.State, 'finished')
+                continue
+            end
+            try
+                [wav, fs] = fetchOutputs(job.future);
+                job.output = struct('wav', wav, 'fs', fs);
+            catch err
+                job.errorMessage = err.message;
+            end
+        end
+        isDone(ii) = true;
+        totalSec = toc(job.arrival);
+        if isempty(job.errorMessage)
+            metrics.numDone = metrics.numDone + 1;
+            metrics.totalSec(end+1) = totalSec;
+            metrics.queueSec(end+1) = job.queueSec;
+            metrics.serviceSec(end+1) = totalSec - job.queueSec;
+            if length(metrics.totalSec) > 10000
+                metrics.totalSec(1) = [];
+                metrics.queueSec(1) = [];
+                metrics.serviceSec(1) = [];
+            end
+            reply(job.sock, struct('status', 'ok', 'wav', job.output.wav,...
+                'fs', job.output.fs, 'queueSec', job.queueSec,...
+                'serviceSec', totalSec - job.queueSec));
+        else
+            metrics.numFailed = metrics.numFailed + 1;
+            reply(job.sock, struct('status', 'error', 'message',...
+                job.errorMessage));
+        end
+    end
+    running(isDone) = [];
+end
+
+% Send a reply and close the connection, a client that is gone is ignored
+function reply(sock, value)
+    try
+        socketMessage('send', sock, value);
+    catch
+    end
+    sock.close();
+end
+
+% Counts and latency percentiles, over the last 10000 jobs
+function stats = summarize(metrics)
+    stats = rmfield(metrics, {'startTime', 'totalSec', 'queueSec',...
+        'serviceSec'});
+    stats.uptimeSec = toc(metrics.startTime);
+    for field = {'totalSec', 'queueSec', 'serviceSec'}
+        values = metrics.(field{1});
+        for pct = [50, 95, 99]
+            stats.(sprintf('p%d%s', pct, field{1}(1:(end-3)))) =...
+                percentile(values, pct);
+        end
+    end
+end
+
+% Nearest-rank percentile, NaN if there are no values
+function value = percentile(values, pct)
+    value = NaN;
+    if ~isempty(values)
+        values = sort(values);
+        value = values(max([1, ceil(pct/100*length(values))]));
+    end
+end
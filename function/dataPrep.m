@@ -6,8 +6,10 @@
 %   - The Montreal Forced aligner is installed
 %   - 'aligner', 'dictionary', and 'acousticModel' have beed configured
 %   - The desired sampling frequency is 16KHz
-%   - The PPG module is in '../dependency/kaldi-posteriorgram'
-%   - Kaldi is installed and configured correctly
+%   - The PPG module is in '../dependency/kaldi-posteriorgram', and the
+%   nnet2 model 'final.raw' is installed in its model dir
+%   - Kaldi is installed and configured correctly, if 'PpgEngine' is
+%   'kaldi'
 %   - Most of the files created by this function will have the file name in
 %   a pre-defined format -- 'gsb_%04d.FileExtension' 
 %
@@ -19,10 +21,19 @@
 %   "'", and "-"
 %   - Perform forced alignment and create TextGrid files
 %   - Perform vocoder-related feature extraction
-%   - Extract PPGs by calling Kaldi
+%   - Extract PPGs, in process by default, or by calling Kaldi
 %   - Compile output cache files and save them
 %   - A log file will be created too
 %
+% The work is organized as a graph of stages, each stage runs over the
+% utterances that still need it, with its own concurrency setting,
+%   resample -> align -> analysis -> ppg + pack
+% Each stage records a content hash (input audio, transcripts, TextGrids,
+% and options) for every utterance it finishes under '/manifest', so a
+% rerun on the same 'outputDir' skips the utterances that are already done,
+% and a run that crashed in the middle of a corpus resumes from where it
+% stopped.
+%
 % Syntax: matList = dataPrep(wavList, transFile, outputDir)
 %
 % Inputs:
@@ -40,6 +51,23 @@
 %   the audio file.
 %   'EndTime': A numeric array. Each element is the actual end time of the
 %   audio file.
+%   'ResampleWorkers': An interger. Parallel workers for the resampling
+%   stage. Default to 'NumWorkers'
+%   'AlignJobs': An interger. Number of jobs for the forced aligner.
+%   Default to 8
+%   'PpgEngine': 'native' (*) | 'kaldi'. 'native' computes the PPGs in
+%   process (see 'computePpg') and hands them straight to the packer;
+%   'kaldi' runs the Kaldi scripts and reads back their ark files
+%   'PpgModel': A struct. A model returned by 'loadPpgModel', so that
+%   several batches can share one loaded model. Default to [], which
+%   loads the default model. Only used by the 'native' engine
+%   'PpgBatchSize': An interger. Number of frames per nnet batch of the
+%   'native' engine. Default to 1024
+%   'PpgJobs': An interger. Number of Kaldi jobs for the PPG extraction.
+%   Default to 8, capped by the number of utterances to process. Only used
+%   by the 'kaldi' engine
+%   'Resume': 1 (*) | 0. Set to '0' to ignore the stage manifests and
+%   process everything from scratch
 %
 % Outputs:
 %   matList: A cell array. Each cell contains the full path to a .mat file,
@@ -54,13 +82,17 @@
 %   - /recording: list of .wav files
 %   - /lab: list of .lab files, each one is a text transcription
 %   - /tg: list of .TextGrid files, each one is a forced alignment file
-%   - /post: raw PPG files
+%   - /post: raw PPG files, only with the 'kaldi' engine
 %   - /mat: list of .mat files, each one contains a processed utt struct
+%   - /manifest: one folder per stage, each one holds the content hashes
+%   of the utterances that have finished that stage
 %   - prompts.txt: a local copy of 'transFile'
 %   - log_$TIMESTAMP: a log file for this run
 %
 % Other m-files required: exFeaturesAPI, arkread, fixPpgLengthMismatch,
-% tryCreateDir
+% tryCreateDir, trySaveStructFields, hashContent, isStageCached,
+% markStageCached, loadPpgModel, computeKaldiMfcc, accCmvnStats,
+% computePpg
 %
 % Subfunctions: None
 %
@@ -68,7 +100,7 @@
 %
 % Author: Guanlong Zhao
 % Email: gzhao@tamu.edu
-% Created: 10/10/2018; Last revision: 10/24/2018
+% Created: 10/10/2018; Last revision: 10/18/2026
 % Revision log:
 %   10/10/2018: function creation, Guanlong Zhao
 %   10/15/2018: add documentation; add options to remove initial and
@@ -76,6 +108,9 @@
 %   10/19/2018: add an option to change the default output dir; change the
 %   way of handling the start and end time, GZ
 %   10/24/2018: removed weird assumptions on output dir, GZ
+%   10/18/2026: run as resumable stages with content-hashed outputs and
+%   per-stage concurrency, GZ
+%   10/18/2026: add the in-process PPG engine, GZ
 
 % Copyright 2018 Guanlong Zhao
 % 
@@ -122,11 +157,33 @@ function matList = dataPrep(wavList, transFile, outputDir, varargin)
     % Add options for clipping the audio length
     addParameter(p, 'StartTime', [], @(x) isnumeric(x) || isempty(x));
     addParameter(p, 'EndTime', [], @(x) isnumeric(x) || isempty(x));
+    % Per-stage concurrency
+    addParameter(p, 'ResampleWorkers', [],...
+        @(x) isempty(x) || (x>=0 && x<=maxWorkers));
+    addParameter(p, 'AlignJobs', 8, @(x) isnumeric(x) && x>=1);
+    addParameter(p, 'PpgJobs', 8, @(x) isnumeric(x) && x>=1);
+    % PPG extraction
+    addParameter(p, 'PpgEngine', 'native',...
+        @(x) ismember(x, {'native', 'kaldi'}));
+    addParameter(p, 'PpgModel', [], @(x) isempty(x) || isstruct(x));
+    addParameter(p, 'PpgBatchSize', 1024, @(x) isnumeric(x) && x>=1);
+    % Skip the utterances that have finished a stage in a previous run
+    addParameter(p, 'Resume', 1, @isnumeric);
     
     parse(p, wavList, transFile, outputDir, varargin{:});
     numWorkers = p.Results.NumWorkers;
     startTime = p.Results.StartTime;
     endTime = p.Results.EndTime;
+    resampleWorkers = p.Results.ResampleWorkers;
+    if isempty(resampleWorkers)
+        resampleWorkers = numWorkers;
+    end
+    alignJobs = p.Results.AlignJobs;
+    ppgJobs = p.Results.PpgJobs;
+    ppgEngine = p.Results.PpgEngine;
+    ppgModel = p.Results.PpgModel;
+    ppgBatchSize = p.Results.PpgBatchSize;
+    isResume = p.Results.Resume;
     
     
     
@@ -167,8 +224,26 @@ function matList = dataPrep(wavList, transFile, outputDir, varargin)
     tryCreateDir(matDir);
     fprintf('Set mat file directory to: %s\n', matDir);
     
+    % Vocoder analysis results waiting for their PPGs, .mat
+    analysisDir = fullfile(outputDir, 'analysis');
+    tryCreateDir(analysisDir);
+    fprintf('Set analysis file directory to: %s\n', analysisDir);
+    
+    % Stage manifests
+    manifestDir = fullfile(outputDir, 'manifest');
+    if ~isResume && exist(manifestDir, 'dir')
+        fprintf('Resume is off, removing stage manifests in %s\n',...
+            manifestDir);
+        rmdir(manifestDir, 's');
+    end
+    tryCreateDir(manifestDir);
+    fprintf('Set stage manifest directory to: %s\n', manifestDir);
+    
     % Temp files
     tempFileDir = fullfile(outputDir, 'temp');
+    if exist(tempFileDir, 'dir')
+        rmdir(tempFileDir, 's'); % leftovers of a crashed run
+    end
     tryCreateDir(tempFileDir);
     fprintf('Set temp file directory to: %s\n', tempFileDir);
     
@@ -184,7 +259,7 @@ function matList = dataPrep(wavList, transFile, outputDir, varargin)
     
     
     % Clip audio (if necessary) and convert audio to mono and resample
-    numWav = 0;
+    fprintf('********** Preparing Audio Files **********\n')
     if ~isempty(startTime)
         assert(length(startTime) == length(wavList),...
             'Start time list is wrong.');
@@ -193,40 +268,68 @@ function matList = dataPrep(wavList, transFile, outputDir, varargin)
         assert(length(endTime) == length(wavList),...
             'End time list is wrong.');
     end
-    for ii = 1:length(wavList)
+    numInputWavs = length(wavList);
+    isWavValid = false(numInputWavs, 1);
+    numResampled = 0;
+    parfor (ii = 1:numInputWavs, resampleWorkers)
         currWavFileName = wavList{ii};
-        if isfile(currWavFileName)
-            [wav, fs] = audioread(currWavFileName);
-            wav = wav(:, 1); % Take the first channel
-            
-            % Clipping, if any
-            startIdx = 1;
-            endIdx = length(wav);
-            if ~isempty(startTime)
-                startIdx = max([1, floor(startTime(ii)*fs) + 1]);
-            end
-            if ~isempty(endTime)
-                endIdx = min([length(wav), floor(endTime(ii)*fs)]);
-            end
-            assert(startIdx < endIdx,...
-                'Clipping start point should always be smaller than the end point!');
-            wav = wav(startIdx:endIdx);
-            
-            % Resample
-            if fs ~= targetFs
-                fprintf('Downsampling %s from %d to %d...\n',...
-                    currWavFileName, fs, targetFs);
-                wav = resample(wav, targetFs, fs); % Resample to target fs
-            end
-            wavCopy = fullfile(audioDir,...
-                sprintf('%s_%04d.wav', filePrefix, ii));
-            fprintf('Saving audio file to %s\n', wavCopy);
-            audiowrite(wavCopy, wav, targetFs);
-            numWav = numWav + 1;
-        else
-            warning('File % does not exist.', currWavFileName);
+        if ~isfile(currWavFileName)
+            warning('File %s does not exist.', currWavFileName);
+            continue;
         end
+        isWavValid(ii) = true;
+        wavCopy = fullfile(audioDir,...
+            sprintf('%s_%04d.wav', filePrefix, ii));
+        clipStart = [];
+        clipEnd = [];
+        if ~isempty(startTime)
+            clipStart = startTime(ii);
+        end
+        if ~isempty(endTime)
+            clipEnd = endTime(ii);
+        end
+        stageKey = hashContent({currWavFileName},...
+            sprintf('fs=%d;start=%s;end=%s', targetFs,...
+            num2str(clipStart, '%.6f'), num2str(clipEnd, '%.6f')));
+        itemName = sprintf('%s_%04d', filePrefix, ii);
+        if isStageCached(manifestDir, 'resample', itemName, stageKey,...
+                {wavCopy})
+            fprintf('Audio file ''%s'' is up to date, skip this file\n',...
+                wavCopy);
+            continue;
+        end
+        
+        [wav, fs] = audioread(currWavFileName);
+        wav = wav(:, 1); % Take the first channel
+        
+        % Clipping, if any
+        startIdx = 1;
+        endIdx = length(wav);
+        if ~isempty(clipStart)
+            startIdx = max([1, floor(clipStart*fs) + 1]);
+        end
+        if ~isempty(clipEnd)
+            endIdx = min([length(wav), floor(clipEnd*fs)]);
+        end
+        assert(startIdx < endIdx,...
+            'Clipping start point should always be smaller than the end point!');
+        wav = wav(startIdx:endIdx);
+        
+        % Resample
+        if fs ~= targetFs
+            fprintf('Downsampling %s from %d to %d...\n',...
+                currWavFileName, fs, targetFs);
+            wav = resample(wav, targetFs, fs); % Resample to target fs
+        end
+        fprintf('Saving audio file to %s\n', wavCopy);
+        audiowrite(wavCopy, wav, targetFs);
+        markStageCached(manifestDir, 'resample', itemName, stageKey);
+        numResampled = numResampled + 1;
     end
+    numWav = sum(isWavValid);
+    fprintf('Resampled %d audio files, %d were up to date\n',...
+        numResampled, numWav - numResampled);
+    fprintf('********** Finished Preparing Audio Files **********\n\n')
     
     
     
@@ -255,129 +358,254 @@ function matList = dataPrep(wavList, transFile, outputDir, varargin)
 
     
     
+    % Utterances handled by the following stages
+    files = dir(fullfile(audioDir, '*.wav'));
+    numFiles = length(files);
+    uttNames = cell(numFiles, 1);
+    for ii = 1:numFiles
+        uttNames{ii} = strrep(files(ii).name, '.wav', '');
+    end
+    wavPaths = fullfile(audioDir, strcat(uttNames, '.wav'));
+    labPaths = fullfile(textDir, strcat(uttNames, '.lab'));
+    tgPaths = fullfile(tgDir, strcat(uttNames, '.TextGrid'));
+    analysisPaths = fullfile(analysisDir, strcat(uttNames, '.mat'));
+    matPaths = fullfile(matDir, strcat(uttNames, '.mat'));
+    
+    
+    
     % Create textgrids
     fprintf('********** Preparing TextGrid Files **********\n')
-    fprintf('Using aligner located at: %s\n', aligner);
-    tempAudioText = fullfile(tempFileDir, 'audio_and_text');
-    tempText = fullfile(tempFileDir, 'tempText');
-    tempAliner = fullfile(tempFileDir, 'temp_aligner');
-    tryCreateDir(tempAudioText);
-    tryCreateDir(tempText);
-    tryCreateDir(tempAliner);
-    fprintf('Copying all audio files to %s\n', tempAudioText)
-    copyfile(fullfile(audioDir, '*.wav'), tempAudioText);
-    fprintf('Done!\n')
-    fprintf('Copying all lab files to %s\n', tempAudioText)
-    copyfile(fullfile(textDir, '*.lab'), tempAudioText);
-    fprintf('Done!\n')
-    alignCmd = sprintf('%s -t %s -j 8 -v -c %s %s %s %s', aligner,...
-        tempAliner, tempAudioText, dictionary, acousticModel, tempText);
-    fprintf('Passing command ''%s'' to system shell\n', alignCmd)
-    fprintf('Running aligner:\n')
-    system(alignCmd, '-echo');
-    fprintf('Finished forced alignment\n')
-    fprintf('Copying all TextGrid files to %s\n', tgDir)
-    copyfile(fullfile(tempText, 'audio_and_text', '*.TextGrid'), tgDir);
-    copyfile(fullfile(tempText, 'oovs_found.txt'), tgDir);
-    fprintf('Cleaning temp folders...\n')
-    rmdir(tempFileDir, 's');
-    fprintf('Done!\n');
+    alignKeys = cell(numFiles, 1);
+    isAlignPending = false(numFiles, 1);
+    for ii = 1:numFiles
+        alignKeys{ii} = hashContent({wavPaths{ii}, labPaths{ii}});
+        isAlignPending(ii) = isfile(labPaths{ii}) &&...
+            ~isStageCached(manifestDir, 'align', uttNames{ii},...
+            alignKeys{ii}, tgPaths(ii));
+    end
+    numAlignPending = sum(isAlignPending);
+    fprintf('%d of %d utterances need forced alignment\n',...
+        numAlignPending, numFiles);
+    if numAlignPending > 0
+        fprintf('Using aligner located at: %s\n', aligner);
+        tempAudioText = fullfile(tempFileDir, 'audio_and_text');
+        tempText = fullfile(tempFileDir, 'tempText');
+        tempAliner = fullfile(tempFileDir, 'temp_aligner');
+        tryCreateDir(tempAudioText);
+        tryCreateDir(tempText);
+        tryCreateDir(tempAliner);
+        fprintf('Copying audio and lab files to %s\n', tempAudioText)
+        for ii = find(isAlignPending)'
+            copyfile(wavPaths{ii}, tempAudioText);
+            copyfile(labPaths{ii}, tempAudioText);
+        end
+        fprintf('Done!\n')
+        alignCmd = sprintf('%s -t %s -j %d -v -c %s %s %s %s', aligner,...
+            tempAliner, alignJobs, tempAudioText, dictionary,...
+            acousticModel, tempText);
+        fprintf('Passing command ''%s'' to system shell\n', alignCmd)
+        fprintf('Running aligner:\n')
+        system(alignCmd, '-echo');
+        fprintf('Finished forced alignment\n')
+        fprintf('Copying all TextGrid files to %s\n', tgDir)
+        copyfile(fullfile(tempText, 'audio_and_text', '*.TextGrid'), tgDir);
+        copyfile(fullfile(tempText, 'oovs_found.txt'), tgDir);
+        for ii = find(isAlignPending)'
+            if isfile(tgPaths{ii})
+                markStageCached(manifestDir, 'align', uttNames{ii},...
+                    alignKeys{ii});
+            end
+        end
+        fprintf('Cleaning temp folders...\n')
+        rmdir(tempAudioText, 's');
+        rmdir(tempText, 's');
+        rmdir(tempAliner, 's');
+        fprintf('Done!\n');
+    end
     fprintf('********** Finished Generating TextGrid Files **********\n\n')
     
     
 
     % Feature extraction
     fprintf('********** Extracting Feature **********\n')
-    files = dir(fullfile(audioDir, '*.wav'));
-    numFiles = length(files);
-    outputBuffer = cell(numFiles, 1); % May get too big?
+    analysisKeys = cell(numFiles, 1);
+    packKeys = cell(numFiles, 1);
     parfor (ii = 1:numFiles, numWorkers)
-        genericPrefix = strrep(files(ii).name, '.wav', '');
-        audioFilePath = fullfile(audioDir, files(ii).name);
+        audioFilePath = wavPaths{ii};
         fprintf('Processing audio file: %s\n', audioFilePath)
         assert(isfile(audioFilePath), 'Error: audio file does not exist!');
-        textFilePath = fullfile(textDir, sprintf('%s.lab', genericPrefix));
+        textFilePath = labPaths{ii};
         if ~isfile(textFilePath)
             fprintf('Transcription ''%s'' does not exist, skip this file\n', textFilePath)
             continue;
         end
-        tgFilePath = fullfile(tgDir, sprintf('%s.TextGrid', genericPrefix));
+        tgFilePath = tgPaths{ii};
         if ~isfile(tgFilePath)
             fprintf('TextGrid ''%s'' does not exist, skip this file\n', tgFilePath)
             continue;
         end
-        matFilePath = fullfile(matDir, sprintf('%s.mat', genericPrefix));
-        if isfile(matFilePath)
-            fprintf('Mat file ''%s'' already exists, skip this file\n', matFilePath)
+        stageKey = hashContent({audioFilePath, textFilePath, tgFilePath},...
+            'vocoder=WORLD');
+        analysisKeys{ii} = stageKey;
+        % The pack stage keys on the analysis and the PPG engine, so a
+        % packed utterance with the same key does not need to be analyzed
+        % again
+        packKey = hashContent({}, [stageKey, ';ppg=', ppgEngine]);
+        packKeys{ii} = packKey;
+        if isStageCached(manifestDir, 'pack', uttNames{ii}, packKey,...
+                {matPaths{ii}})
+            fprintf('Mat file ''%s'' is up to date, skip this file\n', matPaths{ii})
             continue;
         end
-        outputBuffer{ii} = exFeaturesAPI(audioFilePath, textFilePath, tgFilePath);
+        if isStageCached(manifestDir, 'analysis', uttNames{ii},...
+                stageKey, {analysisPaths{ii}})
+            fprintf('Analysis ''%s'' is up to date, skip this file\n', analysisPaths{ii})
+            continue;
+        end
+        utt = exFeaturesAPI(audioFilePath, textFilePath, tgFilePath);
+        trySaveStructFields(utt, analysisPaths{ii});
+        markStageCached(manifestDir, 'analysis', uttNames{ii}, stageKey);
     end
     fprintf('********** Finished Extracting Features **********\n\n')
     
     
     
-    % Create posteriorgrams
+    % Create posteriorgrams, and pack them with the analysis results
     fprintf('********** Preparing Posteriorgram Files **********\n')
-    ppgCmd = sprintf('%s %s %s', ppgExtractor, audioDir, postDir);
-    fprintf('Extracting PPGs:\n');
-    system(ppgCmd, '-echo');
-    fprintf('Finished PPG extraction.\n');
-    postFiles = dir(fullfile(postDir, 'split1utt', '1', 'post',...
-        'raw_bnfeat_1.*.ark'));
-    % Append the PPGs to utt struct
-    numArks = length(postFiles);
-    ark = cell(numArks, 1);
-    scp = cell(numArks, 1);
-    fprintf('Loading ark files...\n');
-    for ii = 1:numArks
-        [scp{ii}, ark{ii}] = arkread(sprintf(...
-            '%s/split1utt/1/post/raw_bnfeat_1.%d.ark', postDir, ii));
+    isPackPending = false(numFiles, 1);
+    for ii = 1:numFiles
+        if isempty(analysisKeys{ii})
+            continue; % did not pass the analysis stage
+        end
+        isPackPending(ii) = ~isStageCached(manifestDir, 'pack',...
+            uttNames{ii}, packKeys{ii}, matPaths(ii));
     end
-    fprintf('done\n');
-    numUtts = length(outputBuffer);
-    iUtt = 0;
-    for ii = 1:numArks
-        for jj = 1:size(scp{ii}, 1)
-            iUtt = iUtt + 1;
-            uttId = textscan(scp{ii}{jj, 1}, 'recording_gsb_%04d');
-            uttId = uttId{1};
-            assert(int32(iUtt) == uttId,...
-                'Utterance ID mismatch: expected %d, got %d', int32(iUtt), uttId);
-            temppost = transpose(ark{ii}(scp{ii}{jj, 6}:(scp{ii}{jj, 7}), :));
-            outputBuffer{iUtt} = fixPpgLengthMismatch(outputBuffer{iUtt}, temppost);
+    isAnalyzed = ~cellfun(@isempty, analysisKeys);
+    numPackPending = sum(isPackPending);
+    fprintf('%d of %d utterances need PPGs\n', numPackPending, numFiles);
+    if numPackPending > 0 && strcmp(ppgEngine, 'native')
+        if isempty(ppgModel)
+            ppgModel = loadPpgModel();
         end
-        if iUtt > numUtts
-            break;
+        mfccOpts = ppgModel.mfccOpts;
+        % Kaldi normalizes the features with per-speaker CMVN stats, and
+        % all the utterances of a batch belong to the same speaker, so the
+        % stats are accumulated over all the analyzed utterances
+        fprintf('Computing MFCCs and CMVN stats...\n');
+        mfccs = cell(numFiles, 1);
+        cmvnStats = 0;
+        parfor (ii = 1:numFiles, numWorkers)
+            if ~isAnalyzed(ii)
+                continue;
+            end
+            [wav, fs] = audioread(wavPaths{ii});
+            assert(fs == mfccOpts.sampleFrequency,...
+                'Expected %d Hz audio for the PPG model.',...
+                mfccOpts.sampleFrequency);
+            mfcc = computeKaldiMfcc(wav(:, 1)*32768, mfccOpts);
+            cmvnStats = cmvnStats + accCmvnStats(mfcc);
+            if isPackPending(ii)
+                mfccs{ii} = mfcc;
+            end
+        end
+        fprintf('Extracting PPGs:\n');
+        isPacked = false(numFiles, 1);
+        parfor (ii = 1:numFiles, numWorkers)
+            if ~isPackPending(ii)
+                continue;
+            end
+            post = computePpg(mfccs{ii}, ppgModel, cmvnStats,...
+                'BatchSize', ppgBatchSize);
+            utt = load(analysisPaths{ii});
+            utt = fixPpgLengthMismatch(utt, post);
+            fprintf('Saving mat file: %s\n', matPaths{ii})
+            trySaveStructFields(utt, matPaths{ii});
+            markStageCached(manifestDir, 'pack', uttNames{ii}, packKeys{ii});
+            delete(analysisPaths{ii});
+            isPacked(ii) = true;
+        end
+        fprintf('Finished PPG extraction.\n');
+        numPacked = sum(isPacked);
+        if numPacked < numPackPending
+            warning('Only got PPGs for %d of %d utterances.',...
+                numPacked, numPackPending);
+        end
+    elseif numPackPending > 0
+        % Kaldi normalizes the features with per-speaker CMVN stats, so it
+        % still sees all the analyzed utterances to keep the PPGs the same
+        % as a full run, but only the pending ones are packed. The input
+        % dir is still named 'recording' so the utterance IDs do not change
+        ppgInputDir = fullfile(tempFileDir, 'ppg', 'recording');
+        mkdir(ppgInputDir);
+        for ii = find(isAnalyzed)'
+            copyfile(wavPaths{ii}, ppgInputDir);
+        end
+        if exist(postDir, 'dir')
+            rmdir(postDir, 's'); % PPGs of a previous batch
+        end
+        mkdir(postDir);
+        numPpgJobs = min([ppgJobs, sum(isAnalyzed)]);
+        ppgCmd = sprintf('%s %s %s %d', ppgExtractor, ppgInputDir,...
+            postDir, numPpgJobs);
+        fprintf('Extracting PPGs:\n');
+        system(ppgCmd, '-echo');
+        fprintf('Finished PPG extraction.\n');
+        rmdir(fullfile(tempFileDir, 'ppg'), 's');
+        postFiles = dir(fullfile(postDir, 'split1utt', '1', 'post',...
+            'raw_bnfeat_1.*.ark'));
+        
+        % Append the PPGs to the utt struct and save, one ark at a time
+        numArks = length(postFiles);
+        numPacked = 0;
+        for ii = 1:numArks
+            fprintf('Loading ark file %d of %d...\n', ii, numArks);
+            [scp, ark] = arkread(fullfile(postDir, 'split1utt', '1',...
+                'post', sprintf('raw_bnfeat_1.%d.ark', ii)));
+            for jj = 1:size(scp, 1)
+                uttName = regexprep(scp{jj, 1}, '^recording_', '');
+                uttIdx = find(strcmp(uttNames, uttName));
+                assert(~isempty(uttIdx),...
+                    'Unexpected utterance ID %s', scp{jj, 1});
+                if ~isPackPending(uttIdx)
+                    continue; % already packed
+                end
+                temppost = transpose(ark(scp{jj, 6}:(scp{jj, 7}), :));
+                utt = load(analysisPaths{uttIdx});
+                utt = fixPpgLengthMismatch(utt, temppost);
+                fprintf('Saving mat file: %s\n', matPaths{uttIdx})
+                allFields = fieldnames(utt);
+                save(matPaths{uttIdx}, '-struct', 'utt', allFields{:});
+                markStageCached(manifestDir, 'pack', uttName,...
+                    packKeys{uttIdx});
+                delete(analysisPaths{uttIdx});
+                numPacked = numPacked + 1;
+            end
+        end
+        if numPacked < numPackPending
+            warning('Only got PPGs for %d of %d utterances.',...
+                numPacked, numPackPending);
         end
     end
     fprintf('********** Finished Generating Posteriorgram Files **********\n\n')
-
     
     
-    % Save mats
-    fprintf('********** Saving Cache Files **********\n')
+    
+    % Collect mats
+    fprintf('********** Collecting Cache Files **********\n')
     matList = {};
     numMats = 0;
     for ii = 1:numFiles
-        genericPrefix = strrep(files(ii).name, '.wav', '');
-        matFilePath = [matDir, '/', genericPrefix, '.mat'];
-        fprintf('Saving mat file: %s\n', matFilePath)
-        if isfile(matFilePath)
-            fprintf('Mat file ''%s'' already exists, skip this file\n', matFilePath)
-            continue;
-        end
-        utt = outputBuffer{ii};
-        if ~isempty(utt)
+        if ~isempty(analysisKeys{ii}) &&...
+                isStageCached(manifestDir, 'pack', uttNames{ii},...
+                packKeys{ii}, matPaths(ii))
             numMats = numMats + 1;
-            allFields = fieldnames(utt);
-            save(matFilePath, '-struct', 'utt', allFields{:});
-            matList{numMats} = matFilePath;
+            matList{numMats} = matPaths{ii};
         else
-            fprintf('Mat file ''%s'' will be empty, skip this file\n', matFilePath)
-        end  
+            fprintf('Mat file ''%s'' is not ready, skip this file\n', matPaths{ii})
+        end
     end
-    fprintf('********** Finished Generating Mat Files **********\n\n')
+    rmdir(tempFileDir, 's');
+    fprintf('********** Finished Collecting Mat Files **********\n\n')
     fprintf('********** Everything Finished **********\n')
     diary off
-end
+end
\ No newline at end of file
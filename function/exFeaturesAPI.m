@@ -7,10 +7,18 @@
 %   textPath: path to orthographic file
 %   tgPath: path to TextGrid file
 %
+%   Name-value pairs:
+%   'CacheDir': A string. If set, the analysis is looked up in this result
+%   cache first, keyed on the content of the input files, and saved there
+%   after it is computed, see 'resultCache'. Default to '', no cache
+%   'CacheSize': A number. Size limit of the cache in bytes. Default to
+%   4 GB
+%
 % Outputs:
 %   utt: utterance object
 %
-% Other m-files required: mPraat library, speechAnalysis.m
+% Other m-files required: mPraat library, speechAnalysis.m, hashContent,
+% resultCache
 %
 % Subfunctions: None
 %
@@ -18,12 +26,13 @@
 %
 % Author: Guanlong Zhao
 % Email: gzhao@tamu.edu
-% Created: 04/20/2017; Last revision: 10/10/2018
+% Created: 04/20/2017; Last revision: 10/18/2026
 % Revision log:
 %   04/20/2017: function creation, Guanlong Zhao
 %   04/21/2017: allowed not passing the text and tg file, GZ
 %   04/23/2017: fixed a bug that may cause too many opened files, GZ
 %   10/10/2018: default to use 'WORLD' vocoder, GZ
+%   10/18/2026: add the result cache, GZ
 
 % Copyright 2017 Guanlong Zhao
 % 
@@ -39,18 +48,33 @@
 % See the License for the specific language governing permissions and
 % limitations under the License.
 
-function utt = exFeaturesAPI(audioPath, textPath, tgPath)
+function utt = exFeaturesAPI(audioPath, textPath, tgPath, varargin)
+    p = inputParser;
+    addRequired(p, 'audioPath', @ischar);
+    addOptional(p, 'textPath', '', @ischar);
+    addOptional(p, 'tgPath', '', @ischar);
+    addParameter(p, 'CacheDir', '', @ischar);
+    addParameter(p, 'CacheSize', 4*2^30, @(x) isnumeric(x) && x>0);
     switch nargin
         case 1
-            textPath = '';
-            tgPath = '';
+            parse(p, audioPath);
         case 2
-            tgPath = '';
-        case 3
+            parse(p, audioPath, textPath);
         otherwise
-            error('Wrong number of inputs!');
+            parse(p, audioPath, textPath, tgPath, varargin{:});
     end
+    textPath = p.Results.textPath;
+    tgPath = p.Results.tgPath;
+    cacheDir = p.Results.CacheDir;
     assert(logical(exist(audioPath, 'file')), 'IO Error: audio file does not exist!');
+    if ~isempty(cacheDir)
+        key = resultCache('key', 'analysis',...
+            hashContent({audioPath, textPath, tgPath}), 'WORLD');
+        [utt, isHit] = resultCache('get', cacheDir, key);
+        if isHit
+            return
+        end
+    end
     [audio, fs] = audioread(audioPath);
     if exist(textPath, 'file')
         textFile = fopen(textPath);
@@ -66,4 +90,7 @@ function utt = exFeaturesAPI(audioPath, textPath, tgPath)
     end
     utt = speechAnalysis(audio, fs, 'Text', text, 'TextGrid', tg,...
         'Vocoder', 'WORLD');
+    if ~isempty(cacheDir)
+        resultCache('put', cacheDir, key, utt, p.Results.CacheSize);
+    end
 end
@@ -0,0 +1,52 @@
+% fileSignature: a cheap signature of a list of files, their path, size,
+% and modification time, one line per file, used to tell whether cached
+% results that depend on those files are stale without reading them.
+%
+% Syntax: signature = fileSignature(files)
+%
+% Inputs:
+%   files: A cell array. Each element is a path to a file.
+%
+% Outputs:
+%   signature: A string. 'path|bytes|datenum' for each file, or
+%   'path|missing' if it does not exist, one per line.
+%
+% Other m-files required: None
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, out of buildGMMmodelGSB and
+%   pairingIndex, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function signature = fileSignature(files)
+    signature = '';
+    for ii = 1:length(files)
+        info = dir(files{ii});
+        if length(info) == 1
+            signature = sprintf('%s%s|%d|%.10f\n', signature, files{ii},...
+                info.bytes, info.datenum);
+        else
+            signature = sprintf('%s%s|missing\n', signature, files{ii});
+        end
+    end
+end
@@ -0,0 +1,72 @@
+% findEqProbEdges: chop a histogram CDF into equal-probability segments.
+% For each percentile 1/numBins, 2/numBins, ..., 1-1/numBins, find the bin
+% whose CDF value is the closest (the first one if there is a tie), and
+% return the corresponding bin edges. Since the CDF is non-decreasing, the
+% search is a single linear scan instead of a numBins*numBins distance
+% matrix.
+%
+% Syntax: eqProbEdges = findEqProbEdges(bins, cdf)
+%
+% Inputs:
+%   bins: the histogram bins, 1*(numBins+1) vector
+%   cdf: the cumulative distribution function, 1*numBins vector
+%
+% Outputs:
+%   eqProbEdges: 1*(numBins+1) vector, [bins(1), edges, bins(end)]
+%
+% Other m-files required: None
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function eqProbEdges = findEqProbEdges(bins, cdf)
+    numBins = length(cdf);
+    perCt = 1/numBins:1/numBins:(1-1/numBins);
+    eqProbBins = zeros(1, length(perCt));
+
+    % kk is the last bin whose CDF does not exceed the current percentile,
+    % it only moves forward because both perCt and cdf are sorted
+    kk = 0;
+    for ii = 1:length(perCt)
+        while kk < numBins && cdf(kk+1) <= perCt(ii)
+            kk = kk + 1;
+        end
+        if kk == 0
+            eqProbBins(ii) = 1;
+            continue;
+        end
+        % First bin of the plateau that ends at kk
+        lowIdx = kk;
+        while lowIdx > 1 && cdf(lowIdx-1) == cdf(kk)
+            lowIdx = lowIdx - 1;
+        end
+        if kk < numBins && ...
+                (cdf(kk+1) - perCt(ii)) < (perCt(ii) - cdf(lowIdx))
+            eqProbBins(ii) = kk + 1;
+        else
+            eqProbBins(ii) = lowIdx;
+        end
+    end
+    eqProbEdges = [bins(1), bins(eqProbBins), bins(end)];
+end
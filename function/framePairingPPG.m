@@ -1,34 +1,88 @@
 % framePairingPPG: compute frame pairing given posteriorgram features. The
-% function will split the computation into smaller batches.
+% function will split the computation into smaller tiles, sized to fit a
+% memory budget: the source is split into batches, and the target is split
+% too if a batch against the whole target does not fit. The pairing is the
+% same for any tiling, up to rounding. Given the phone labels of the
+% frames, the search can be limited to frames of the same phone (or of a
+% neighboring phone), which cuts the number of divergences by about the
+% number of phones, see 'reportPhonePairing' for how much the pairing
+% changes. The target can be a pairing index from 'pairingIndex', whose
+% precomputed target terms are used as they are. With frame stores on both
+% sides the pairing runs out of core: only the tiles in use, the tiles
+% being read ahead, and the running minimums are in memory.
 %
-% Syntax: [mapToSrc, mapToTgt, mapToSrcCost, mapToTgtCost] = framePairingPPG(srcPost, tgtPost, splitSize, verbose)
+% Syntax: [mapToSrc, mapToTgt, mapToSrcCost, mapToTgtCost, plan] = framePairingPPG(srcPost, tgtPost, splitSize, verbose)
 %
 % Inputs:
-%   srcPost: D*T1 matrix
-%   tgtPost: D*T2 matrix
-%   splitSize: number of frames in a batch, default to 3000 frames, if the
-%   input is less than 3000 frames then run in a single batch
-%   verbose: true | false (*), display some information, defaule to false
+%   srcPost: D*T1 matrix, or a frame store from 'prepareDataGMM', which is
+%   read tile by tile
+%   tgtPost: D*T2 matrix, a frame store, or a pairing index
+%   splitSize: number of source frames in a batch, or 'auto' (*), which
+%   uses the largest batch that fits the memory budget. If the input is
+%   less than the batch size then run in a single batch
+%   verbose: true | false (*), display the tiling plan and the peak memory
+%   usage, defaule to false
+%
+%   [Optional name-value pairs]
+%   'MemoryBudget': memory in bytes that the pairing can use on top of the
+%   inputs. Default to [], half of the available memory, or 2 GB if that
+%   is unknown
+%   'SrcLabels': A vector. Phone label of each source frame, e.g., from
+%   'phones2numeric' or 'prepareDataGMM', NaN for unknown. If set, with
+%   'TgtLabels', each frame is only compared with the frames of the other
+%   side in its phone bucket. Frames whose bucket is empty on the other
+%   side are compared with all the frames. Default to [], compare all the
+%   frames
+%   'TgtLabels': A vector. Phone label of each target frame
+%   'Neighbors': 'none' (*) | 'broad' | a logical matrix. The phones that a
+%   bucket also includes: none, the phones of the same broad phonetic
+%   class (vowels, stops, fricatives, nasals, liquids and glides, with the
+%   labels of 'phones2numeric'), or neighbors(i,j) true if phone j is in
+%   the bucket of phone i. Unknown frames are in every bucket
+%   'Prefetch': true | false. Read the next tiles of the frame stores in
+%   the background ('backgroundPool') while the current tile is computed,
+%   the budget then holds one more tile of each side. Default to [], on if
+%   a side is a frame store and a background pool is available. If a
+%   background read fails, it warns once and reads the rest in the
+%   foreground
 %
 % Outputs:
-%   mapToSrc: T2*1 vector, map source to the length of target
-%   mapToTgt: T1*1 vector, map target to the length of source
-%   mapToSrcCost: T2*1 vector, the cost of mapping source to target
-%   mapToTgtCost: T1*1 vector, the cost of mapping target to source
+%   mapToSrc: T1*1 vector, the closest target frame of each source frame
+%   mapToTgt: T2*1 vector, the closest source frame of each target frame
+%   mapToSrcCost: T1*1 vector, the cost of mapToSrc
+%   mapToTgtCost: T2*1 vector, the cost of mapToTgt
+%   plan: A struct, the tiling, with 'srcTile', 'tgtTile', 'numTiles',
+%   'budgetBytes', 'estimatedBytes' (the planned working set),
+%   'peakBytes' (the measured peak resident memory above the start, NaN if
+%   not verbose or unknown), 'numBuckets', 'numDivergences' (the number of
+%   frame pairs compared), 'numFallback' (the number of frames that
+%   fell back to all the frames), and 'prefetch' (whether the tiles were
+%   read ahead to the end)
 %
-% Other m-files required: KLDiv5
+% Other m-files required: KLDiv5, traceSpan, getMemoryInfo, readFrames
 %
-% Subfunctions: None
+% Subfunctions: pairTiles, readAhead, collect, isOnDisk, readTarget,
+% readSelected, phoneBuckets, broadPhoneClass, planTiles, frameSize
 %
 % MAT-file required: None
 %
 % Author: Guanlong Zhao
 % Email: gzhao@tamu.edu
-% Created: 05/10/2018; Last revision: 04/23/2019
+% Created: 05/10/2018; Last revision: 10/18/2026
 % Revision log:
 %   05/10/2018: function creation, Guanlong Zhao
 %   10/18/2018: ported to use in GSB, GZ
 %   04/23/2019: fix docs, GZ
+%   10/18/2026: trace each split, GZ
+%   10/18/2026: choose the tiling from a memory budget, also tile the
+%   target, GZ
+%   10/18/2026: accept file-backed frame stores, GZ
+%   10/18/2026: phone-bucketed pairing, GZ
+%   10/18/2026: accept a target pairing index, GZ
+%   10/18/2026: read the tiles of frame stores ahead, visit the target
+%   tiles back and forth, GZ
+%   10/18/2026: warn when the read-ahead falls back, report it in the
+%   plan, GZ
 
 % Copyright 2018 Guanlong Zhao
 % 
@@ -44,49 +98,349 @@
 % See the License for the specific language governing permissions and
 % limitations under the License.
 
-function [mapToSrc, mapToTgt, mapToSrcCost, mapToTgtCost] = framePairingPPG(srcPost, tgtPost, splitSize, verbose)
-    if nargin < 3
-        splitSize = 3e3;
-        verbose = false;
+function [mapToSrc, mapToTgt, mapToSrcCost, mapToTgtCost, plan] = framePairingPPG(srcPost, tgtPost, splitSize, verbose, varargin)
+    if nargin < 3 || isempty(splitSize)
+        splitSize = 'auto';
     end
-    
     if nargin < 4
         verbose = false;
     end
+    p = inputParser;
+    addParameter(p, 'MemoryBudget', [], @(x) isempty(x) || x>0);
+    addParameter(p, 'SrcLabels', [], @isnumeric);
+    addParameter(p, 'TgtLabels', [], @isnumeric);
+    addParameter(p, 'Neighbors', 'none', @(x) islogical(x) ||...
+        any(strcmp(x, {'none', 'broad'})));
+    addParameter(p, 'Prefetch', [], @(x) isempty(x) || islogical(x));
+    parse(p, varargin{:});
+    budgetBytes = p.Results.MemoryBudget;
+    srcLabels = p.Results.SrcLabels;
+    tgtLabels = p.Results.TgtLabels;
+    neighbors = p.Results.Neighbors;
+    % Only frame stores are read ahead
+    isPrefetch = p.Results.Prefetch;
+    if isempty(isPrefetch)
+        isPrefetch = exist('backgroundPool', 'file') > 0;
+    end
+    isPrefetch = isPrefetch && (isOnDisk(srcPost) || isOnDisk(tgtPost));
+    if isempty(budgetBytes)
+        mem = getMemoryInfo();
+        budgetBytes = mem.availableBytes/2;
+        if isnan(budgetBytes)
+            budgetBytes = 2*2^30;
+        end
+    end
     
-    nSrcFrame = size(srcPost, 2);
-    nTgtFrame = size(tgtPost, 2);
-    numSplits = ceil(nSrcFrame/splitSize);
-    
-    mapToTgtCostTemp = zeros(nTgtFrame, numSplits);
-    mapToTgtTemp = zeros(nTgtFrame, numSplits);
+    [dim, nSrcFrame] = frameSize(srcPost);
+    [~, nTgtFrame] = frameSize(tgtPost);
+    isBucketed = ~isempty(srcLabels) || ~isempty(tgtLabels);
+    if isBucketed
+        assert(length(srcLabels) == nSrcFrame &&...
+            length(tgtLabels) == nTgtFrame,...
+            'Need one label per frame on both sides.');
+        buckets = phoneBuckets(srcLabels, tgtLabels, neighbors);
+    else
+        buckets = struct('src', {1:nSrcFrame}, 'tgt', {1:nTgtFrame});
+    end
+    numSrc = arrayfun(@(b) length(b.src), buckets);
+    numTgt = arrayfun(@(b) length(b.tgt), buckets);
+    % Tiles that fit the largest bucket fit all of them
+    plan = planTiles(max([numSrc, 0]), max([numTgt, 0]), dim,...
+        budgetBytes, splitSize, nSrcFrame + nTgtFrame, 3 + isPrefetch);
+    plan.numTiles = sum(ceil(numSrc/plan.srcTile).*...
+        ceil(numTgt/plan.tgtTile));
+    plan.numBuckets = length(buckets);
+    plan.numDivergences = sum(numSrc.*numTgt);
+    plan.numFallback = 0;
+    plan.prefetch = isPrefetch;
+    if verbose
+        fprintf(['Frame pairing: %d source x %d target frames, tiles of ',...
+            '%d x %d frames (%d tiles), estimated working set %.1f MB, ',...
+            'budget %.1f MB\n'], nSrcFrame, nTgtFrame, plan.srcTile,...
+            plan.tgtTile, plan.numTiles, plan.estimatedBytes/2^20,...
+            budgetBytes/2^20);
+        if isBucketed
+            fprintf(['Phone buckets: %d, %.3g divergences, %.1fx fewer ',...
+                'than all the pairs\n'], plan.numBuckets,...
+                plan.numDivergences,...
+                nSrcFrame*nTgtFrame/max([plan.numDivergences, 1]));
+        end
+        mem = getMemoryInfo(true);
+        state.startBytes = mem.residentBytes;
+        state.peakBytes = state.startBytes;
+        tic;
+    end
     
-    mapToSrcCost = zeros(nSrcFrame, 1);
-    mapToSrc = zeros(nSrcFrame, 1);
+    state.verbose = verbose;
+    state.isPrefetch = isPrefetch;
+    state.mapToSrcCost = inf(nSrcFrame, 1);
+    state.mapToSrc = ones(nSrcFrame, 1);
+    state.mapToTgtCost = inf(nTgtFrame, 1);
+    state.mapToTgt = ones(nTgtFrame, 1);
+    for ii = 1:length(buckets)
+        state = pairTiles(state, srcPost, tgtPost, buckets(ii).src,...
+            buckets(ii).tgt, plan, true(1, 2));
+    end
+    if isBucketed
+        % Frames whose bucket is empty on the other side fall back to the
+        % whole other side, without changing the pairing of that side
+        srcLeft = find(isinf(state.mapToSrcCost))';
+        tgtLeft = find(isinf(state.mapToTgtCost))';
+        state = pairTiles(state, srcPost, tgtPost, srcLeft, 1:nTgtFrame,...
+            plan, [true, false]);
+        state = pairTiles(state, srcPost, tgtPost, 1:nSrcFrame, tgtLeft,...
+            plan, [false, true]);
+        plan.numFallback = length(srcLeft) + length(tgtLeft);
+        plan.numDivergences = plan.numDivergences +...
+            length(srcLeft)*nTgtFrame + nSrcFrame*length(tgtLeft);
+    end
+    plan.prefetch = state.isPrefetch;
+    mapToSrc = state.mapToSrc;
+    mapToTgt = state.mapToTgt;
+    mapToSrcCost = state.mapToSrcCost;
+    mapToTgtCost = state.mapToTgtCost;
     
-    for ii = 1:numSplits
-        if verbose
-            tic;
+    if verbose
+        plan.peakBytes = state.peakBytes - state.startBytes;
+        fprintf(['Frame pairing finished in %.1f s, peak memory %.1f MB ',...
+            'above the start\n'], toc, plan.peakBytes/2^20);
+    end
+end
+
+% Pair the source frames 'srcSel' with the target frames 'tgtSel' tile by
+% tile, and update the running minimums of the sides in 'sides' ([source,
+% target]). The target tiles are visited back and forth, so that the last
+% target tile of a source tile is reused by the next one, and the next
+% tiles are read ahead while a tile is computed. Ties go to the earlier
+% frame in any order, the same as one big 'min'.
+function state = pairTiles(state, srcPost, tgtPost, srcSel, tgtSel, plan, sides)
+    if isempty(srcSel) || isempty(tgtSel)
+        return
+    end
+    srcTile = plan.srcTile;
+    tgtTile = plan.tgtTile;
+    numSrcTiles = ceil(length(srcSel)/srcTile);
+    numTgtTiles = ceil(length(tgtSel)/tgtTile);
+    srcTiles = @(ii) srcSel((1+srcTile*(ii-1)):min([srcTile*ii,...
+        length(srcSel)]));
+    tgtTiles = @(jj) tgtSel((1+tgtTile*(jj-1)):min([tgtTile*jj,...
+        length(tgtSel)]));
+    [tgtOrder, srcOrder] = ndgrid(1:numTgtTiles, 1:numSrcTiles);
+    tgtOrder(:, 2:2:end) = flipud(tgtOrder(:, 2:2:end));
+    steps = [srcOrder(:), tgtOrder(:)];
+    numSteps = size(steps, 1);
+    nextSrc = readAhead(@readSelected, srcPost, srcTiles(1),...
+        state.isPrefetch);
+    nextTgt = readAhead(@readTarget, tgtPost, tgtTiles(steps(1, 2)),...
+        state.isPrefetch);
+    for kk = 1:numSteps
+        span = traceSpan('begin', 'pair/split');
+        ii = steps(kk, 1);
+        jj = steps(kk, 2);
+        if kk == 1 || ii ~= steps(kk-1, 1)
+            [srcFrames, state] = collect(nextSrc, state);
+            srcIdx = srcTiles(ii);
+        end
+        if kk == 1 || jj ~= steps(kk-1, 2)
+            [tgt, state] = collect(nextTgt, state);
+            tgtIdx = tgtTiles(jj);
+        end
+        if kk < numSteps && steps(kk+1, 1) ~= ii
+            nextSrc = readAhead(@readSelected, srcPost,...
+                srcTiles(steps(kk+1, 1)), state.isPrefetch);
         end
-        startIdx = 1+splitSize*(ii-1);
-        endIdx = min([splitSize*ii, nSrcFrame]);
-        kld = KLDiv5(srcPost(:, startIdx:endIdx), tgtPost);
-        [mapToSrcCost(startIdx:endIdx), mapToSrc(startIdx:endIdx)] = min(kld, [], 2);
-        [currCost, currMap] = min(kld);
-        mapToTgtCostTemp(:, ii) = currCost';
-        mapToTgtTemp(:, ii) = currMap'+startIdx-1;
-        if verbose
-            toc;
+        if kk < numSteps && steps(kk+1, 2) ~= jj
+            nextTgt = readAhead(@readTarget, tgtPost,...
+                tgtTiles(steps(kk+1, 2)), state.isPrefetch);
         end
+        kld = KLDiv5(srcFrames, tgt{:});
+        if sides(1)
+            [currCost, currMap] = min(kld, [], 2);
+            currMap = tgtIdx(currMap)';
+            isBetter = currCost < state.mapToSrcCost(srcIdx) |...
+                (currCost == state.mapToSrcCost(srcIdx) &...
+                currMap < state.mapToSrc(srcIdx));
+            state.mapToSrcCost(srcIdx(isBetter)) = currCost(isBetter);
+            state.mapToSrc(srcIdx(isBetter)) = currMap(isBetter);
+        end
+        if sides(2)
+            [currCost, currMap] = min(kld, [], 1);
+            currCost = currCost';
+            currMap = srcIdx(currMap)';
+            isBetter = currCost < state.mapToTgtCost(tgtIdx) |...
+                (currCost == state.mapToTgtCost(tgtIdx) &...
+                currMap < state.mapToTgt(tgtIdx));
+            state.mapToTgtCost(tgtIdx(isBetter)) = currCost(isBetter);
+            state.mapToTgt(tgtIdx(isBetter)) = currMap(isBetter);
+        end
+        if state.verbose
+            mem = getMemoryInfo();
+            state.peakBytes = max([state.peakBytes, mem.peakBytes]);
+        end
+        traceSpan('end', span, length(srcIdx));
     end
+end
 
-    % Find the pairing
-    [mapToTgtCost, bridgeMap] = min(mapToTgtCostTemp, [], 2);
-    
-    % Linear indexing. Much more about this technique can be found in Steve
-    % Eddins' blog at http://blogs.mathworks.com/steve/2008/02/08/linear-indexing/
-    I = (1 : size(mapToTgtTemp, 1)) .';
-    J = reshape(bridgeMap, [], 1);
-    k = sub2ind(size(mapToTgtTemp), I, J);
-    mapToTgt = mapToTgtTemp(k);
-end
\ No newline at end of file
+% Start reading the frames of a store in the background, matrices are read
+% when collected
+function job = readAhead(reader, data, frames, isPrefetch)
+    job = struct('reader', reader, 'data', data, 'frames', frames,...
+        'future', [], 'errorMessage', '');
+    if isPrefetch && isOnDisk(data)
+        try
+            job.future = parfeval(backgroundPool, reader, 1, data, frames);
+        catch err
+            % Read when collected
+            job.errorMessage = err.message;
+        end
+    end
+end
+
+% Wait for the frames of 'readAhead'. If the background read fails, e.g.,
+% the pool cannot map files, read here and stop reading ahead
+function [x, state] = collect(job, state)
+    if ~isempty(job.future)
+        try
+            x = fetchOutputs(job.future);
+            return
+        catch err
+            job.errorMessage = err.message;
+        end
+    end
+    if ~isempty(job.errorMessage) && state.isPrefetch
+        warning('framePairingPPG:prefetch', ['Reading the tiles ahead ',...
+            'failed (%s), reading them in the foreground.'],...
+            job.errorMessage);
+        state.isPrefetch = false;
+    end
+    x = job.reader(job.data, job.frames);
+end
+
+% True for a frame store, or a pairing index whose stores are not loaded
+function isStore = isOnDisk(data)
+    isStore = isstruct(data) &&...
+        (~isfield(data, 'post') || isstruct(data.post));
+end
+
+% Read target frames, with the target terms of 'KLDiv5' if 'tgtPost' is a
+% pairing index
+function tgt = readTarget(tgtPost, frames)
+    if isstruct(tgtPost) && isfield(tgtPost, 'logPost')
+        tgt = {readSelected(tgtPost.post, frames),...
+            readSelected(tgtPost.logPost, frames),...
+            tgtPost.entropy(frames)};
+    else
+        tgt = {readSelected(tgtPost, frames)};
+    end
+end
+
+% Read a sorted list of frames, as one range when they are contiguous
+function x = readSelected(data, frames)
+    if isempty(frames)
+        x = readFrames(data, []);
+    elseif frames(end) - frames(1) + 1 == length(frames)
+        x = readFrames(data, frames(1), frames(end));
+    else
+        x = readFrames(data, frames);
+    end
+end
+
+% Group the frames by phone label. The source frames of a phone are
+% compared with the target frames of the same phone and of its neighbors,
+% and the neighbors are made symmetric, so that each target frame is also
+% compared with the source frames of its own bucket. Unlabeled (NaN)
+% frames are neighbors of every phone.
+function buckets = phoneBuckets(srcLabels, tgtLabels, neighbors)
+    srcLabels = srcLabels(:)';
+    tgtLabels = tgtLabels(:)';
+    phones = unique([srcLabels(~isnan(srcLabels)),...
+        tgtLabels(~isnan(tgtLabels))]);
+    numPhones = max([phones, 0]);
+    if ischar(neighbors)
+        switch neighbors
+            case 'none'
+                neighbors = eye(numPhones) > 0;
+            case 'broad'
+                group = broadPhoneClass();
+                neighbors = bsxfun(@eq, group(:), group(:)');
+        end
+    end
+    assert(size(neighbors, 1) >= numPhones &&...
+        size(neighbors, 2) >= numPhones,...
+        'The neighbor matrix must cover %d phones.', numPhones);
+    neighbors = neighbors | neighbors' | eye(size(neighbors)) > 0;
+    % NaN is the last class
+    wildcard = size(neighbors, 1) + 1;
+    neighbors(wildcard, :) = true;
+    neighbors(:, wildcard) = true;
+    srcLabels(isnan(srcLabels)) = wildcard;
+    tgtLabels(isnan(tgtLabels)) = wildcard;
+    srcClasses = unique(srcLabels);
+    buckets = struct('src', cell(1, length(srcClasses)), 'tgt', []);
+    for ii = 1:length(srcClasses)
+        buckets(ii).src = find(srcLabels == srcClasses(ii));
+        buckets(ii).tgt = find(neighbors(srcClasses(ii), tgtLabels));
+    end
+end
+
+% Broad phonetic class of each phone of 'phones2numeric': vowels, stops,
+% fricatives and affricates, nasals, liquids and glides
+function group = broadPhoneClass()
+    group = [1, 1, 1, 1, 1, 1, 2, 3, 2, 3, 1, 1, 1, 3, 2, 3, 1, 1, 3, 2,...
+        5, 4, 4, 4, 1, 1, 2, 5, 3, 3, 2, 3, 1, 1, 3, 5, 5, 3, 3];
+end
+
+% Choose the tile sizes, for a block of nSrcFrame x nTgtFrame frames out of
+% totalFrames in all. A tile of c source and t target frames needs
+% about four c*t double matrices (the KL divergence and the temporaries of
+% 'KLDiv5'), and both tiles numBuffers times (the frames, and the log with
+% its temporary, and the next tile if read ahead). Bigger tiles are
+% faster, so use the whole target if a reasonable source batch fits, else
+% square tiles.
+function plan = planTiles(nSrcFrame, nTgtFrame, dim, budgetBytes, splitSize, totalFrames, numBuffers)
+    minSrcTile = min([256, nSrcFrame]);
+    tileBytes = @(c, t) 8*(4*c.*t + numBuffers*dim*(c + t));
+    % The outputs and the running minimums
+    fixedBytes = 8*2*totalFrames;
+    cells = max([(budgetBytes - fixedBytes)/8, 0]);
+    % Largest source batch for a target tile of t frames
+    maxSrcTile = @(t) floor((cells - numBuffers*dim*t)/...
+        (4*t + numBuffers*dim));
+    if ischar(splitSize)
+        srcTile = min([maxSrcTile(nTgtFrame), nSrcFrame]);
+        if srcTile >= minSrcTile
+            tgtTile = nTgtFrame;
+        else
+            srcTile = floor((-2*numBuffers*dim +...
+                sqrt(4*numBuffers^2*dim^2 + 16*cells))/8);
+            srcTile = min([max([srcTile, 1]), nSrcFrame]);
+            tgtTile = min([maxSrcTile(srcTile), nTgtFrame]);
+        end
+    else
+        srcTile = min([splitSize, nSrcFrame]);
+        tgtTile = min([maxSrcTile(srcTile), nTgtFrame]);
+    end
+    tgtTile = max([tgtTile, 1]);
+    srcTile = max([srcTile, 1]);
+    plan.srcTile = srcTile;
+    plan.tgtTile = tgtTile;
+    plan.numTiles = ceil(nSrcFrame/srcTile)*ceil(nTgtFrame/tgtTile);
+    plan.budgetBytes = budgetBytes;
+    plan.estimatedBytes = fixedBytes + tileBytes(srcTile, tgtTile);
+    plan.peakBytes = NaN;
+    if plan.estimatedBytes > budgetBytes
+        warning(['The frame pairing tiles (%.1f MB) do not fit the ',...
+            'memory budget (%.1f MB).'], plan.estimatedBytes/2^20,...
+            budgetBytes/2^20);
+    end
+end
+
+% Size of a matrix, a frame store, or a pairing index
+function [dim, numFrames] = frameSize(data)
+    if isstruct(data)
+        dim = data.dim;
+        numFrames = data.numFrames;
+    else
+        [dim, numFrames] = size(data);
+    end
+end
@@ -1,10 +1,15 @@
 % generateW - compute the W matrix defined in Toda et al., 2007
 %
 % Syntax: W = generateW(T, D)
+%         W = generateW(T, D, segLengths)
 %
 % Inputs:
 % 	T - the length of a MFCC list
 % 	D - the dimension of the MFCC
+% 	segLengths - (optional) lengths of the segments that the T frames are
+% 	made of, e.g., the speech segments of an utt with the silence cut
+% 	out. The deltas do not cross the segments, each one has edges like a
+% 	whole list. Default to [], one segment
 %
 % Outputs:
 % 	W - a 2DT * DT matrix.
@@ -17,11 +22,14 @@
 %
 % Author: Guanlong Zhao
 % Email: gzhao@tamu.edu
-% Created: Oct. 2015; Last revision: 05/18/2017
+% Created: Oct. 2015; Last revision: 10/18/2026
 % Revision log:
 % 	11/19/2015: updated function descriptions
 % 	1/8/2016: updated function descriptions
 %   05/18/2017: fixed a bug that causes the last static frame to be empty, GZ
+%   10/18/2026: build the sparse matrix from triplets, which is linear in
+%   T instead of quadratic, GZ
+%   10/18/2026: add segments, GZ
 
 % Copyright 2015 Guanlong Zhao
 % 
@@ -37,27 +45,30 @@
 % See the License for the specific language governing permissions and
 % limitations under the License.
 
-function W = generateW(T, D)
+function W = generateW(T, D, segLengths)
 % Adapted from https://github.com/r9y9/VoiceConversion.jl/blob/master/src/trajectory_gmmmap.jl
-W = sparse([]);
-t = 1;
-w0 = zeros(D, D * T);
-w1 = zeros(D, D * T);
-w1(:, t * D + 1:(t + 1) * D) = 0.5 * eye(D);
-w0(:, (t - 1) * D + 1:t * D) = eye(D);
-W(2 * D * (t - 1) + 1:2 * D * t,:) = [w0; w1];
-for t=2:T - 1
-    w0 = zeros(D, D * T);
-    w1 = zeros(D, D * T);
-    w0(:, (t - 1) * D + 1:t * D) = eye(D);
-    w1(:, (t - 2) * D + 1:(t - 1) * D) = -0.5 * eye(D);
-    w1(:, t * D + 1:(t + 1) * D) = 0.5 * eye(D);   
-    W(2 * D * (t - 1) + 1:2 * D * t,:) = [w0; w1];
+% Frame t has D static rows, x(t), and D delta rows, 0.5*(x(t+1) - x(t-1)),
+% where the edge frames only have the neighbor that exists
+d = (1:D)';
+cols = bsxfun(@plus, d, D*(0:(T-1))); % D*T, columns of frame t
+staticRows = bsxfun(@plus, d, 2*D*(0:(T-1)));
+deltaRows = staticRows + D;
+nextRows = deltaRows(:, 1:(T-1));
+nextCols = cols(:, 2:T);
+prevRows = deltaRows(:, 2:T);
+prevCols = cols(:, 1:(T-1));
+if nargin > 2 && ~isempty(segLengths)
+    % Drop the neighbors across the end of each segment
+    isLinked = true(1, T-1);
+    segEnds = cumsum(segLengths(:)');
+    isLinked(segEnds(1:(end-1))) = false;
+    nextRows = nextRows(:, isLinked);
+    nextCols = nextCols(:, isLinked);
+    prevRows = prevRows(:, isLinked);
+    prevCols = prevCols(:, isLinked);
+end
+W = sparse([staticRows(:); nextRows(:); prevRows(:)],...
+    [cols(:); nextCols(:); prevCols(:)],...
+    [ones(D*T, 1); 0.5*ones(numel(nextRows), 1);...
+    -0.5*ones(numel(prevRows), 1)], 2*D*T, D*T);
 end
-t = T;
-w0 = zeros(D, D * T);
-w0(:, (t - 1) * D + 1:t * D) = eye(D);
-w1 = zeros(D, D * T);
-w1(:, (t - 2) * D + 1:(t - 1) * D) = -0.5 * eye(D);
-W(2 * D * (t - 1) + 1:2 * D * t,:) = [w0; w1];
-end
\ No newline at end of file
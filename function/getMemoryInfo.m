@@ -0,0 +1,82 @@
+% getMemoryInfo: get the memory usage of this Matlab process and the memory
+% available on the machine, used to size batches to a memory budget and to
+% report peak usage. On Linux the numbers come from '/proc', on Windows
+% from 'memory'; anything that is not known is NaN.
+%
+% Syntax: info = getMemoryInfo()
+%         info = getMemoryInfo(resetPeak)
+%
+% Inputs:
+%   resetPeak: true | false (*). If true, reset the peak resident memory to
+%   the current usage after reading it, Linux only.
+%
+% Outputs:
+%   info: A struct,
+%       - availableBytes: memory that can be used without swapping
+%       - residentBytes: resident memory of this process
+%       - peakBytes: peak resident memory of this process since it started
+%       or since the last reset
+%
+% Other m-files required: None
+%
+% Subfunctions: readKb
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function info = getMemoryInfo(resetPeak)
+    if nargin < 1
+        resetPeak = false;
+    end
+    info.availableBytes = NaN;
+    info.residentBytes = NaN;
+    info.peakBytes = NaN;
+    if ispc
+        [userView, systemView] = memory;
+        info.availableBytes = min([userView.MemAvailableAllArrays,...
+            systemView.PhysicalMemory.Available]);
+        info.residentBytes = userView.MemUsedMATLAB;
+        info.peakBytes = userView.MemUsedMATLAB;
+    elseif exist('/proc/self/status', 'file')
+        status = fileread('/proc/self/status');
+        info.residentBytes = readKb(status, 'VmRSS');
+        info.peakBytes = readKb(status, 'VmHWM');
+        info.availableBytes = readKb(fileread('/proc/meminfo'),...
+            'MemAvailable');
+        if resetPeak
+            fid = fopen('/proc/self/clear_refs', 'w');
+            if fid >= 0
+                fprintf(fid, '5');
+                fclose(fid);
+            end
+        end
+    end
+end
+
+% Read a 'Name:   1234 kB' line of a '/proc' file, in bytes
+function bytes = readKb(txt, name)
+    bytes = NaN;
+    value = regexp(txt, [name, ':\s*(\d+)\s*kB'], 'tokens', 'once');
+    if ~isempty(value)
+        bytes = str2double(value{1})*1024;
+    end
+end
@@ -0,0 +1,48 @@
+% getUttField: get a field of a utt struct, reading it from the mat file
+% if it was not loaded, see the 'Lazy' option of 'loadUttGSB'.
+%
+% Syntax: value = getUttField(utt, fieldName)
+%
+% Inputs:
+%   utt: A struct. A utt struct, from 'loadUttGSB'.
+%   fieldName: A string. Name of the field, e.g., 'post'.
+%
+% Outputs:
+%   value: The field value.
+%
+% Other m-files required: None
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function value = getUttField(utt, fieldName)
+    if isfield(utt, fieldName)
+        value = utt.(fieldName);
+    elseif isfield(utt, 'matFile') && ~isempty(utt.matFile)
+        value = utt.matFile.(fieldName);
+    else
+        error('The utt has no field ''%s'' and it was not loaded lazily.',...
+            fieldName);
+    end
+end
@@ -0,0 +1,157 @@
+% gmmEStep: the E-step of the EM training of a GMM, as sufficient
+% statistics. The responsibilities are computed in the log domain, so a
+% frame far from every Gaussian does not underflow to a zero posterior,
+% and the Gaussian log-densities can be evaluated in single precision,
+% which is about twice as fast on SIMD hardware. The statistics are always
+% accumulated in double. The frames are processed in blocks to bound the
+% memory of the responsibilities.
+%
+% Syntax: stats = gmmEStep(mix, x)
+%         stats = gmmEStep(mix, x, precision, blockSize)
+%
+% Inputs:
+%   mix: A struct. A netlab GMM with 'diag' or 'full' covariances.
+%   x: A N*D matrix, one frame per row.
+%   precision: 'double' (*) | 'single', precision of the log-densities.
+%   blockSize: Number of frames per block. Default to 65536.
+%
+% Outputs:
+%   stats: A struct,
+%       - N: 1*M, sum of the responsibilities of each Gaussian
+%       - F: M*D, sum of the responsibility-weighted frames
+%       - S: second-order statistics centered at the current means,
+%       sum_t post(t,m)*(x(t,:)-mu(m,:)).^2 as M*D for 'diag', the outer
+%       products as D*D*M for 'full'
+%       - logLik: log likelihood of the frames
+%       - numFrames: N
+%
+% Other m-files required: None
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function stats = gmmEStep(mix, x, precision, blockSize)
+    if nargin < 3
+        precision = 'double';
+    end
+    if nargin < 4
+        blockSize = 65536;
+    end
+    assert(ismember(precision, {'double', 'single'}),...
+        'Unknown precision ''%s''.', precision);
+    [ndata, dim] = size(x);
+    numMix = mix.ncentres;
+
+    % Work relative to the data mean, so that the expanded quadratic forms
+    % below do not lose the single precision digits to cancellation
+    origin = mean(x, 1);
+    centres = bsxfun(@minus, mix.centres, origin);
+    switch mix.covar_type
+        case 'diag'
+            invVars = 1./mix.covars;
+            logNorm = log(mix.priors) - 0.5*(dim*log(2*pi) +...
+                sum(log(mix.covars), 2)');
+            quadCoef = cast(invVars', precision);
+            linCoef = cast((centres.*invVars)', precision);
+            constCoef = cast(sum(centres.^2.*invVars, 2)', precision);
+        case 'full'
+            cholFactors = zeros(dim, dim, numMix, precision);
+            logNorm = zeros(1, numMix);
+            for j = 1:numMix
+                c = chol(mix.covars(:, :, j));
+                cholFactors(:, :, j) = c;
+                logNorm(j) = log(mix.priors(j)) - 0.5*(dim*log(2*pi) +...
+                    2*sum(log(diag(c))));
+            end
+            castCentres = cast(centres, precision);
+        otherwise
+            error('Unsupported covariance type ''%s''.', mix.covar_type);
+    end
+
+    stats.N = zeros(1, numMix);
+    stats.F = zeros(numMix, dim);
+    if strcmp(mix.covar_type, 'diag')
+        stats.S = zeros(numMix, dim);
+    else
+        stats.S = zeros(dim, dim, numMix);
+    end
+    stats.logLik = 0;
+    stats.numFrames = ndata;
+    for first = 1:blockSize:ndata
+        xc = bsxfun(@minus, x(first:min([first+blockSize-1, ndata]), :),...
+            origin);
+        xs = cast(xc, precision);
+
+        % Log-densities, Mahalanobis distances in the given precision
+        switch mix.covar_type
+            case 'diag'
+                mahal = bsxfun(@plus, (xs.^2)*quadCoef - 2*xs*linCoef,...
+                    constCoef);
+            case 'full'
+                mahal = zeros(size(xs, 1), numMix, precision);
+                for j = 1:numMix
+                    temp = bsxfun(@minus, xs, castCentres(j, :))/...
+                        cholFactors(:, :, j);
+                    mahal(:, j) = sum(temp.^2, 2);
+                end
+        end
+        logProb = bsxfun(@plus, -0.5*double(max(mahal, 0)), logNorm);
+
+        % Responsibilities by log-sum-exp
+        maxLogProb = max(logProb, [], 2);
+        logSum = maxLogProb + log(sum(exp(bsxfun(@minus, logProb,...
+            maxLogProb)), 2));
+        post = exp(bsxfun(@minus, logProb, logSum));
+        stats.logLik = stats.logLik + sum(logSum);
+
+        % Statistics in double, around the data mean for now
+        stats.N = stats.N + sum(post, 1);
+        stats.F = stats.F + post'*xc;
+        switch mix.covar_type
+            case 'diag'
+                stats.S = stats.S + post'*(xc.^2);
+            case 'full'
+                for j = 1:numMix
+                    stats.S(:, :, j) = stats.S(:, :, j) +...
+                        bsxfun(@times, xc, post(:, j))'*xc;
+                end
+        end
+    end
+
+    % Move the second-order statistics to the current means, and the
+    % first-order ones back from the data mean
+    for j = 1:numMix
+        m = centres(j, :);
+        switch mix.covar_type
+            case 'diag'
+                stats.S(j, :) = stats.S(j, :) - 2*m.*stats.F(j, :) +...
+                    stats.N(j)*m.^2;
+            case 'full'
+                cross = m'*stats.F(j, :);
+                stats.S(:, :, j) = stats.S(:, :, j) - cross - cross' +...
+                    stats.N(j)*(m'*m);
+        end
+    end
+    stats.F = stats.F + stats.N'*origin;
+end
@@ -0,0 +1,68 @@
+% gmmLogDensity: the joint log-density log(p(m)*p(x|m)) of frames and
+% given mixtures of a GMM, on a subset of the dimensions (i.e., the
+% marginal), e.g., the source half of a joint model. Only the listed
+% frame-mixture pairs are evaluated, so the cost is proportional to the
+% size of 'idx' and not to the number of mixtures.
+%
+% Syntax: logProb = gmmLogDensity(mix, x, dims, idx)
+%
+% Inputs:
+%   mix: A struct. A netlab GMM with 'diag' or 'full' covariances.
+%   x: A T*length(dims) matrix, one frame per row.
+%   dims: The dimensions of the model that 'x' has.
+%   idx: A T*K matrix, the mixtures to evaluate for each frame.
+%
+% Outputs:
+%   logProb: A T*K matrix, logProb(t,k) = log(p(idx(t,k))*p(x(t,:)|idx(t,k))).
+%
+% Other m-files required: None
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function logProb = gmmLogDensity(mix, x, dims, idx)
+    numFrames = size(x, 1);
+    numDims = length(dims);
+    logProb = zeros(size(idx));
+    for m = unique(idx(:))'
+        entries = find(idx == m);
+        frames = mod(entries - 1, numFrames) + 1;
+        diffs = bsxfun(@minus, x(frames, :), mix.centres(m, dims));
+        switch mix.covar_type
+            case 'full'
+                c = chol(mix.covars(dims, dims, m));
+                temp = diffs/c;
+                mahal = sum(temp.^2, 2);
+                logDet = 2*sum(log(diag(c)));
+            case 'diag'
+                variances = mix.covars(m, dims);
+                mahal = diffs.^2*(1./variances)';
+                logDet = sum(log(variances));
+            otherwise
+                error('Unsupported covariance type ''%s''.', mix.covar_type);
+        end
+        logProb(entries) = log(mix.priors(m)) -...
+            0.5*(numDims*log(2*pi) + logDet + mahal);
+    end
+end
@@ -0,0 +1,78 @@
+% gmmMStep: the M-step of the EM training of a GMM, from the sufficient
+% statistics of 'gmmEStep', possibly summed over several shards of the
+% data. Gives the same model as the M-step of 'gmmem' in netlab.
+%
+% Syntax: mix = gmmMStep(mix, stats)
+%         mix = gmmMStep(mix, stats, initCovars)
+%
+% Inputs:
+%   mix: A struct. The netlab GMM that the statistics were computed with.
+%   stats: A struct. Output of 'gmmEStep', or the field-wise sum of several.
+%   initCovars: The covariances to reset a collapsed covariance to, as
+%   'options(5)' of 'gmmem'. Default to [], no check.
+%
+% Outputs:
+%   mix: A struct. The updated GMM.
+%
+% Other m-files required: None
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function mix = gmmMStep(mix, stats, initCovars)
+    if nargin < 3
+        initCovars = [];
+    end
+    MIN_COVAR = eps;
+    mix.priors = stats.N./stats.numFrames;
+    newCentres = bsxfun(@rdivide, stats.F, stats.N');
+    % The statistics are centered at the old means
+    shift = newCentres - mix.centres;
+    mix.centres = newCentres;
+    switch mix.covar_type
+        case 'diag'
+            mix.covars = bsxfun(@rdivide, stats.S, stats.N') - shift.^2;
+            if ~isempty(initCovars)
+                for j = 1:mix.ncentres
+                    if min(mix.covars(j,:)) < MIN_COVAR
+                        mix.covars(j,:) = initCovars(j,:);
+                    end
+                end
+            end
+        case 'full'
+            for j = 1:mix.ncentres
+                mix.covars(:,:,j) = stats.S(:,:,j)/stats.N(j) -...
+                    shift(j,:)'*shift(j,:);
+            end
+            if ~isempty(initCovars)
+                for j = 1:mix.ncentres
+                    if min(svd(mix.covars(:,:,j))) < MIN_COVAR
+                        mix.covars(:,:,j) = initCovars(:,:,j);
+                    end
+                end
+            end
+        otherwise
+            error('Unsupported covariance type ''%s''.', mix.covar_type);
+    end
+end
@@ -0,0 +1,138 @@
+% gmmWorker: a worker process of the distributed EM, see
+% 'gmmemDistributed'. It connects to the coordinator, keeps the shards of
+% the training data that it is sent, and answers each E-step request with
+% the sufficient statistics of the requested shards under the current
+% model, until the coordinator tells it to quit. Run it in a separate
+% Matlab process, on this machine or on another one that can reach the
+% coordinator, e.g.,
+%   matlab -nodisplay -r "gmmWorker('10.0.0.1', 5100); exit"
+%
+% Syntax: gmmWorker(host, port, 'Token', token)
+%
+% Inputs:
+%   host: A string. Host name or address of the coordinator.
+%   port: An integer. Port of the coordinator. Or a string, the 'PortFile'
+%   of the coordinator, which is read once it is written, so that the
+%   coordinator can listen on any free port. The port file also has the
+%   token.
+%
+%   [Optional name-value pairs]
+%   'Token': A string, the token printed by the coordinator, see
+%   'gmmemDistributed'. Default to the one in the port file
+%   'ConnectTimeout': seconds to keep trying to connect, so that the worker
+%   can be started before the coordinator. Default to 120
+%   'FailAfter': exit this Matlab process without replying after this many
+%   E-steps, to test the recovery of the coordinator. Default to Inf
+%
+% Outputs:
+%   None
+%
+% Other m-files required: socketMessage, gmmEStep
+%
+% Subfunctions: connect
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: use the log-domain E-step of gmmEStep, GZ
+%   10/18/2026: read the port from the port file of the coordinator, GZ
+%   10/18/2026: send the token of the coordinator first, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function gmmWorker(host, port, varargin)
+    p = inputParser;
+    addRequired(p, 'host', @ischar);
+    addRequired(p, 'port', @(x) isnumeric(x) || ischar(x));
+    addParameter(p, 'Token', '', @ischar);
+    addParameter(p, 'ConnectTimeout', 120, @isnumeric);
+    addParameter(p, 'FailAfter', Inf, @isnumeric);
+    parse(p, host, port, varargin{:});
+    failAfter = p.Results.FailAfter;
+
+    [sock, token] = connect(host, port, p.Results.ConnectTimeout);
+    sockGuard = onCleanup(@() sock.close());
+    if ~isempty(p.Results.Token)
+        token = p.Results.Token;
+    end
+    socketMessage('sendToken', sock, token);
+    shards = containers.Map('KeyType', 'double', 'ValueType', 'any');
+    numSteps = 0;
+    while true
+        message = socketMessage('receive', sock);
+        switch message.command
+            case 'shard'
+                shards(message.id) = message.x;
+            case 'estep'
+                numSteps = numSteps + 1;
+                if numSteps > failAfter
+                    exit(1);
+                end
+                stats = struct('N', 0, 'F', 0, 'S', 0, 'logLik', 0,...
+                    'numFrames', 0);
+                for id = message.ids
+                    shardStat = gmmEStep(message.mix, shards(id),...
+                        message.precision);
+                    for field = fieldnames(stats)'
+                        stats.(field{1}) = stats.(field{1}) +...
+                            shardStat.(field{1});
+                    end
+                end
+                stats.ids = message.ids;
+                socketMessage('send', sock, stats);
+            case 'quit'
+                return
+            otherwise
+                error('Unknown command ''%s'' from the coordinator.',...
+                    message.command);
+        end
+    end
+end
+
+% Connect to the coordinator, and read its token if there is a port file
+function [sock, token] = connect(host, port, timeout)
+    startTime = tic;
+    token = '';
+    portFile = '';
+    if ischar(port)
+        portFile = port;
+    end
+    while true
+        try
+            if ~isempty(portFile)
+                % The port, then the token, one per line
+                lines = strsplit(strtrim(fileread(portFile)));
+                port = str2double(lines{1});
+                if isnan(port) || length(lines) < 2
+                    error('the port file %s is not written yet', portFile);
+                end
+                token = lines{2};
+            end
+            sock = java.net.Socket(host, port);
+            sock.setTcpNoDelay(true);
+            return
+        catch err
+            if toc(startTime) > timeout
+                error('Cannot connect to the coordinator at %s:%d, %s',...
+                    host, port, err.message);
+            end
+            pause(0.5);
+        end
+    end
+end
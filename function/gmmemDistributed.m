@@ -0,0 +1,314 @@
+% gmmemDistributed: the EM training of a GMM, as 'gmmem' in netlab, with
+% the E-step spread over worker processes that talk to this one over TCP.
+% The training data are split into one shard per worker and each shard is
+% sent once. In each iteration the current model is broadcast, each worker
+% returns the sufficient statistics of its shards (see 'gmmWorker'), and
+% the M-step is done here from their sum. A worker that closes its
+% connection or does not reply in time is dropped, and its shards are sent
+% to the worker with the fewest frames, which then redoes their E-step.
+% The workers can be spawned as local Matlab processes, or started by hand
+% on this or other machines and pointed at the host, port, and token
+% printed here. A worker must send the token before anything else, and
+% its replies are limited to the size of the statistics. Spawned workers
+% connect on 127.0.0.1 only.
+%
+% Syntax: [mix, options, errlog] = gmmemDistributed(mix, x, options)
+%
+% Inputs:
+%   mix, x, options: Same as 'gmmem'. Only 'diag' and 'full' covariances
+%   are supported.
+%
+%   [Optional name-value pairs]
+%   'NumWorkers': number of worker processes, default to 4
+%   'Port': port to listen on, default to 0, any free port
+%   'PortFile': A string. If set, the port and the token are written to
+%   this file once the coordinator listens, e.g., for workers started by
+%   hand, see 'gmmWorker'. Default to ''
+%   'Token': A string, shared with the workers. Default to a random one
+%   'Spawn': true (*) | false, start the workers as local Matlab processes,
+%   otherwise wait for 'NumWorkers' workers to connect
+%   'ConnectTimeout': seconds to wait for the workers to connect, default
+%   to 300
+%   'Timeout': seconds to wait for the reply of a worker before it is
+%   dropped, default to 600
+%   'Precision': 'double' (*) | 'single', precision of the log-densities
+%   in the E-step of the workers, see 'gmmEStep'
+%   'InitialError': the error of the iteration before the first one, see
+%   'gmmemLogDomain'. Default to NaN, not tested
+%
+% Outputs:
+%   mix, options, errlog: Same as 'gmmem'.
+%
+% Other m-files required: gmmWorker, socketMessage, gmmMStep, traceSpan,
+% netlab files
+%
+% Subfunctions: spawnWorker, eStep, closeWorkers
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: share the M-step with gmmemLogDomain, add 'Precision', GZ
+%   10/18/2026: add 'PortFile', GZ
+%   10/18/2026: add 'InitialError', GZ
+%   10/18/2026: listen on 127.0.0.1 for spawned workers, check the token
+%   of the workers and the size of their replies, add 'Token', GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function [mix, options, errlog] = gmmemDistributed(mix, x, options, varargin)
+    p = inputParser;
+    addParameter(p, 'NumWorkers', 4, @(x) isnumeric(x) && x>=1);
+    addParameter(p, 'Port', 0, @isnumeric);
+    addParameter(p, 'PortFile', '', @ischar);
+    addParameter(p, 'Token', '', @ischar);
+    addParameter(p, 'Spawn', true, @islogical);
+    addParameter(p, 'ConnectTimeout', 300, @isnumeric);
+    addParameter(p, 'Timeout', 600, @isnumeric);
+    addParameter(p, 'Precision', 'double', @(x) ismember(x,...
+        {'single', 'double'}));
+    addParameter(p, 'InitialError', NaN, @isnumeric);
+    parse(p, varargin{:});
+    numWorkers = p.Results.NumWorkers;
+    precision = p.Results.Precision;
+    errstring = consist(mix, 'gmm', x);
+    if ~isempty(errstring)
+        error(errstring);
+    end
+    assert(ismember(mix.covar_type, {'diag', 'full'}),...
+        'Distributed EM only supports ''diag'' and ''full'' covariances.');
+    ndata = size(x, 1);
+    numWorkers = min(numWorkers, ndata);
+
+    % Same options as gmmem
+    niters = 100;
+    if options(14)
+        niters = options(14);
+    end
+    display = options(1);
+    errlog = zeros(1, niters);
+    test = options(3) > 0.0;
+    eold = p.Results.InitialError;
+    initCovars = [];
+    if options(5) >= 1
+        if display >= 0
+            disp('check_covars is on');
+        end
+        initCovars = mix.covars;
+    end
+
+    % The statistics of all the shards, with room for the serialization
+    [numMix, dim] = size(mix.centres);
+    maxReplyBytes = 2*8*numMix*(2 + dim + dim^2) + 2^20;
+    token = p.Results.Token;
+    if isempty(token)
+        token = char(java.util.UUID.randomUUID().toString());
+    end
+
+    % Wait for the workers, spawned ones are on this machine
+    if p.Results.Spawn
+        server = java.net.ServerSocket(p.Results.Port, 50,...
+            java.net.InetAddress.getLoopbackAddress());
+    else
+        server = java.net.ServerSocket(p.Results.Port);
+    end
+    serverGuard = onCleanup(@() server.close());
+    host = char(java.net.InetAddress.getLocalHost().getHostName());
+    port = server.getLocalPort();
+    if ~isempty(p.Results.PortFile)
+        % Renamed once written, so that a worker never reads half of it
+        tempFile = [p.Results.PortFile, '.tmp'];
+        fid = fopen(tempFile, 'w');
+        fprintf(fid, '%d\n%s\n', port, token);
+        fclose(fid);
+        movefile(tempFile, p.Results.PortFile, 'f');
+    end
+    if p.Results.Spawn
+        for ii = 1:numWorkers
+            spawnWorker('127.0.0.1', port, token);
+        end
+    else
+        fprintf(['Waiting for %d EM workers, run gmmWorker(''%s'', %d, ',...
+            '''Token'', ''%s'')\n'], numWorkers, host, port, token);
+    end
+    workers = cell(1, numWorkers);
+    numConnected = 0;
+    startTime = tic;
+    while numConnected < numWorkers
+        sock = [];
+        timeLeft = p.Results.ConnectTimeout - toc(startTime);
+        if timeLeft > 0
+            server.setSoTimeout(ceil(timeLeft*1000));
+            try
+                sock = server.accept();
+            catch
+            end
+        end
+        if isempty(sock)
+            error('Only %d of %d EM workers connected in %d s.',...
+                numConnected, numWorkers, p.Results.ConnectTimeout);
+        end
+        % Nothing from a peer without the token is read as a message
+        try
+            sock.setSoTimeout(10000);
+            isValid = socketMessage('checkToken', sock, token);
+        catch
+            isValid = false;
+        end
+        if ~isValid
+            fprintf('Dropped a connection from %s without the token.\n',...
+                char(sock.getInetAddress().getHostAddress()));
+            sock.close();
+            continue
+        end
+        numConnected = numConnected + 1;
+        workers{numConnected} = sock;
+        sock.setSoTimeout(p.Results.Timeout*1000);
+        sock.setTcpNoDelay(true);
+    end
+    workersGuard = onCleanup(@() closeWorkers(workers));
+
+    % One shard per worker, owner(s) is the worker that has shard s
+    bounds = round(linspace(0, ndata, numWorkers+1));
+    shards = arrayfun(@(s) (bounds(s)+1):bounds(s+1), 1:numWorkers,...
+        'UniformOutput', false);
+    owner = 1:numWorkers;
+    for s = 1:numWorkers
+        socketMessage('send', workers{s}, struct('command', 'shard',...
+            'id', s, 'x', x(shards{s}, :)));
+    end
+    fprintf('Distributed EM on %d workers at %s:%d\n', numWorkers, host,...
+        port);
+
+    % Main loop of algorithm
+    for n = 1:niters
+        iterSpan = traceSpan('begin', 'em/iteration');
+        [stats, workers, owner] = eStep(mix, x, precision, shards,...
+            workers, owner, maxReplyBytes);
+
+        % Error value is negative log likelihood of data
+        e = -stats.logLik;
+        errlog(n) = e;
+        if display > 0
+            fprintf(1, 'Cycle %4d  Error %11.6f\n', n, e);
+        end
+        if test
+            if (~isnan(eold) && abs(e - eold) < options(3))
+                options(8) = e;
+                traceSpan('end', iterSpan, ndata);
+                return;
+            else
+                eold = e;
+            end
+        end
+
+        mix = gmmMStep(mix, stats, initCovars);
+        traceSpan('end', iterSpan, ndata);
+    end
+
+    stats = eStep(mix, x, precision, shards, workers, owner,...
+        maxReplyBytes);
+    options(8) = -stats.logLik;
+    if (display >= 0)
+        disp(maxitmess);
+    end
+end
+
+% Start a worker in a new local Matlab process
+function spawnWorker(host, port, token)
+    workerCmd = sprintf(['try, addpath(''%s'', ''%s''); ',...
+        'gmmWorker(''%s'', %d, ''Token'', ''%s''); catch err, ',...
+        'disp(getReport(err)); end; exit'], fileparts(which('gmmWorker')),...
+        fileparts(which('gmmpost')), host, port, token);
+    matlabCmd = sprintf('"%s" -nodisplay -nosplash -nodesktop -r "%s"',...
+        fullfile(matlabroot, 'bin', 'matlab'), workerCmd);
+    if ispc
+        status = system(['start "" /b ', matlabCmd]);
+    else
+        status = system([matlabCmd, ' > /dev/null 2>&1 &']);
+    end
+    assert(status == 0, 'Cannot start an EM worker.');
+end
+
+% Sum the E-step statistics of all the shards. The requests go out to all
+% the workers before any reply is read, so that they work in parallel. The
+% shards of a lost worker are moved to the live worker with the fewest
+% frames, and their E-step is requested again. A reply longer than
+% 'maxReplyBytes' is not read, and its worker is lost.
+function [stats, workers, owner] = eStep(mix, x, precision, shards, workers, owner, maxReplyBytes)
+    stats = struct('N', 0, 'F', 0, 'S', 0, 'logLik', 0, 'numFrames', 0);
+    pending = 1:length(shards);
+    while ~isempty(pending)
+        requested = unique(owner(pending));
+        for w = requested
+            ids = pending(owner(pending) == w);
+            try
+                socketMessage('send', workers{w}, struct('command',...
+                    'estep', 'mix', mix, 'precision', precision,...
+                    'ids', ids));
+            catch
+                % Found lost when reading its reply
+            end
+        end
+        lost = [];
+        for w = requested
+            try
+                reply = socketMessage('receive', workers{w},...
+                    maxReplyBytes);
+                for field = {'N', 'F', 'S', 'logLik', 'numFrames'}
+                    stats.(field{1}) = stats.(field{1}) + reply.(field{1});
+                end
+                pending = setdiff(pending, reply.ids);
+            catch err
+                fprintf('Lost EM worker %d (%s), moving its shards.\n',...
+                    w, err.message);
+                workers{w}.close();
+                workers{w} = [];
+                lost(end+1) = w; %#ok<AGROW>
+            end
+        end
+
+        % Move the shards of the lost workers
+        live = find(~cellfun(@isempty, workers));
+        if isempty(live)
+            error('All the EM workers are lost.');
+        end
+        for s = find(ismember(owner, lost))
+            liveFrames = arrayfun(@(w)...
+                sum(cellfun(@length, shards(owner == w))), live);
+            [~, idx] = min(liveFrames);
+            owner(s) = live(idx);
+            try
+                socketMessage('send', workers{owner(s)}, struct('command',...
+                    'shard', 'id', s, 'x', x(shards{s}, :)));
+            catch
+                % Found lost in the next round
+            end
+        end
+    end
+end
+
+function closeWorkers(workers)
+    for w = find(~cellfun(@isempty, workers))
+        try
+            socketMessage('send', workers{w}, struct('command', 'quit'));
+            workers{w}.close();
+        catch
+        end
+    end
+end
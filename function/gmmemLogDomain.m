@@ -0,0 +1,114 @@
+% gmmemLogDomain: the EM training of a GMM, as 'gmmem' in netlab, with the
+% log-domain E-step of 'gmmEStep'. Frames far from every Gaussian, which
+% make the responsibilities of 'gmmem' NaN, are handled, and the
+% log-densities can be evaluated in single precision for speed, while the
+% statistics stay in double. See 'reportEStepParity' to check the single
+% precision path against the double one on your data.
+%
+% Syntax: [mix, options, errlog] = gmmemLogDomain(mix, x, options)
+%
+% Inputs:
+%   mix, x, options: Same as 'gmmem'. Only 'diag' and 'full' covariances
+%   are supported.
+%
+%   [Optional name-value pairs]
+%   'Precision': 'single' (*) | 'double', precision of the log-densities
+%   'BlockSize': number of frames per block of the E-step, default to
+%   65536
+%   'InitialError': the error of the iteration before the first one, e.g.,
+%   when the EM is run a few iterations at a time, so that the convergence
+%   is also tested in the first iteration. Default to NaN, not tested
+%
+% Outputs:
+%   mix, options, errlog: Same as 'gmmem'.
+%
+% Other m-files required: gmmEStep, gmmMStep, traceSpan, netlab files
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: add 'InitialError', GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function [mix, options, errlog] = gmmemLogDomain(mix, x, options, varargin)
+    p = inputParser;
+    addParameter(p, 'Precision', 'single', @(x) ismember(x,...
+        {'single', 'double'}));
+    addParameter(p, 'BlockSize', 65536, @(x) isnumeric(x) && x>=1);
+    addParameter(p, 'InitialError', NaN, @isnumeric);
+    parse(p, varargin{:});
+    precision = p.Results.Precision;
+    blockSize = p.Results.BlockSize;
+    errstring = consist(mix, 'gmm', x);
+    if ~isempty(errstring)
+        error(errstring);
+    end
+    ndata = size(x, 1);
+
+    % Same options as gmmem
+    niters = 100;
+    if options(14)
+        niters = options(14);
+    end
+    display = options(1);
+    errlog = zeros(1, niters);
+    test = options(3) > 0.0;
+    eold = p.Results.InitialError;
+    initCovars = [];
+    if options(5) >= 1
+        if display >= 0
+            disp('check_covars is on');
+        end
+        initCovars = mix.covars;
+    end
+
+    % Main loop of algorithm
+    for n = 1:niters
+        iterSpan = traceSpan('begin', 'em/iteration');
+        stats = gmmEStep(mix, x, precision, blockSize);
+
+        % Error value is negative log likelihood of data
+        e = -stats.logLik;
+        errlog(n) = e;
+        if display > 0
+            fprintf(1, 'Cycle %4d  Error %11.6f\n', n, e);
+        end
+        if test
+            if (~isnan(eold) && abs(e - eold) < options(3))
+                options(8) = e;
+                traceSpan('end', iterSpan, ndata);
+                return;
+            else
+                eold = e;
+            end
+        end
+
+        mix = gmmMStep(mix, stats, initCovars);
+        traceSpan('end', iterSpan, ndata);
+    end
+
+    stats = gmmEStep(mix, x, precision, blockSize);
+    options(8) = -stats.logLik;
+    if (display >= 0)
+        disp(maxitmess);
+    end
+end
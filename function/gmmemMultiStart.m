@@ -0,0 +1,216 @@
+% gmmemMultiStart: the EM training of a GMM from several initializations
+% at once, keeping the best one. The EM only finds a local optimum, and
+% which one depends on the initialization, so instead of one run, 'NumStarts'
+% runs are started, each from 'gmminit' with its own random seed, and
+% trained in parallel. The runs are compared by their log-likelihood at a
+% few checkpoints (rungs), and the worse half is stopped at each of them
+% (successive halving), so that only the most promising run is trained for
+% all the iterations. A run that diverges is stopped at the next rung. With
+% one worker per start, the wall-clock time is about the same as one run.
+%
+% Syntax: [mix, options, errlog, report] = gmmemMultiStart(mix, x, options)
+%
+% Inputs:
+%   mix: A GMM from 'gmm', not initialized. Every start initializes it
+%   with 'gmminit'.
+%   x, options: Same as 'gmmem', 'options' is also passed to 'gmminit'.
+%
+%   [Optional name-value pairs]
+%   'NumStarts': number of initializations. Default to 8
+%   'NumWorkers': number of parallel workers, default to [], one per start
+%   up to the size of the local cluster. With 0, the starts are trained in
+%   this Matlab process, one after the other
+%   'ThreadsPerStart': number of computational threads of each worker,
+%   default to [], the cores divided by the workers
+%   'Seed': the seed of start 'k' is 'Seed' + k - 1. Default to 0
+%   'Precision': 'double' (*) | 'single', precision of the log-densities,
+%   see 'gmmemLogDomain'
+%   'BlockSize': number of frames per block of the E-step, default to
+%   65536
+%
+% Outputs:
+%   mix, options, errlog: Same as 'gmmem', of the best start.
+%   report: A struct,
+%       - rungs: the iteration of each checkpoint
+%       - starts: A struct array, with the 'seed', 'errlog', and number of
+%       iterations 'numIters' of each start, the rung it was stopped at
+%       'stoppedAt' (0 if it was not), and 'isBest'
+%
+% Other m-files required: gmmEStep, gmmMStep, traceSpan, netlab files
+%
+% Subfunctions: advance, score
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: preallocate the futures as a column, GZ
+%   10/18/2026: a rung with no start left to train is skipped, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function [mix, options, errlog, report] = gmmemMultiStart(mix, x, options, varargin)
+    p = inputParser;
+    addParameter(p, 'NumStarts', 8, @(x) isnumeric(x) && x>=1);
+    addParameter(p, 'NumWorkers', [],...
+        @(x) isempty(x) || (isnumeric(x) && x>=0));
+    addParameter(p, 'ThreadsPerStart', [],...
+        @(x) isempty(x) || (isnumeric(x) && x>=1));
+    addParameter(p, 'Seed', 0, @isnumeric);
+    addParameter(p, 'Precision', 'double', @(x) ismember(x,...
+        {'single', 'double'}));
+    addParameter(p, 'BlockSize', 65536, @(x) isnumeric(x) && x>=1);
+    parse(p, varargin{:});
+    numStarts = p.Results.NumStarts;
+    numWorkers = p.Results.NumWorkers;
+    numThreads = p.Results.ThreadsPerStart;
+    config.precision = p.Results.Precision;
+    config.blockSize = p.Results.BlockSize;
+    config.options = options;
+    isVerbose = options(1) > 0;
+    niters = 100;
+    if options(14)
+        niters = options(14);
+    end
+
+    % Checkpoints at niters/2, niters/4, ..., one per halving
+    numRungs = ceil(log2(numStarts));
+    rungs = unique(max(round(niters./2.^(numRungs:-1:1)), 1));
+    rungs = [rungs(rungs < niters), niters];
+    report.rungs = rungs;
+
+    if isempty(numWorkers)
+        clusterPar = parcluster('local');
+        numWorkers = min([numStarts, clusterPar.NumWorkers]);
+    end
+    numWorkers = min([numWorkers, numStarts]);
+    pool = [];
+    config.numThreads = 0;
+    if numWorkers > 0
+        pool = gcp('nocreate');
+        if isempty(pool) || pool.NumWorkers < numWorkers
+            delete(pool);
+            pool = parpool('local', numWorkers);
+        end
+        if isempty(numThreads)
+            numThreads = max([1, floor(feature('numcores')/numWorkers)]);
+        end
+        config.numThreads = numThreads;
+        % Send the data to each worker once, not with every rung
+        x = parallel.pool.Constant(x);
+    end
+
+    starts = struct('seed', num2cell(p.Results.Seed + (0:(numStarts-1))),...
+        'mix', mix, 'initCovars', [], 'errlog', [], 'numIters', 0,...
+        'isDone', false, 'stoppedAt', 0, 'isBest', false);
+    alive = 1:numStarts;
+    for rung = 1:length(rungs)
+        span = traceSpan('begin', 'em/rung');
+        todo = alive(~[starts(alive).isDone]);
+        if isempty(pool)
+            for k = todo
+                starts(k) = advance(starts(k), x, rungs(rung), config);
+            end
+        else
+            % Empty if every start left has converged
+            futures = parallel.FevalFuture.empty(0, 1);
+            for jj = 1:length(todo)
+                futures(jj, 1) = parfeval(pool, @advance, 1,...
+                    starts(todo(jj)), x, rungs(rung), config);
+            end
+            for jj = 1:length(todo)
+                starts(todo(jj)) = fetchOutputs(futures(jj));
+            end
+        end
+        traceSpan('end', span, length(todo));
+
+        % Keep the better half, by the error at this checkpoint
+        [~, order] = sort(arrayfun(@score, starts(alive)));
+        if rung < length(rungs)
+            numKept = ceil(length(alive)/2);
+            for k = alive(order((numKept+1):end))
+                starts(k).stoppedAt = rung;
+            end
+            alive = alive(order(1:numKept));
+        else
+            alive = alive(order(1));
+        end
+        if isVerbose
+            fprintf(['Rung %d, iteration %d: %d start(s) kept, best ',...
+                'error %11.6f\n'], rung, rungs(rung), length(alive),...
+                score(starts(alive(1))));
+        end
+    end
+
+    best = alive(1);
+    starts(best).isBest = true;
+    mix = starts(best).mix;
+    errlog = starts(best).errlog;
+    options(8) = errlog(end);
+    report.starts = rmfield(starts, {'mix', 'initCovars', 'isDone'});
+end
+
+% Initialize a start if it is new, and train it up to iteration 'lastIter',
+% or until it converges or diverges
+function start = advance(start, x, lastIter, config)
+    if isa(x, 'parallel.pool.Constant')
+        x = x.Value;
+    end
+    if config.numThreads > 0
+        oldThreads = maxNumCompThreads(config.numThreads);
+        threadGuard = onCleanup(@() maxNumCompThreads(oldThreads));
+    end
+    options = config.options;
+    ndata = size(x, 1);
+    if start.numIters == 0
+        rng(start.seed, 'twister');
+        start.mix = gmminit(start.mix, x, options);
+        if options(5) >= 1
+            start.initCovars = start.mix.covars;
+        end
+    end
+    mix = start.mix;
+    errlog = [start.errlog, zeros(1, lastIter - start.numIters)];
+    for n = (start.numIters+1):lastIter
+        iterSpan = traceSpan('begin', 'em/iteration');
+        stats = gmmEStep(mix, x, config.precision, config.blockSize);
+
+        % Error value is negative log likelihood of data
+        e = -stats.logLik;
+        errlog(n) = e;
+        start.numIters = n;
+        if isnan(e) || (options(3) > 0 && n > 1 &&...
+                abs(e - errlog(n-1)) < options(3))
+            start.isDone = true;
+            traceSpan('end', iterSpan, ndata);
+            break
+        end
+        mix = gmmMStep(mix, stats, start.initCovars);
+        traceSpan('end', iterSpan, ndata);
+    end
+    start.mix = mix;
+    start.errlog = errlog(1:start.numIters);
+end
+
+% The latest error of a start, a diverged one is the worst
+function value = score(start)
+    value = start.errlog(end);
+    if isnan(value)
+        value = Inf;
+    end
+end
@@ -0,0 +1,126 @@
+% initPpgStream: create the state of a streaming PPG extractor, see
+% 'streamPpg'. The streaming extractor uses the same model as 'computePpg',
+% but it only needs the audio that has arrived so far: the CMVN stats come
+% from a sliding window of past frames (optionally smoothed with prior
+% stats), and a frame is emitted as soon as 'Lookahead' future frames are
+% available. Context beyond the lookahead is filled by repeating the
+% newest frame, the same way Kaldi pads the end of an utterance.
+%
+% Syntax: state = initPpgStream(model)
+%
+% Inputs:
+%   model: A struct. Output of 'loadPpgModel'.
+%
+%   [Optional name-value pairs]
+%   'Lookahead': Number of future MFCC frames to wait for before emitting
+%   a frame. Default to the right context of the splicing, i.e., 3 for the
+%   default model
+%   'CmvnWindow': Number of past frames used for the CMVN stats, same as
+%   '--cmn-window' of Kaldi's online CMVN. Default to 600. Use Inf for
+%   running stats over the whole stream
+%   'CmvnPrior': A 2*(D+1) matrix. Stats used while the window is short,
+%   e.g., the stats of the speaker from 'accCmvnStats'. Default to [],
+%   which uses the window only
+%   'CmvnPriorFrames': The prior is weighted as if it had this many frames
+%   minus the frames in the window. Default to 200
+%
+% Outputs:
+%   state: A struct. The stream state, pass it to 'streamPpg'.
+%
+% Other m-files required: None
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: keep the CMVN window in a fixed-size ring buffer, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function state = initPpgStream(model, varargin)
+    p = inputParser;
+    addRequired(p, 'model', @isstruct);
+    addParameter(p, 'Lookahead', model.rightContext,...
+        @(x) isnumeric(x) && x>=0);
+    addParameter(p, 'CmvnWindow', 600, @(x) isnumeric(x) && x>=1);
+    addParameter(p, 'CmvnPrior', [], @isnumeric);
+    addParameter(p, 'CmvnPriorFrames', 200, @(x) isnumeric(x) && x>=0);
+    parse(p, model, varargin{:});
+
+    % Only a splicing component at the input is supported, all the other
+    % components have to work frame by frame
+    nnet = model.nnet;
+    nnetContext = 0;
+    if strcmp(nnet.components{1}.type, 'SpliceComponent')
+        nnetContext = nnet.components{1}.Context(:)';
+        nnet.components = nnet.components(2:end);
+        nnet.leftContext = 0;
+        nnet.rightContext = 0;
+        nnet.inputDim = size(model.lda, 1)*length(nnetContext);
+    end
+    assert(~any(cellfun(@(x) ~isempty(strfind(x.type, 'Splice')),...
+        nnet.components)),...
+        'Streaming only supports nnets that splice at the input layer.');
+
+    mfccOpts = model.mfccOpts;
+    if ~isfield(mfccOpts, 'sampleFrequency')
+        mfccOpts.sampleFrequency = 16000;
+    end
+    if ~isfield(mfccOpts, 'frameShift')
+        mfccOpts.frameShift = 10;
+    end
+    if ~isfield(mfccOpts, 'frameLength')
+        mfccOpts.frameLength = 25;
+    end
+    if ~isfield(mfccOpts, 'snipEdges')
+        mfccOpts.snipEdges = true;
+    end
+    fs = mfccOpts.sampleFrequency;
+
+    state.model = model;
+    state.nnet = nnet; % the nnet without its input splicing
+    state.nnetContext = nnetContext;
+    state.spliceContext = (-model.leftContext):model.rightContext;
+    state.mfccOpts = mfccOpts;
+    state.frameShift = fix(fs*0.001*mfccOpts.frameShift); % samples
+    state.frameLength = fix(fs*0.001*mfccOpts.frameLength); % samples
+    state.lookahead = p.Results.Lookahead;
+    state.cmvnWindow = p.Results.CmvnWindow;
+    state.cmvnPrior = p.Results.CmvnPrior;
+    state.cmvnPriorFrames = p.Results.CmvnPriorFrames;
+
+    % Audio received so far that is still needed, 0-based sample offset
+    state.samples = zeros(0, 1);
+    state.sampleOffset = 0;
+    state.numSamples = 0;
+    % Next MFCC frame to compute
+    state.nextMfccFrame = 0;
+    % Window of raw MFCCs, a ring buffer of 'CmvnWindow' frames, the number
+    % of frames that went through it, and their CMVN stats
+    state.cmvnStats = [];
+    state.cmvnHistory = [];
+    state.cmvnNumFrames = 0;
+    % Normalized MFCCs that are still needed, 0-based frame offset
+    state.feats = [];
+    state.featOffset = 0;
+    % Next PPG frame to emit
+    state.nextPostFrame = 0;
+    state.isFinished = false;
+end
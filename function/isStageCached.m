@@ -0,0 +1,68 @@
+% isStageCached: check whether a processing stage has already finished for
+% an item, i.e., its manifest entry records the same cache key, and all of
+% its output files exist.
+%
+% Syntax: isCached = isStageCached(manifestDir, stage, itemName, hash, outputFiles)
+%
+% Inputs:
+%   manifestDir: A string. Root dir of the stage manifests.
+%   stage: A string. Name of the stage, e.g., 'resample'.
+%   itemName: A string. Name of the item, e.g., 'gsb_0001'.
+%   hash: A string. Cache key of the item for this stage, see hashContent.
+%   outputFiles: A cell array. Paths to the output files of this stage.
+%   Default to {}.
+%
+% Outputs:
+%   isCached: true if the stage can be skipped for this item.
+%
+% Other m-files required: None
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function isCached = isStageCached(manifestDir, stage, itemName, hash, outputFiles)
+    if nargin < 5
+        outputFiles = {};
+    end
+    isCached = false;
+    entry = fullfile(manifestDir, stage, sprintf('%s.md5', itemName));
+    if ~exist(entry, 'file')
+        return
+    end
+    fid = fopen(entry, 'r');
+    if fid == -1
+        return
+    end
+    recorded = fgetl(fid);
+    fclose(fid);
+    if ~ischar(recorded) || ~strcmp(strtrim(recorded), hash)
+        return
+    end
+    for ii = 1:length(outputFiles)
+        if ~exist(outputFiles{ii}, 'file')
+            return
+        end
+    end
+    isCached = true;
+end
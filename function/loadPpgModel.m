@@ -0,0 +1,114 @@
+% loadPpgModel: load everything the in-process PPG extractor needs from a
+% Kaldi nnet2 model dir, i.e., the files used by 'make_posteriors.sh', so
+% that the model is read once and can be reused for any number of
+% utterances. See 'computePpg'.
+%
+% Syntax: model = loadPpgModel()
+%         model = loadPpgModel(modelDir)
+%
+% Inputs:
+%   modelDir: A string. The Kaldi model dir, which contains 'final.raw',
+%   'final.mat', 'splice_opts', and 'cmvn_opts'. Default to
+%   '../dependency/kaldi-posteriorgram/exp/nnet7a_960_gpu'
+%
+%   [Optional name-value pairs]
+%   'MfccConfig': A string. Path to the Kaldi MFCC config file. Default to
+%   'conf/mfcc.conf' of the PPG module
+%
+% Outputs:
+%   model: A struct,
+%       - mfccOpts: MFCC options, see 'computeKaldiMfcc'
+%       - normVars: whether CMVN normalizes the variance too
+%       - leftContext: number of past frames spliced before the LDA
+%       - rightContext: number of future frames spliced before the LDA
+%       - lda: the LDA transform from 'final.mat'
+%       - nnet: the nnet from 'final.raw', see 'readKaldiNnet2'
+%
+% Other m-files required: readKaldiMatrix, readKaldiNnet2
+%
+% Subfunctions: readKaldiOpts
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function model = loadPpgModel(modelDir, varargin)
+    ppgModuleDir = fullfile(fileparts(pwd), 'dependency/kaldi-posteriorgram');
+    if nargin < 1 || isempty(modelDir)
+        modelDir = fullfile(ppgModuleDir, 'exp/nnet7a_960_gpu');
+    end
+    p = inputParser;
+    addRequired(p, 'modelDir', @ischar);
+    addParameter(p, 'MfccConfig', fullfile(ppgModuleDir, 'conf/mfcc.conf'),...
+        @ischar);
+    parse(p, modelDir, varargin{:});
+    mfccConfig = p.Results.MfccConfig;
+
+    nnetFile = fullfile(modelDir, 'final.raw');
+    if ~exist(nnetFile, 'file')
+        error('No such file %s, the nnet2 model is not installed.', nnetFile);
+    end
+    fprintf('Loading PPG model from %s\n', modelDir);
+    model.mfccOpts = readKaldiOpts(mfccConfig);
+
+    % Same defaults as 'apply-cmvn'
+    cmvnOpts = readKaldiOpts(fullfile(modelDir, 'cmvn_opts'));
+    model.normVars = isfield(cmvnOpts, 'normVars') && cmvnOpts.normVars;
+
+    % Same defaults as 'splice-feats'
+    spliceOpts = readKaldiOpts(fullfile(modelDir, 'splice_opts'));
+    model.leftContext = 4;
+    model.rightContext = 4;
+    if isfield(spliceOpts, 'leftContext')
+        model.leftContext = spliceOpts.leftContext;
+    end
+    if isfield(spliceOpts, 'rightContext')
+        model.rightContext = spliceOpts.rightContext;
+    end
+
+    model.lda = readKaldiMatrix(fullfile(modelDir, 'final.mat'));
+    model.nnet = readKaldiNnet2(nnetFile);
+    assert(size(model.lda, 1) == model.nnet.inputDim,...
+        'The LDA output dim (%d) does not match the nnet input dim (%d).',...
+        size(model.lda, 1), model.nnet.inputDim);
+end
+
+% Read '--option-name=value' pairs, separated by white space or new lines,
+% into a struct with camel case field names, e.g., 'optionName'
+function opts = readKaldiOpts(fileName)
+    opts = struct();
+    if ~exist(fileName, 'file')
+        return
+    end
+    txt = regexprep(fileread(fileName), '#[^\n]*', ''); % comments
+    pairs = regexp(txt, '--([\w-]+)=(\S+)', 'tokens');
+    for ii = 1:length(pairs)
+        name = regexprep(pairs{ii}{1}, '-(\w)', '${upper($1)}');
+        value = pairs{ii}{2};
+        if any(strcmp(value, {'true', 'false'}))
+            opts.(name) = strcmp(value, 'true');
+        elseif ~isnan(str2double(value))
+            opts.(name) = str2double(value);
+        else
+            opts.(name) = value;
+        end
+    end
+end
@@ -1,4 +1,6 @@
-% loadUttGSB: load utt structs given paths.
+% loadUttGSB: load utt structs given paths. The files can be read in
+% parallel, and the fields that are not needed right away can be left on
+% disk and read on first use through 'getUttField'.
 %
 % Syntax: [uttContainer, invalidIdx] = loadUttGSB(uttsPath)
 %
@@ -14,12 +16,17 @@
 %   'VarList': A cell list. Default to {}. If input a non-empty value, then
 %   the function will only load the fields in this list. This option is
 %   mutually exclusive with 'RegExp'
+%   'Lazy': true | false (*). If true, each utt also gets a 'matFile' field,
+%   a read-only 'matfile' object of its mat file, so the fields that were
+%   not loaded can be read later with 'getUttField'
+%   'NumWorkers': An interger. How many parallel workers read the files.
+%   Default to 0, which reads them in serial
 %
 % Outputs:
 %   uttContainer: A struct array. Each element is a utt struct.
 %   invalidIdx: A numeric array. Indices of files that do not exist.
 %
-% Other m-files required: None
+% Other m-files required: getUttField (for lazy fields)
 %
 % Subfunctions: None
 %
@@ -27,11 +34,13 @@
 %
 % Author: Guanlong Zhao
 % Email: gzhao@tamu.edu
-% Created: 10/19/2018; Last revision: 10/23/2018
+% Created: 10/19/2018; Last revision: 10/18/2026
 % Revision log:
 %   10/19/2018: function creation, Guanlong Zhao
 %   10/23/2018: support loading a subset of the fields through either
 %   regular expression or a list of variables, GZ
+%   10/18/2026: read the files in parallel into a preallocated container,
+%   add lazy fields, GZ
 
 % Copyright 2018 Guanlong Zhao
 % 
@@ -53,6 +62,8 @@ function [uttContainer, invalidIdx] = loadUttGSB(uttsPath, varargin)
     addRequired(p, 'uttsPath', @iscell);
     addParameter(p, 'RegExp', '', @ischar);
     addParameter(p, 'VarList', {}, @iscell);
+    addParameter(p, 'Lazy', false, @islogical);
+    addParameter(p, 'NumWorkers', 0, @(x) isnumeric(x) && x>=0);
     parse(p, uttsPath, varargin{:});
     
     mode = 'normal';
@@ -68,28 +79,44 @@ function [uttContainer, invalidIdx] = loadUttGSB(uttsPath, varargin)
     end
     assert(~(isRegExp && isVarList),...
         'The regular expression and list of valid variables should not be used together.')
+    isLazy = p.Results.Lazy;
+    numWorkers = p.Results.NumWorkers;
     
     nUtt = length(uttsPath);
-    uttContainer = [];
-    invalidIdx = [];
-    
+    isValid = false(1, nUtt);
     for ii = 1:nUtt
-        fileName = uttsPath{ii};
-        if exist(fileName, 'file')
-            switch mode
-                case 'normal'
-                    tempBuffer = load(fileName);
-                case 'regexp'
-                    tempBuffer = load(fileName, '-regexp', inputRegExp);
-                case 'varlist'
-                    tempBuffer = load(fileName, varList{:});
-                otherwise
-                    error('Unknown error!');
-            end
-            uttContainer = [uttContainer; tempBuffer];
-        else
-            fprintf('Mat file ''%s'' does not exist!\n', fileName);
-            invalidIdx = [invalidIdx, ii];
+        isValid(ii) = logical(exist(uttsPath{ii}, 'file'));
+        if ~isValid(ii)
+            fprintf('Mat file ''%s'' does not exist!\n', uttsPath{ii});
+        end
+    end
+    invalidIdx = find(~isValid);
+    validPaths = uttsPath(isValid);
+    numValid = length(validPaths);
+    if numValid <= 1
+        numWorkers = 0;
+    end
+    numWorkers = min([numWorkers, numValid]);
+    
+    % Read into a cell array, then build the struct array at once
+    buffers = cell(numValid, 1);
+    parfor (ii = 1:numValid, numWorkers)
+        fileName = validPaths{ii};
+        switch mode
+            case 'normal'
+                buffers{ii} = load(fileName);
+            case 'regexp'
+                buffers{ii} = load(fileName, '-regexp', inputRegExp);
+            case 'varlist'
+                buffers{ii} = load(fileName, varList{:});
+            otherwise
+                error('Unknown error!');
+        end
+    end
+    uttContainer = vertcat(buffers{:});
+    if isLazy
+        for ii = 1:numValid
+            uttContainer(ii).matFile = matfile(validPaths{ii});
         end
     end
-end
\ No newline at end of file
+end
@@ -0,0 +1,55 @@
+% markStageCached: record in the stage manifest that a processing stage
+% has finished for an item. The entry is written to a temp file first and
+% then renamed, so that a crash never leaves a half-written entry behind.
+% Call this only after all the outputs of the stage have been saved.
+%
+% Syntax: markStageCached(manifestDir, stage, itemName, hash)
+%
+% Inputs:
+%   manifestDir: A string. Root dir of the stage manifests.
+%   stage: A string. Name of the stage, e.g., 'resample'.
+%   itemName: A string. Name of the item, e.g., 'gsb_0001'.
+%   hash: A string. Cache key of the item for this stage, see hashContent.
+%
+% Outputs:
+%   None
+%
+% Other m-files required: None
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function markStageCached(manifestDir, stage, itemName, hash)
+    stageDir = fullfile(manifestDir, stage);
+    if ~exist(stageDir, 'dir')
+        mkdir(stageDir);
+    end
+    entry = fullfile(stageDir, sprintf('%s.md5', itemName));
+    tempEntry = [entry, '.tmp'];
+    fid = fopen(tempEntry, 'w');
+    assert(fid ~= -1, 'Cannot write manifest entry %s.', tempEntry);
+    fprintf(fid, '%s\n', hash);
+    fclose(fid);
+    movefile(tempEntry, entry, 'f');
+end
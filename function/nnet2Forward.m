@@ -0,0 +1,134 @@
+% nnet2Forward: run the forward pass of a Kaldi nnet2 model loaded by
+% 'readKaldiNnet2', same as 'nnet-compute --apply-log=false'. Like Kaldi,
+% the input is padded by repeating the first and the last frames so that
+% the output has the same number of frames as the input.
+%
+% The frames are processed in batches, so that every affine layer is one
+% matrix-matrix product (multi-threaded BLAS) over a whole batch, while the
+% memory of the hidden activations stays bounded for long utterances.
+% Neighbouring batches overlap by the context of the network, so the
+% result does not depend on the batch size.
+%
+% Syntax: post = nnet2Forward(nnet, feats, batchSize)
+%
+% Inputs:
+%   nnet: A struct. Output of 'readKaldiNnet2'.
+%   feats: A D*T matrix, input features, D is the input dim of the nnet.
+%   batchSize: Number of output frames per batch. Default to 1024.
+%
+% Outputs:
+%   post: A K*T single matrix, output of the nnet, e.g., the posteriors.
+%
+% Other m-files required: None
+%
+% Subfunctions: propagate
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function post = nnet2Forward(nnet, feats, batchSize)
+    if nargin < 3
+        batchSize = 1024;
+    end
+    assert(size(feats, 1) == nnet.inputDim,...
+        'Expected %d-dim input features, got %d.', nnet.inputDim,...
+        size(feats, 1));
+    numFrames = size(feats, 2);
+    post = zeros(nnet.outputDim, numFrames, 'single');
+    if numFrames == 0
+        return
+    end
+    leftContext = nnet.leftContext;
+    rightContext = nnet.rightContext;
+    padIdx = [ones(1, leftContext), 1:numFrames,...
+        numFrames*ones(1, rightContext)];
+    feats = single(feats(:, padIdx));
+    for startIdx = 1:batchSize:numFrames
+        endIdx = min([startIdx + batchSize - 1, numFrames]);
+        x = feats(:, startIdx:(endIdx + leftContext + rightContext));
+        for cc = 1:length(nnet.components)
+            x = propagate(nnet.components{cc}, x);
+        end
+        post(:, startIdx:endIdx) = x;
+    end
+end
+
+% One component, x is D*T
+function x = propagate(comp, x)
+    switch comp.type
+        case {'SpliceComponent'}
+            constDim = 0;
+            if isfield(comp, 'ConstComponentDim')
+                constDim = comp.ConstComponentDim;
+            end
+            assert(constDim == 0,...
+                'SpliceComponent with a constant component is not supported.');
+            context = comp.Context - min(comp.Context);
+            numOutFrames = size(x, 2) - max(context);
+            frameIdx = bsxfun(@plus, context(:), 1:numOutFrames);
+            x = reshape(x(:, frameIdx), [], numOutFrames);
+        case {'AffineComponent', 'AffineComponentPreconditioned',...
+                'AffineComponentPreconditionedOnline',...
+                'FixedAffineComponent'}
+            x = bsxfun(@plus, comp.LinearParams*x, comp.BiasParams);
+        case 'PnormComponent'
+            groupSize = comp.InputDim/comp.OutputDim;
+            x = reshape(x, groupSize, comp.OutputDim, []);
+            if comp.P == 2
+                x = sqrt(sum(x.^2, 1));
+            else
+                x = sum(abs(x).^comp.P, 1).^(1/comp.P);
+            end
+            x = reshape(x, comp.OutputDim, []);
+        case 'NormalizeComponent'
+            normFloor = 2^-66; % kNormFloor in Kaldi
+            scale = max(sum(x.^2, 1)/size(x, 1), normFloor).^-0.5;
+            x = bsxfun(@times, x, scale);
+        case 'SigmoidComponent'
+            x = 1./(1 + exp(-x));
+        case 'TanhComponent'
+            x = tanh(x);
+        case 'RectifiedLinearComponent'
+            x = max(x, 0);
+        case 'SoftmaxComponent'
+            x = exp(bsxfun(@minus, x, max(x, [], 1)));
+            x = max(bsxfun(@rdivide, x, sum(x, 1)), 1e-20);
+        case 'LogSoftmaxComponent'
+            x = bsxfun(@minus, x, max(x, [], 1));
+            x = bsxfun(@minus, x, log(sum(exp(x), 1)));
+        case 'SumGroupComponent'
+            x = single(comp.groupMatrix*double(x));
+        case 'FixedScaleComponent'
+            x = bsxfun(@times, x, comp.Scales);
+        case 'FixedBiasComponent'
+            x = bsxfun(@plus, x, comp.Bias);
+        case 'PermuteComponent'
+            % Input dim i goes to output dim Reorder(i)
+            y = x;
+            y(comp.Reorder + 1, :) = x;
+            x = y;
+        case {'DropoutComponent', 'AdditiveNoiseComponent'}
+            % Only used in training
+        otherwise
+            error('Unsupported nnet2 component %s.', comp.type);
+    end
+end
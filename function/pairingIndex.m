@@ -0,0 +1,178 @@
+% pairingIndex: a persistent frame pairing index of a target speaker, so
+% that any number of source speakers can be paired with the same target
+% (see 'buildGMMmodelGSB' and 'buildGMMmodelBatchGSB') without loading and
+% preparing the target utts, or recomputing the target terms of 'KLDiv5',
+% again. The index dir holds the prepared target data, the frame
+% pairing terms as file-backed frame stores (see 'readFrames'), and the
+% signature of the utt files it was built from, so that a stale index can
+% be detected.
+%
+% Syntax: idx = pairingIndex('build', tgtSpkrFiles, indexDir)
+%         idx = pairingIndex('load', indexDir)
+%         isValid = pairingIndex('isValid', indexDir, tgtSpkrFiles)
+%
+% Inputs:
+%   command: A string,
+%       - 'build': load and prepare the target utts and write the index,
+%       overwriting the one in 'indexDir'
+%       - 'load': read an index
+%       - 'isValid': true if 'indexDir' holds a complete index that was
+%       built from 'tgtSpkrFiles' as they are now on disk
+%   tgtSpkrFiles: A cell array. Each element is a path to a mat file from
+%   the target speaker.
+%   indexDir: A string. Dir of the index, created if not exist.
+%
+%   [Optional name-value pairs]
+%   'NumWorkers': ('build') number of parallel workers that read the mat
+%   files, default to 0, read them in serial
+%   'InMemory': ('load') true | false (*), read the frame stores into
+%   memory, which is faster when many sources are paired in one session
+%
+% Outputs:
+%   idx: A struct,
+%       - files: the target utt files
+%       - dim, numFrames: size of the PPGs, non-silent frames only
+%       - mcep: the training mceps, as from 'prepareDataGMM'
+%       - lab: 1*T vector, the phone label of each frame
+%       - uttIdx, uttFrame: 1*T vectors, the utt (index in 'files') and
+%       the frame in that utt of each frame
+%       - gvs: the global variances, as from 'calculateGlobalVar'
+%       - post: the PPGs, a D*T frame store, or matrix if 'InMemory'
+%       - logPost: log(post + eps), same as 'post'
+%       - entropy: 1*T vector, dot(post, logPost) of each frame
+%   isValid: true | false
+%
+% Other m-files required: loadUttGSB, prepareDataGMM, calculateGlobalVar,
+% readFrames, tryCreateDir, fileSignature
+%
+% Subfunctions: buildIndex, loadIndex
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: use the shared fileSignature, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function varargout = pairingIndex(command, varargin)
+    switch command
+        case 'build'
+            p = inputParser;
+            addRequired(p, 'tgtSpkrFiles', @iscellstr);
+            addRequired(p, 'indexDir', @ischar);
+            addParameter(p, 'NumWorkers', 0, @(x) isnumeric(x) && x>=0);
+            parse(p, varargin{:});
+            buildIndex(p.Results.tgtSpkrFiles(:), p.Results.indexDir,...
+                p.Results.NumWorkers);
+            varargout{1} = loadIndex(p.Results.indexDir, false);
+        case 'load'
+            p = inputParser;
+            addRequired(p, 'indexDir', @ischar);
+            addParameter(p, 'InMemory', false, @islogical);
+            parse(p, varargin{:});
+            varargout{1} = loadIndex(p.Results.indexDir,...
+                p.Results.InMemory);
+        case 'isValid'
+            [indexDir, tgtSpkrFiles] = varargin{1:2};
+            isValid = false;
+            indexFile = fullfile(indexDir, 'index.mat');
+            if exist(indexFile, 'file')
+                info = load(indexFile, 'version', 'files', 'signature');
+                isValid = isfield(info, 'version') && info.version == 1 &&...
+                    isequal(info.files, tgtSpkrFiles(:)) &&...
+                    isequal(info.signature, fileSignature(tgtSpkrFiles(:)));
+            end
+            varargout{1} = isValid;
+        otherwise
+            error('Unknown pairing index command ''%s''.', command);
+    end
+end
+
+% Prepare the target utts and write the index. 'index.mat' is written
+% last, so that an interrupted build is not a valid index.
+function buildIndex(files, indexDir, numWorkers)
+    if ~exist(indexDir, 'dir')
+        tryCreateDir(indexDir);
+    end
+    indexFile = fullfile(indexDir, 'index.mat');
+    if exist(indexFile, 'file')
+        delete(indexFile);
+    end
+    utts = loadUttGSB(files, 'VarList', {'mcep', 'lab'}, 'Lazy', true,...
+        'NumWorkers', numWorkers);
+    [mcep, post, lab] = prepareDataGMM(utts,...
+        'PostStore', fullfile(indexDir, 'post.bin'));
+    gvs = calculateGlobalVar(utts, 2:25, 'mcep');
+    uttIdx = cell(1, length(utts));
+    uttFrame = cell(1, length(utts));
+    for ii = 1:length(utts)
+        uttFrame{ii} = find(~isnan(utts(ii).lab(:)'));
+        uttIdx{ii} = ii*ones(1, length(uttFrame{ii}));
+    end
+    uttIdx = [uttIdx{:}];
+    uttFrame = [uttFrame{:}];
+    clear utts
+
+    % The target terms of 'KLDiv5', computed the same way and in the same
+    % precision, a block of frames at a time
+    fid = fopen(fullfile(indexDir, 'logPost.bin'), 'w');
+    if fid < 0
+        error('Cannot write the pairing index in %s.', indexDir);
+    end
+    entropy = zeros(1, post.numFrames, post.precision);
+    blockSize = 8192;
+    for first = 1:blockSize:post.numFrames
+        last = min([first + blockSize - 1, post.numFrames]);
+        y = readFrames(post, first, last);
+        logy = log(y+eps);
+        entropy(first:last) = dot(y, logy, 1);
+        fwrite(fid, logy, post.precision);
+    end
+    fclose(fid);
+
+    version = 1;
+    signature = fileSignature(files);
+    dim = post.dim;
+    numFrames = post.numFrames;
+    precision = post.precision;
+    save(indexFile, 'version', 'files', 'signature', 'dim', 'numFrames',...
+        'precision', 'mcep', 'lab', 'uttIdx', 'uttFrame', 'gvs',...
+        'entropy', '-v7.3');
+end
+
+% Read the index, the frame stores are found next to 'index.mat', so that
+% the dir can be moved
+function idx = loadIndex(indexDir, isInMemory)
+    indexFile = fullfile(indexDir, 'index.mat');
+    if ~exist(indexFile, 'file')
+        error('No pairing index in %s, build it first.', indexDir);
+    end
+    idx = load(indexFile);
+    idx = rmfield(idx, {'version', 'signature'});
+    idx.post = struct('file', fullfile(indexDir, 'post.bin'),...
+        'precision', idx.precision, 'dim', idx.dim,...
+        'numFrames', idx.numFrames);
+    idx.logPost = idx.post;
+    idx.logPost.file = fullfile(indexDir, 'logPost.bin');
+    idx = rmfield(idx, 'precision');
+    if isInMemory
+        idx.post = readFrames(idx.post);
+        idx.logPost = readFrames(idx.logPost);
+    end
+end
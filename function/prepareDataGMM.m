@@ -1,17 +1,30 @@
 % prepareDataGMM: prepare data that are ready for the GMM training to use.
+% The non-silent frames are counted first, then written into preallocated
+% outputs, so the peak memory is about the size of the outputs. The PPGs,
+% which are by far the largest, can also be written to a file-backed frame
+% store instead, see 'readFrames'.
 %
-% Syntax: [mcep, post] = prepareDataGMM(utts)
+% Syntax: [mcep, post, lab] = prepareDataGMM(utts)
 %
 % Inputs:
-%   utts: A struct array. Containing utt structs.
+%   utts: A struct array. Containing utt structs. The PPGs can be left on
+%   disk ('Lazy' option of 'loadUttGSB'), they are then read one utt at a
+%   time
+%
+%   [Optional name-value pairs]
+%   'PostStore': A string. If set, the PPGs are written to this file, which
+%   will be overwritten, and 'post' is a frame store instead of a matrix.
+%   Default to '', keep the PPGs in memory
 %
 % Outputs:
 %   mcep: A D1*T matrix. All mceps from the utts concatenated, with mcep_0
 %   and silence removed and delta features appended
-%   post: A D2*T matrix. All mceps from the utts concatenated, with silence
-%   removed
+%   post: A D2*T matrix. All PPGs from the utts concatenated, with silence
+%   removed. Or a frame store with 'file', 'precision', 'dim', and
+%   'numFrames' if 'PostStore' is set
+%   lab: A 1*T vector. The phone label of each frame, see 'phones2numeric'
 %
-% Other m-files required: getDerivatives
+% Other m-files required: getDerivatives, tryCreateDir, getUttField
 %
 % Subfunctions: None
 %
@@ -19,9 +32,13 @@
 %
 % Author: Guanlong Zhao
 % Email: gzhao@tamu.edu
-% Created: 10/19/2018; Last revision: 10/19/2018
+% Created: 10/19/2018; Last revision: 10/18/2026
 % Revision log:
 %   10/19/2018: function creation, Guanlong Zhao
+%   10/18/2026: preallocate the outputs instead of growing them, and add
+%   the file-backed PPG store, GZ
+%   10/18/2026: read lazily loaded PPGs on demand, GZ
+%   10/18/2026: also output the phone labels, GZ
 
 % Copyright 2018 Guanlong Zhao
 % 
@@ -37,21 +54,71 @@
 % See the License for the specific language governing permissions and
 % limitations under the License.
 
-function [mcep, post] = prepareDataGMM(utts)
+function [mcep, post, lab] = prepareDataGMM(utts, varargin)
+    p = inputParser;
+    addRequired(p, 'utts', @isstruct);
+    addParameter(p, 'PostStore', '', @ischar);
+    parse(p, utts, varargin{:});
+    postStore = p.Results.PostStore;
     numUtts = length(utts);
+    
+    % Count the non-silent frames
+    numFrames = zeros(numUtts, 1);
+    for ii = 1:numUtts
+        numFrames(ii) = sum(~isnan(utts(ii).lab));
+    end
+    frameOffsets = [0; cumsum(numFrames)];
+    totalFrames = frameOffsets(end);
+    mcepDim = 0;
+    if numUtts > 0
+        mcepDim = 2*(size(utts(1).mcep, 1) - 1);
+    end
+    
     % Compile training data, validate, filter silence
-    mcep = [];
+    mcep = zeros(mcepDim, totalFrames);
+    lab = zeros(1, totalFrames);
     post = [];
+    if ~isempty(postStore)
+        storeDir = fileparts(postStore);
+        if ~isempty(storeDir) && ~exist(storeDir, 'dir')
+            tryCreateDir(storeDir);
+        end
+        fid = fopen(postStore, 'w');
+        if fid < 0
+            error('Cannot write the PPG store %s.', postStore);
+        end
+    end
     for ii = 1:numUtts
-        lab = utts(ii).lab;
-        keepIdx = ~isnan(lab);
+        keepIdx = ~isnan(utts(ii).lab);
+        frameIdx = (frameOffsets(ii)+1):frameOffsets(ii+1);
         % Get delta features for mcep
         tempmcep = getDerivatives(utts(ii).mcep(2:end, :), 1);
         % Remove silence segment
-        tempmcep = tempmcep(:, keepIdx);
-        mcep = [mcep, tempmcep];
-        % Get posteriorgram and remove silence frames accordingly
-        temppost = utts(ii).post(:, keepIdx);
-        post = [post, temppost];
+        mcep(:, frameIdx) = tempmcep(:, keepIdx);
+        lab(frameIdx) = utts(ii).lab(keepIdx);
+        % Get posteriorgram and remove silence frames accordingly, the
+        % first utt decides the size and precision
+        temppost = getUttField(utts(ii), 'post');
+        if ii == 1
+            postDim = size(temppost, 1);
+            precision = class(temppost);
+            if isempty(postStore)
+                post = zeros(postDim, totalFrames, precision);
+            end
+        end
+        if isempty(postStore)
+            post(:, frameIdx) = temppost(:, keepIdx);
+        else
+            fwrite(fid, cast(temppost(:, keepIdx), precision), precision);
+        end
+    end
+    if ~isempty(postStore)
+        fclose(fid);
+        if numUtts == 0
+            postDim = 0;
+            precision = 'double';
+        end
+        post = struct('file', postStore, 'precision', precision,...
+            'dim', postDim, 'numFrames', totalFrames);
     end
-end
\ No newline at end of file
+end
@@ -0,0 +1,187 @@
+% readArk: read matrices from a Kaldi binary ark file, or through its scp
+% index, e.g., the output of 'writeArk' or of Kaldi tools. Float ('FM'),
+% double ('DM'), and compressed ('CM', 'CM2', 'CM3') matrices are
+% supported. With an scp, only the listed (or requested) entries are read,
+% each with one seek.
+%
+% Syntax: [keys, mats] = readArk(file)
+%
+% Inputs:
+%   file: A string. Path to an ark file, or to an scp file (by the '.scp'
+%   extension).
+%
+%   [Optional name-value pairs]
+%   'Keys': A cell array of strings. With an scp, read only these entries,
+%   in this order. Default to {}, read all the entries
+%
+% Outputs:
+%   keys: A N*1 cell array. Utterance ids.
+%   mats: A N*1 cell array. Each one is a D*T single matrix, one frame per
+%   column, as 'utt.post' ('DM' matrices stay double).
+%
+% Other m-files required: None
+%
+% Subfunctions: readEntry, readToken, readInt32, decompressCM
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function [keys, mats] = readArk(file, varargin)
+    p = inputParser;
+    addRequired(p, 'file', @ischar);
+    addParameter(p, 'Keys', {}, @iscellstr);
+    parse(p, file, varargin{:});
+    wantedKeys = p.Results.Keys;
+
+    [~, ~, ext] = fileparts(file);
+    if strcmp(ext, '.scp')
+        % key ark_path:offset, one per line
+        lines = strsplit(fileread(file), '\n');
+        lines = lines(~cellfun(@isempty, strtrim(lines)));
+        tokens = regexp(lines, '^(\S+)\s+(.*):(\d+)\s*$', 'tokens', 'once');
+        assert(~any(cellfun(@isempty, tokens)),...
+            'Malformed line in %s.', file);
+        tokens = vertcat(tokens{:});
+        keys = tokens(:, 1);
+        arkFiles = tokens(:, 2);
+        offsets = str2double(tokens(:, 3));
+        if ~isempty(wantedKeys)
+            [isFound, loc] = ismember(wantedKeys(:), keys);
+            assert(all(isFound), 'Key ''%s'' is not in %s.',...
+                strjoin(wantedKeys(~isFound), ''', '''), file);
+            keys = keys(loc);
+            arkFiles = arkFiles(loc);
+            offsets = offsets(loc);
+        end
+        mats = cell(length(keys), 1);
+        % Open each ark once, and read in file order
+        [uniqArks, ~, arkIdx] = unique(arkFiles);
+        for ii = 1:length(uniqArks)
+            fid = fopen(uniqArks{ii}, 'r', 'ieee-le');
+            if fid < 0
+                error('Cannot open %s.', uniqArks{ii});
+            end
+            entries = find(arkIdx == ii);
+            [~, order] = sort(offsets(entries));
+            for jj = entries(order)'
+                fseek(fid, offsets(jj), 'bof');
+                mats{jj} = readEntry(fid, uniqArks{ii});
+            end
+            fclose(fid);
+        end
+    else
+        fid = fopen(file, 'r', 'ieee-le');
+        if fid < 0
+            error('Cannot open %s.', file);
+        end
+        fileGuard = onCleanup(@() fclose(fid));
+        keys = {};
+        mats = {};
+        while true
+            key = readToken(fid);
+            if isempty(key)
+                break
+            end
+            keys{end+1, 1} = key; %#ok<AGROW>
+            mats{end+1, 1} = readEntry(fid, file); %#ok<AGROW>
+        end
+    end
+end
+
+% Read one matrix, starting at its binary marker '\0B'
+function mat = readEntry(fid, file)
+    marker = fread(fid, 2, '*uint8')';
+    assert(isequal(marker, uint8([0, 'B'])),...
+        'Only binary entries are supported (%s, byte %d).', file,...
+        ftell(fid) - 2);
+    token = readToken(fid);
+    switch token
+        case {'FM', 'DM'}
+            numRows = readInt32(fid);
+            numCols = readInt32(fid);
+            if strcmp(token, 'FM')
+                mat = fread(fid, [numCols, numRows], '*single');
+            else
+                mat = fread(fid, [numCols, numRows], '*double');
+            end
+        case {'CM', 'CM2', 'CM3'}
+            header = fread(fid, 2, '*single');
+            dims = fread(fid, 2, 'int32');
+            numRows = dims(1);
+            numCols = dims(2);
+            minValue = header(1);
+            range = header(2);
+            switch token
+                case 'CM'
+                    colHeaders = fread(fid, [4, numCols], 'uint16=>single');
+                    bytes = fread(fid, [numRows, numCols], 'uint8=>single');
+                    mat = decompressCM(minValue, range, colHeaders, bytes)';
+                case 'CM2'
+                    values = fread(fid, [numCols, numRows], 'uint16=>single');
+                    mat = minValue + range*single(1.52590218966964e-05)*values;
+                case 'CM3'
+                    values = fread(fid, [numCols, numRows], 'uint8=>single');
+                    mat = minValue + range*single(1/255)*values;
+            end
+        otherwise
+            error('Unsupported matrix type ''%s'' in %s.', token, file);
+    end
+    if numel(mat) ~= numRows*numCols
+        error('Truncated matrix in %s.', file);
+    end
+end
+
+% Read a space-terminated token, '' at the end of the file
+function token = readToken(fid)
+    chars = blanks(0);
+    while true
+        c = fread(fid, 1, '*char');
+        if isempty(c) || c == ' '
+            break
+        end
+        chars(end+1) = c; %#ok<AGROW>
+    end
+    token = chars;
+end
+
+% A Kaldi binary int32, a size byte then the value
+function value = readInt32(fid)
+    numBytes = fread(fid, 1, 'uint8');
+    assert(numBytes == 4, 'Expected a 4-byte integer.');
+    value = fread(fid, 1, 'int32');
+end
+
+% Kaldi's one byte per value format with per-column percentiles, 'bytes'
+% is numRows*numCols
+function mat = decompressCM(minValue, range, colHeaders, bytes)
+    percentiles = minValue + range*single(1.52590218966964e-05)*colHeaders;
+    p0 = percentiles(1, :);
+    p25 = percentiles(2, :);
+    p75 = percentiles(3, :);
+    p100 = percentiles(4, :);
+    low = bsxfun(@plus, p0, bsxfun(@times, p25 - p0, bytes/64));
+    mid = bsxfun(@plus, p25, bsxfun(@times, p75 - p25, (bytes - 64)/128));
+    high = bsxfun(@plus, p75, bsxfun(@times, p100 - p75, (bytes - 192)/63));
+    mat = high;
+    mat(bytes <= 192) = mid(bytes <= 192);
+    mat(bytes <= 64) = low(bytes <= 64);
+end
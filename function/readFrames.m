@@ -0,0 +1,103 @@
+% readFrames: read a range of frames (columns) from a D*T matrix or from a
+% file-backed frame store made by 'prepareDataGMM'. Only the requested
+% frames of a store are mapped into memory, so that large PPGs can be
+% consumed tile by tile.
+%
+% Syntax: x = readFrames(data)
+%         x = readFrames(data, frames)
+%         x = readFrames(data, firstFrame, lastFrame)
+%
+% Inputs:
+%   data: A D*T matrix, or a frame store, i.e., a struct with 'file' (path
+%   to the raw column-major data), 'precision' ('double' or 'single'),
+%   'dim' (D), and 'numFrames' (T).
+%   frames: A vector. Indices of the frames to read, in any order.
+%   firstFrame: Index of the first frame. Default to 1.
+%   lastFrame: Index of the last frame. Default to the last frame.
+%
+% Outputs:
+%   x: A D*N matrix, N = lastFrame - firstFrame + 1, or the number of
+%   'frames'.
+%
+% Other m-files required: None
+%
+% Subfunctions: readIndexed
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: read a list of frames, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function x = readFrames(data, firstFrame, lastFrame)
+    isStore = isstruct(data);
+    if isStore
+        numFrames = data.numFrames;
+    else
+        numFrames = size(data, 2);
+    end
+    if nargin == 2
+        x = readIndexed(data, firstFrame, numFrames);
+        return
+    end
+    if nargin < 2
+        firstFrame = 1;
+    end
+    if nargin < 3
+        lastFrame = numFrames;
+    end
+    assert(firstFrame >= 1 && lastFrame <= numFrames,...
+        'Frames %d to %d are out of range (%d frames).', firstFrame,...
+        lastFrame, numFrames);
+
+    if ~isStore
+        x = data(:, firstFrame:lastFrame);
+    elseif lastFrame < firstFrame
+        x = zeros(data.dim, 0, data.precision);
+    else
+        % Map only the requested columns, they are contiguous in the file
+        bytesPerValue = 8;
+        if strcmp(data.precision, 'single')
+            bytesPerValue = 4;
+        end
+        numCols = lastFrame - firstFrame + 1;
+        m = memmapfile(data.file, 'Format',...
+            {data.precision, [data.dim, numCols], 'x'},...
+            'Offset', (firstFrame - 1)*data.dim*bytesPerValue, 'Repeat', 1);
+        x = m.Data.x;
+    end
+end
+
+% Read scattered frames. The store is mapped as a flat vector, so only the
+% pages that hold the requested frames are read.
+function x = readIndexed(data, frames, numFrames)
+    frames = frames(:)';
+    assert(all(frames >= 1 & frames <= numFrames),...
+        'Frames are out of range (%d frames).', numFrames);
+    if ~isstruct(data)
+        x = data(:, frames);
+    elseif isempty(frames)
+        x = zeros(data.dim, 0, data.precision);
+    else
+        m = memmapfile(data.file, 'Format', data.precision);
+        values = bsxfun(@plus, (1:data.dim)', (frames - 1)*data.dim);
+        x = reshape(m.Data(values(:)), data.dim, length(frames));
+    end
+end
@@ -0,0 +1,108 @@
+% renderConversion: compute the derived outputs of a converted utterance
+% from its converted mcep, i.e., the ones that 'voiceConversionGSB' deferred
+% because they were not requested. The spectrum is computed if any output
+% needs it, and is kept only if 'spec' is requested. The spectrum and mfcc
+% of the silent frames listed in 'deferred' are copied, not recomputed.
+%
+% Syntax: covUtt = renderConversion(covUtt, outputs)
+%
+% Inputs:
+%   covUtt: A struct. A converted utt from 'voiceConversionGSB'. Its
+%   'deferred' field lists the outputs that are not computed yet.
+%   outputs: A cell array of strings. Any of 'spec', 'mfcc', and 'wav',
+%   the outputs to compute. Outputs that are already there are skipped.
+%
+% Outputs:
+%   covUtt: the converted utt, with the requested outputs. 'deferred' is
+%   removed once nothing is deferred.
+%
+% Other m-files required: mcep2spec, straight2mfcc, speechSynthesis,
+% traceSpan
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: copy the silent frames, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function covUtt = renderConversion(covUtt, outputs)
+    if ischar(outputs)
+        outputs = {outputs};
+    end
+    if ~isfield(covUtt, 'deferred')
+        return
+    end
+    deferred = covUtt.deferred;
+    todo = intersect(outputs, deferred.outputs);
+    if isempty(todo)
+        return
+    end
+    numFrames = size(covUtt.mcep, 2);
+
+    % Cepstrum -> power spectrum, every derived output needs it
+    isCopied = false(1, numFrames);
+    isCopied(deferred.silentFrames) = true;
+    numComputed = sum(~isCopied);
+    span = traceSpan('begin', 'mcep2spec');
+    covSpec = zeros(deferred.specDim, numFrames);
+    if numComputed > 0
+        covSpec(:, ~isCopied) = mcep2spec(covUtt.mcep(:, ~isCopied),...
+            covUtt.alpha, deferred.specDim);
+    end
+    covSpec(:, isCopied) = deferred.silentSpec;
+    traceSpan('end', span, numComputed);
+    if ismember('mfcc', todo)
+        span = traceSpan('begin', 'mfcc');
+        covUtt.mfcc = zeros(deferred.mfccDim, numFrames);
+        if numComputed > 0
+            covUtt.mfcc(:, ~isCopied) = straight2mfcc(...
+                covSpec(:, ~isCopied), covUtt.fs, deferred.mfccDim);
+        end
+        covUtt.mfcc(:, isCopied) = deferred.silentMfcc;
+        traceSpan('end', span, numComputed);
+    end
+    covSpec(covSpec == 0) = eps; % safe guard
+
+    % Re-synthesis
+    covUtt.spec = covSpec;
+    if strcmp(covUtt.vocoder, 'WORLD')
+        covUtt.filter.spectrogram = covSpec;
+    end
+    clear covSpec
+    if ismember('wav', todo)
+        span = traceSpan('begin', 'synthesis');
+        covUtt = speechSynthesis(covUtt);
+        traceSpan('end', span, numFrames);
+    end
+    deferred.outputs = setdiff(deferred.outputs, todo);
+    if ismember('spec', deferred.outputs)
+        covUtt = rmfield(covUtt, 'spec');
+        if strcmp(covUtt.vocoder, 'WORLD')
+            covUtt.filter.spectrogram = [];
+        end
+    end
+    if isempty(deferred.outputs)
+        covUtt = rmfield(covUtt, 'deferred');
+    else
+        covUtt.deferred = deferred;
+    end
+end
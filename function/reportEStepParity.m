@@ -0,0 +1,125 @@
+% reportEStepParity: compare the E-step of 'gmmem' in netlab with the
+% log-domain E-step of 'gmmEStep' in double and in single precision on the
+% same model and frames, e.g., a trained model and its training set. The
+% reference is the log-domain E-step in double. For each path it reports
+% the time, the throughput, the relative difference of the log likelihood
+% and of the statistics from the reference, and the number of frames whose
+% likelihood underflows to zero, which are what make 'gmmem' diverge.
+%
+% Syntax: report = reportEStepParity(mix, x)
+%
+% Inputs:
+%   mix: A struct. A netlab GMM with 'diag' or 'full' covariances.
+%   x: A N*D matrix, one frame per row.
+%
+%   [Optional name-value pairs]
+%   'BlockSize': number of frames per block of 'gmmEStep', default to
+%   65536
+%
+% Outputs:
+%   report: A struct,
+%       - numFrames: N
+%       - path: a struct array, one per E-step ('netlab', 'double',
+%       'single'), with 'name', 'seconds', 'framesPerSec', 'logLik',
+%       'relLogLikDiff', 'maxRelDiffN', 'maxRelDiffF', and 'numUnderflow'
+%       - speedup: time of 'netlab' over time of 'single'
+%
+% Other m-files required: gmmEStep, netlab files
+%
+% Subfunctions: netlabEStep, relDiff
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function report = reportEStepParity(mix, x, varargin)
+    p = inputParser;
+    addRequired(p, 'mix', @isstruct);
+    addRequired(p, 'x', @isnumeric);
+    addParameter(p, 'BlockSize', 65536, @(x) isnumeric(x) && x>=1);
+    parse(p, mix, x, varargin{:});
+    blockSize = p.Results.BlockSize;
+    numFrames = size(x, 1);
+
+    names = {'netlab', 'double', 'single'};
+    stats = cell(1, 3);
+    seconds = zeros(1, 3);
+    numUnderflow = zeros(1, 3);
+    startTime = tic;
+    [stats{1}, numUnderflow(1)] = netlabEStep(mix, x);
+    seconds(1) = toc(startTime);
+    startTime = tic;
+    stats{2} = gmmEStep(mix, x, 'double', blockSize);
+    seconds(2) = toc(startTime);
+    startTime = tic;
+    stats{3} = gmmEStep(mix, x, 'single', blockSize);
+    seconds(3) = toc(startTime);
+
+    report.numFrames = numFrames;
+    report.path = struct('name', names, 'seconds', num2cell(seconds),...
+        'framesPerSec', num2cell(numFrames./seconds), 'logLik', [],...
+        'relLogLikDiff', [], 'maxRelDiffN', [], 'maxRelDiffF', [],...
+        'numUnderflow', num2cell(numUnderflow));
+    fprintf('%-8s %10s %12s %16s %12s %12s %12s %10s\n', 'E-step',...
+        'Time (s)', 'Frames/s', 'Log lik', 'Rel diff', 'Max diff N',...
+        'Max diff F', 'Underflow');
+    for ii = 1:3
+        report.path(ii).logLik = stats{ii}.logLik;
+        report.path(ii).relLogLikDiff = relDiff(stats{ii}.logLik,...
+            stats{2}.logLik);
+        report.path(ii).maxRelDiffN = relDiff(stats{ii}.N, stats{2}.N);
+        report.path(ii).maxRelDiffF = relDiff(stats{ii}.F, stats{2}.F);
+        fprintf('%-8s %10.3f %12.1f %16.6f %12.3g %12.3g %12.3g %10d\n',...
+            names{ii}, seconds(ii), report.path(ii).framesPerSec,...
+            report.path(ii).logLik, report.path(ii).relLogLikDiff,...
+            report.path(ii).maxRelDiffN, report.path(ii).maxRelDiffF,...
+            numUnderflow(ii));
+    end
+    report.speedup = seconds(1)/seconds(3);
+    fprintf('Single precision log-domain E-step is %.2fx the netlab one.\n',...
+        report.speedup);
+end
+
+% The E-step of gmmem, as statistics
+function [stats, numUnderflow] = netlabEStep(mix, x)
+    [post, act] = gmmpost(mix, x);
+    prob = act*(mix.priors)';
+    numUnderflow = sum(prob == 0);
+    stats.N = sum(post, 1);
+    stats.F = post'*x;
+    stats.logLik = sum(log(prob + eps));
+    switch mix.covar_type
+        case 'diag'
+            for j = 1:mix.ncentres
+                diffs = bsxfun(@minus, x, mix.centres(j,:));
+                stats.S(j,:) = post(:,j)'*diffs.^2;
+            end
+        case 'full'
+            for j = 1:mix.ncentres
+                diffs = bsxfun(@minus, x, mix.centres(j,:));
+                stats.S(:,:,j) = bsxfun(@times, diffs, post(:,j))'*diffs;
+            end
+    end
+end
+
+function d = relDiff(a, b)
+    d = max(abs(a(:) - b(:))./max(abs(b(:)), eps));
+end
@@ -0,0 +1,112 @@
+% reportGaussianSelection: measure the accuracy/speed trade-off of the
+% Gaussian selection of 'selectGaussians' in the spectral conversion. The
+% utterance is converted with all the mixtures, then with only the top k
+% mixtures of each frame for each given k. For each k it reports the time
+% of the spectral solve, the speedup over all the mixtures, and the
+% mel-cepstral distortion of the converted mcep from the one with all the
+% mixtures on the non-silent frames.
+%
+% Syntax: report = reportGaussianSelection(utt, gmmMdl, ks)
+%
+% Inputs:
+%   utt: A struct. The source utterance, as in 'voiceConversionGSB'.
+%   gmmMdl: A struct. The joint GMM model, as in 'voiceConversionGSB'.
+%   ks: A vector. The values of k to try, e.g., [1, 2, 4, 8].
+%
+%   [Optional name-value pairs]
+%   'SpecCov': 'MLGV' (*) | 'MMSE' | 'MLPG'
+%
+% Outputs:
+%   report: A struct,
+%       - numFrames: number of frames of the utterance
+%       - numMixtures: number of mixtures of the model
+%       - baseSeconds: time of the solve with all the mixtures
+%       - k: a struct array, one per k, with 'k', 'seconds', 'speedup', and
+%       'mcd' (dB)
+%
+% Other m-files required: spectralMapping_MLTrajGV, spectralMapping_MMSE,
+% spectralMapping_MLPG, static2dynamic
+%
+% Subfunctions: solve
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function report = reportGaussianSelection(utt, gmmMdl, ks, varargin)
+    p = inputParser;
+    addRequired(p, 'utt', @isstruct);
+    addRequired(p, 'gmmMdl', @isstruct);
+    addRequired(p, 'ks', @(x) isnumeric(x) && all(x>=1));
+    addParameter(p, 'SpecCov', 'MLGV', @(x) ismember(x,...
+        {'MLGV', 'MLPG', 'MMSE'}));
+    parse(p, utt, gmmMdl, ks, varargin{:});
+    specCov = p.Results.SpecCov;
+
+    % Same input as voiceConversionGSB
+    mcepDim = size(utt.mcep, 1);
+    testMcep = transpose(static2dynamic(utt.mcep));
+    testMcep = testMcep(:, [2:mcepDim, (mcepDim+2):2*mcepDim]);
+    nonSilentFrames = find(~isnan(utt.lab));
+
+    startTime = tic;
+    baseMcep = solve(testMcep, gmmMdl, nonSilentFrames, specCov, []);
+    baseSeconds = toc(startTime);
+
+    report.numFrames = size(testMcep, 1);
+    report.numMixtures = gmmMdl.mix.ncentres;
+    report.baseSeconds = baseSeconds;
+    report.k = struct('k', num2cell(ks(:)'), 'seconds', [], 'speedup', [],...
+        'mcd', []);
+    fprintf('%d frames, %d mixtures, %s: %.3f s with all the mixtures\n',...
+        report.numFrames, report.numMixtures, specCov, baseSeconds);
+    fprintf('%6s %10s %10s %10s\n', 'k', 'Time (s)', 'Speedup', 'MCD (dB)');
+    for ii = 1:length(ks)
+        startTime = tic;
+        estMcep = solve(testMcep, gmmMdl, nonSilentFrames, specCov, ks(ii));
+        report.k(ii).seconds = toc(startTime);
+        report.k(ii).speedup = baseSeconds/report.k(ii).seconds;
+        % Static dimensions only, c0 is not converted
+        diffs = estMcep(1:(mcepDim-1), nonSilentFrames) -...
+            baseMcep(1:(mcepDim-1), nonSilentFrames);
+        report.k(ii).mcd = mean((10/log(10))*sqrt(2*sum(diffs.^2, 1)));
+        fprintf('%6d %10.3f %10.2f %10.4f\n', ks(ii), report.k(ii).seconds,...
+            report.k(ii).speedup, report.k(ii).mcd);
+    end
+end
+
+function estMcep = solve(testMcep, gmmMdl, nonSilentFrames, specCov, topK)
+    cache = [];
+    if isfield(gmmMdl, 'cache')
+        cache = gmmMdl.cache;
+    end
+    switch specCov
+        case 'MLGV'
+            estMcep = spectralMapping_MLTrajGV(testMcep, gmmMdl.mix,...
+                gmmMdl.targetGVs, nonSilentFrames, cache, topK);
+        case 'MMSE'
+            estMcep = spectralMapping_MMSE(testMcep, gmmMdl.mix, cache,...
+                topK);
+        case 'MLPG'
+            estMcep = spectralMapping_MLPG(testMcep, gmmMdl.mix, cache,...
+                topK);
+    end
+end
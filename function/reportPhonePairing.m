@@ -0,0 +1,102 @@
+% reportPhonePairing: compare the phone-bucketed frame pairing of
+% 'framePairingPPG' with the exhaustive one on the same frames, e.g., the
+% prepared training data of two speakers. For each pairing it reports the
+% time and the number of divergences computed, and for the bucketed ones
+% how many pairs differ from the exhaustive result and how much larger
+% their divergence is.
+%
+% Syntax: report = reportPhonePairing(srcPost, tgtPost, srcLab, tgtLab)
+%
+% Inputs:
+%   srcPost: D*T1 matrix, or a frame store, see 'framePairingPPG'
+%   tgtPost: D*T2 matrix, or a frame store
+%   srcLab: A vector. Phone label of each source frame
+%   tgtLab: A vector. Phone label of each target frame
+%
+%   [Optional name-value pairs]
+%   'MemoryBudget': same as 'framePairingPPG'
+%
+% Outputs:
+%   report: A struct,
+%       - numSrcFrames, numTgtFrames: T1 and T2
+%       - path: a struct array, one per pairing ('exhaustive', 'exact',
+%       'broad'), with 'name', 'seconds', 'numDivergences', 'reduction'
+%       (exhaustive divergences over these), 'numDiffSrc' and 'numDiffTgt'
+%       (the pairs that differ from the exhaustive result), and
+%       'meanExtraCost' (mean increase of the divergence of the paired
+%       frames over both sides)
+%
+% Other m-files required: framePairingPPG
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function report = reportPhonePairing(srcPost, tgtPost, srcLab, tgtLab, varargin)
+    p = inputParser;
+    addRequired(p, 'srcLab', @isnumeric);
+    addRequired(p, 'tgtLab', @isnumeric);
+    addParameter(p, 'MemoryBudget', [], @(x) isempty(x) || x>0);
+    parse(p, srcLab, tgtLab, varargin{:});
+    budgetArgs = {'MemoryBudget', p.Results.MemoryBudget};
+
+    names = {'exhaustive', 'exact', 'broad'};
+    args = {{}, {'SrcLabels', srcLab, 'TgtLabels', tgtLab,...
+        'Neighbors', 'none'}, {'SrcLabels', srcLab, 'TgtLabels', tgtLab,...
+        'Neighbors', 'broad'}};
+    report.path = struct('name', names, 'seconds', [],...
+        'numDivergences', [], 'reduction', [], 'numDiffSrc', [],...
+        'numDiffTgt', [], 'meanExtraCost', []);
+    for ii = 1:length(names)
+        startTime = tic;
+        [mapToSrc, mapToTgt, srcCost, tgtCost, plan] = framePairingPPG(...
+            srcPost, tgtPost, 'auto', false, budgetArgs{:}, args{ii}{:});
+        report.path(ii).seconds = toc(startTime);
+        report.path(ii).numDivergences = plan.numDivergences;
+        if ii == 1
+            baseToSrc = mapToSrc;
+            baseToTgt = mapToTgt;
+            baseCost = [srcCost; tgtCost];
+            report.numSrcFrames = length(mapToSrc);
+            report.numTgtFrames = length(mapToTgt);
+        end
+        report.path(ii).reduction = report.path(1).numDivergences/...
+            max([plan.numDivergences, 1]);
+        report.path(ii).numDiffSrc = sum(mapToSrc ~= baseToSrc);
+        report.path(ii).numDiffTgt = sum(mapToTgt ~= baseToTgt);
+        report.path(ii).meanExtraCost = mean([srcCost; tgtCost] - baseCost);
+    end
+
+    fprintf('%d source x %d target frames\n', report.numSrcFrames,...
+        report.numTgtFrames);
+    fprintf('%-10s %10s %14s %10s %12s %12s %14s\n', 'Pairing',...
+        'Time (s)', 'Divergences', 'Fewer', 'Diff (src)', 'Diff (tgt)',...
+        'Extra cost');
+    for ii = 1:length(names)
+        fprintf('%-10s %10.3f %14.4g %9.1fx %12d %12d %14.4g\n',...
+            names{ii}, report.path(ii).seconds,...
+            report.path(ii).numDivergences, report.path(ii).reduction,...
+            report.path(ii).numDiffSrc, report.path(ii).numDiffTgt,...
+            report.path(ii).meanExtraCost);
+    end
+end
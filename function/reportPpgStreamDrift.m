@@ -0,0 +1,150 @@
+% reportPpgStreamDrift: measure how far the streaming PPGs ('streamPpg')
+% drift from the batch PPGs of the same utterances. The reference is
+% either given (e.g., the 'post' field of the mat files from 'dataPrep'
+% with the 'kaldi' engine) or computed by 'computePpg' with the CMVN stats
+% of all the utterances, which is what the Kaldi pipeline does. The audio
+% is pushed into the stream in chunks of 'ChunkSize' samples, like a live
+% service would do.
+%
+% Syntax: report = reportPpgStreamDrift(wavList, model)
+%
+% Inputs:
+%   wavList: A cell array. Each element is a path to a 16KHz wav file, all
+%   from the same speaker.
+%   model: A struct. Output of 'loadPpgModel'.
+%
+%   [Optional name-value pairs]
+%   'Reference': A cell array. Each element is the K*T batch PPG of the
+%   corresponding wav file. Default to {}, which computes the reference
+%   with 'computePpg'
+%   'ChunkSize': Number of samples per chunk. Default to 160 (10 ms)
+%   Any other name-value pairs are passed to 'initPpgStream', e.g.,
+%   'Lookahead' and 'CmvnWindow'
+%
+% Outputs:
+%   report: A struct,
+%       - utt: a struct array, one per utterance, with 'numFrames',
+%       'meanAbsDiff', 'maxAbsDiff', 'meanSymKL', and 'argmaxAgreement',
+%       the fraction of frames whose most likely senone is the same
+%       - meanAbsDiff, maxAbsDiff, meanSymKL, argmaxAgreement: the same
+%       measures over all the frames
+%       - latencyMs: the algorithmic latency, without the chunk size
+%
+% Other m-files required: computeKaldiMfcc, accCmvnStats, computePpg,
+% initPpgStream, streamPpg
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function report = reportPpgStreamDrift(wavList, model, varargin)
+    p = inputParser;
+    p.KeepUnmatched = true;
+    addRequired(p, 'wavList', @iscellstr);
+    addRequired(p, 'model', @isstruct);
+    addParameter(p, 'Reference', {}, @iscell);
+    addParameter(p, 'ChunkSize', 160, @(x) isnumeric(x) && x>=1);
+    parse(p, wavList, model, varargin{:});
+    reference = p.Results.Reference;
+    chunkSize = p.Results.ChunkSize;
+    streamOpts = [fieldnames(p.Unmatched), struct2cell(p.Unmatched)]';
+    numUtts = length(wavList);
+    if ~isempty(reference)
+        assert(length(reference) == numUtts,...
+            'Need one reference PPG per wav file.');
+    end
+
+    % Load audio, and the batch reference if not given
+    wavs = cell(numUtts, 1);
+    for ii = 1:numUtts
+        [wav, fs] = audioread(wavList{ii});
+        assert(fs == model.mfccOpts.sampleFrequency,...
+            'Expected %d Hz audio for the PPG model.',...
+            model.mfccOpts.sampleFrequency);
+        wavs{ii} = wav(:, 1)*32768;
+    end
+    if isempty(reference)
+        mfccs = cellfun(@(x) computeKaldiMfcc(x, model.mfccOpts), wavs,...
+            'UniformOutput', false);
+        cmvnStats = [];
+        for ii = 1:numUtts
+            cmvnStats = accCmvnStats(mfccs{ii}, cmvnStats);
+        end
+        reference = cellfun(@(x) computePpg(x, model, cmvnStats), mfccs,...
+            'UniformOutput', false);
+    end
+
+    % Stream each utterance and compare
+    report.utt = struct('numFrames', cell(numUtts, 1), 'meanAbsDiff', [],...
+        'maxAbsDiff', [], 'meanSymKL', [], 'argmaxAgreement', []);
+    totalFrames = 0;
+    totalAbsDiff = 0;
+    totalSymKL = 0;
+    totalAgreement = 0;
+    maxAbsDiff = 0;
+    for ii = 1:numUtts
+        state = initPpgStream(model, streamOpts{:});
+        numSamples = length(wavs{ii});
+        chunks = cell(1, ceil(numSamples/chunkSize));
+        for cc = 1:length(chunks)
+            chunkIdx = ((cc-1)*chunkSize + 1):min([cc*chunkSize, numSamples]);
+            [chunks{cc}, state] = streamPpg(state, wavs{ii}(chunkIdx),...
+                cc == length(chunks));
+        end
+        post = double([chunks{:}]);
+        ref = double(reference{ii});
+        numFrames = min([size(post, 2), size(ref, 2)]);
+        post = post(:, 1:numFrames);
+        ref = ref(:, 1:numFrames);
+        absDiff = abs(post - ref);
+        symKL = sum((post - ref).*(log(post + eps) - log(ref + eps)), 1);
+        [~, postIdx] = max(post, [], 1);
+        [~, refIdx] = max(ref, [], 1);
+        agreement = postIdx == refIdx;
+
+        report.utt(ii).numFrames = numFrames;
+        report.utt(ii).meanAbsDiff = mean(absDiff(:));
+        report.utt(ii).maxAbsDiff = max(absDiff(:));
+        report.utt(ii).meanSymKL = mean(symKL);
+        report.utt(ii).argmaxAgreement = mean(agreement);
+        fprintf(['%s: %d frames, mean abs diff %.3g, max abs diff %.3g, ',...
+            'mean sym KL %.3g, argmax agreement %.2f%%\n'], wavList{ii},...
+            numFrames, mean(absDiff(:)), max(absDiff(:)), mean(symKL),...
+            100*mean(agreement));
+        totalFrames = totalFrames + numFrames;
+        totalAbsDiff = totalAbsDiff + sum(absDiff(:))/size(absDiff, 1);
+        totalSymKL = totalSymKL + sum(symKL);
+        totalAgreement = totalAgreement + sum(agreement);
+        maxAbsDiff = max([maxAbsDiff, max(absDiff(:))]);
+    end
+    report.meanAbsDiff = totalAbsDiff/totalFrames;
+    report.maxAbsDiff = maxAbsDiff;
+    report.meanSymKL = totalSymKL/totalFrames;
+    report.argmaxAgreement = totalAgreement/totalFrames;
+    report.latencyMs = state.lookahead*state.frameShift/fs*1000 +...
+        state.frameLength/2/fs*1000;
+    fprintf(['Overall: %d frames, mean abs diff %.3g, max abs diff %.3g, ',...
+        'mean sym KL %.3g, argmax agreement %.2f%%, latency %.1f ms\n'],...
+        totalFrames, report.meanAbsDiff, report.maxAbsDiff,...
+        report.meanSymKL, 100*report.argmaxAgreement, report.latencyMs);
+end
@@ -0,0 +1,150 @@
+% resultCache: a content-addressed, size-bounded cache of intermediate
+% results on disk, e.g., the analysis of an audio file or the converted
+% mcep of an utterance, so that repeated runs over the same inputs and
+% models skip the stages that are already done. Each entry is a mat file
+% named by its key under 'cacheDir'. Reading an entry marks it as recently
+% used, and writing one evicts the least recently used entries until the
+% cache fits in 'maxBytes'.
+%
+% Syntax: key = resultCache('key', part1, part2, ...)
+%         [value, isHit] = resultCache('get', cacheDir, key)
+%         resultCache('put', cacheDir, key, value)
+%         resultCache('put', cacheDir, key, value, maxBytes)
+%
+% Inputs:
+%   command: A string,
+%       - 'key': compute the key of an entry from everything it depends on
+%       - 'get': read an entry
+%       - 'put': write an entry, and evict the old ones if needed
+%   part1, part2, ...: Anything that affects the cached value, e.g., the
+%   name of the stage, the content hash of the input files (see
+%   'hashContent'), a model struct, and the options. Strings are hashed as
+%   they are, other values by their serialized bytes.
+%   cacheDir: A string. Root dir of the cache, created if not exist.
+%   key: A string. Output of resultCache('key', ...).
+%   value: Anything that can be saved in a mat file.
+%   maxBytes: A number. Size limit of the cache on disk. Default to 4 GB.
+%
+% Outputs:
+%   key: A string. 32-char hex digest.
+%   value: The cached value, [] if not cached.
+%   isHit: true if the entry was in the cache.
+%
+% Other m-files required: tryCreateDir
+%
+% Subfunctions: entryPath, evict
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function varargout = resultCache(command, varargin)
+    switch command
+        case 'key'
+            md = java.security.MessageDigest.getInstance('MD5');
+            for ii = 1:length(varargin)
+                part = varargin{ii};
+                if ischar(part)
+                    bytes = uint8(part);
+                else
+                    bytes = getByteStreamFromArray(part);
+                end
+                % Separate the parts, so that {'ab', 'c'} ~= {'a', 'bc'}
+                md.update(typecast(uint64(length(bytes)), 'uint8'));
+                if ~isempty(bytes)
+                    md.update(bytes);
+                end
+            end
+            varargout{1} = sprintf('%02x', typecast(md.digest(), 'uint8'));
+        case 'get'
+            [cacheDir, key] = varargin{1:2};
+            entry = entryPath(cacheDir, key);
+            value = [];
+            isHit = false;
+            if exist(entry, 'file')
+                try
+                    data = load(entry, 'value');
+                    value = data.value;
+                    isHit = true;
+                    % Mark as recently used
+                    java.io.File(entry).setLastModified(...
+                        java.lang.System.currentTimeMillis());
+                catch
+                    % A broken entry is a miss, it will be overwritten
+                    warning('Cannot read cache entry %s, ignored.', entry);
+                end
+            end
+            varargout{1} = value;
+            varargout{2} = isHit;
+        case 'put'
+            [cacheDir, key, value] = varargin{1:3};
+            maxBytes = 4*2^30;
+            if length(varargin) > 3
+                maxBytes = varargin{4};
+            end
+            entry = entryPath(cacheDir, key);
+            entryDir = fileparts(entry);
+            if ~exist(entryDir, 'dir')
+                tryCreateDir(entryDir);
+            end
+            % Write to a temp file first, so that a crash or a concurrent
+            % reader never sees a half-written entry
+            tempEntry = [entry(1:(end-4)), '.tmp.mat'];
+            save(tempEntry, 'value');
+            movefile(tempEntry, entry, 'f');
+            evict(cacheDir, maxBytes);
+        otherwise
+            error('Unknown cache command ''%s''.', command);
+    end
+end
+
+% Entries are spread over 256 sub-dirs by the first two chars of the key
+function entry = entryPath(cacheDir, key)
+    entry = fullfile(cacheDir, key(1:2), sprintf('%s.mat', key));
+end
+
+% Delete the least recently used entries until the cache fits in maxBytes
+function evict(cacheDir, maxBytes)
+    subDirs = dir(cacheDir);
+    subDirs = {subDirs([subDirs.isdir] & ~strncmp({subDirs.name}, '.', 1)).name};
+    entries = cell(length(subDirs), 1);
+    for ii = 1:length(subDirs)
+        entries{ii} = dir(fullfile(cacheDir, subDirs{ii}, '*.mat'));
+    end
+    entries = vertcat(entries{:});
+    if isempty(entries)
+        return
+    end
+    entries = entries(cellfun(@isempty, strfind({entries.name}, '.tmp.')));
+    totalBytes = sum([entries.bytes]);
+    if totalBytes <= maxBytes
+        return
+    end
+    [~, order] = sort([entries.datenum], 'ascend');
+    for ii = order
+        % Keep at least the newest entry
+        if totalBytes <= maxBytes || ii == order(end)
+            break
+        end
+        delete(fullfile(cacheDir, entries(ii).name(1:2), entries(ii).name));
+        totalBytes = totalBytes - entries(ii).bytes;
+    end
+end
@@ -0,0 +1,107 @@
+% selectGaussians: Gaussian selection for the conversion with a joint GMM.
+% For each frame, find the K mixtures with the largest posteriors given
+% the source features, and their posteriors renormalized over those K. All
+% mixtures are first scored with a cheap approximation, the source
+% marginal with only the diagonal of its covariance, as one matrix product;
+% only a shortlist of the best-scored mixtures of each frame is then
+% evaluated exactly, and the top K of those are kept. For 'diag' models the
+% cheap score is already exact. Since the posteriors are usually dominated
+% by a few mixtures, a small K changes the conversion very little, see
+% 'reportGaussianSelection'.
+%
+% Syntax: [idx, post] = selectGaussians(mix, x, k)
+%
+% Inputs:
+%   mix: A struct. The joint netlab GMM, 'diag' or 'full'.
+%   x: A T*Dx matrix, the source features, i.e., the first Dx dimensions
+%   of the model.
+%   k: Number of mixtures to keep per frame.
+%
+%   [Optional name-value pairs]
+%   'Shortlist': number of mixtures per frame that are evaluated exactly,
+%   default to 4*k
+%
+% Outputs:
+%   idx: A T*K matrix, the selected mixtures of each frame, the most likely
+%   first, K = min(k, number of mixtures).
+%   post: A T*K matrix, p(idx(t,k)|x(t,:)) renormalized over the K.
+%
+% Other m-files required: gmmLogDensity
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function [idx, post] = selectGaussians(mix, x, k, varargin)
+    p = inputParser;
+    addRequired(p, 'k', @(x) isnumeric(x) && x>=1);
+    addParameter(p, 'Shortlist', [], @isnumeric);
+    parse(p, k, varargin{:});
+    numMix = mix.ncentres;
+    [numFrames, xDim] = size(x);
+    xInd = 1:xDim;
+    k = min(k, numMix);
+    shortlist = p.Results.Shortlist;
+    if isempty(shortlist)
+        shortlist = 4*k;
+    end
+    shortlist = min(max(shortlist, k), numMix);
+
+    % Cheap scores of all the mixtures, with the diagonal of the source
+    % covariances, relative to the mean frame to keep the expansion exact
+    switch mix.covar_type
+        case 'full'
+            variances = zeros(numMix, xDim);
+            for m = 1:numMix
+                variances(m, :) = diag(mix.covars(xInd, xInd, m))';
+            end
+        case 'diag'
+            variances = mix.covars(:, xInd);
+        otherwise
+            error('Unsupported covariance type ''%s''.', mix.covar_type);
+    end
+    origin = mean(x, 1);
+    xc = bsxfun(@minus, x, origin);
+    centres = bsxfun(@minus, mix.centres(:, xInd), origin);
+    invVars = 1./variances;
+    mahal = bsxfun(@plus, (xc.^2)*invVars' - 2*xc*(centres.*invVars)',...
+        sum(centres.^2.*invVars, 2)');
+    score = bsxfun(@plus, -0.5*max(mahal, 0), log(mix.priors) -...
+        0.5*(xDim*log(2*pi) + sum(log(variances), 2)'));
+    [score, candidates] = sort(score, 2, 'descend');
+    candidates = candidates(:, 1:shortlist);
+
+    % Exact scores of the shortlist, then keep the top k
+    if strcmp(mix.covar_type, 'diag')
+        logProb = score(:, 1:shortlist);
+    else
+        logProb = gmmLogDensity(mix, x, xInd, candidates);
+        [logProb, order] = sort(logProb, 2, 'descend');
+        candidates = candidates(sub2ind(size(candidates),...
+            repmat((1:numFrames)', 1, shortlist), order));
+    end
+    idx = candidates(:, 1:k);
+    logProb = logProb(:, 1:k);
+    post = exp(bsxfun(@minus, logProb, max(logProb, [], 2)));
+    post = bsxfun(@rdivide, post, sum(post, 2));
+end
@@ -0,0 +1,136 @@
+% socketMessage: send and receive Matlab values over a TCP socket, used by
+% the distributed EM ('gmmemDistributed' and 'gmmWorker'). A message is
+% the serialized value prefixed with its length in bytes as a uint64. A
+% peer can first be checked with a shared token, sent as raw bytes, so
+% that nothing it sends is deserialized before it is trusted.
+%
+% Syntax: socketMessage('send', sock, value)
+%         value = socketMessage('receive', sock)
+%         value = socketMessage('receive', sock, maxBytes)
+%         [value, state] = socketMessage('poll', sock, state)
+%         socketMessage('sendToken', sock, token)
+%         isValid = socketMessage('checkToken', sock, token)
+%
+% Inputs:
+%   command: 'send' | 'receive' | 'poll' | 'sendToken' | 'checkToken'
+%   sock: A java.net.Socket. Its SoTimeout bounds how long 'receive' and
+%   'checkToken' wait, 0 waits forever.
+%   value: Any Matlab value, usually a struct with a 'command' field.
+%   maxBytes: the longest message taken, a longer one is an error before
+%   anything is allocated for it. Default to Inf
+%   token: A string, shared by the two ends.
+%   state: ('poll') what is read of a message so far, [] to start one.
+%   'poll' reads only the bytes that have arrived, and never waits.
+%
+% Outputs:
+%   value: The received value.
+%   isValid: true if the peer sent the same token.
+%   state: ('poll') A struct, 'isDone' is true once 'value' is the whole
+%   message.
+%
+% Errors if the socket is closed by the other end, or if the wait times
+% out, so that the caller can treat the peer as lost.
+%
+% Other m-files required: None
+%
+% Subfunctions: readBytes
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: add the token handshake and 'maxBytes', GZ
+%   10/18/2026: add 'poll', GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function [value, state] = socketMessage(command, sock, value)
+    switch command
+        case 'send'
+            payload = getByteStreamFromArray(value);
+            header = typecast(uint64(numel(payload)), 'uint8');
+            stream = sock.getOutputStream();
+            stream.write(typecast([header(:); payload(:)], 'int8'));
+            stream.flush();
+        case 'receive'
+            % Java cannot fill a Matlab array in place, so read into a
+            % ByteBuffer and take its array
+            channel = java.nio.channels.Channels.newChannel(...
+                sock.getInputStream());
+            numBytes = double(typecast(readBytes(channel, 8), 'uint64'));
+            maxBytes = Inf;
+            if nargin > 2
+                maxBytes = value;
+            end
+            if numBytes > maxBytes
+                error('A message of %d bytes is longer than %d bytes.',...
+                    numBytes, maxBytes);
+            end
+            value = getArrayFromByteStream(readBytes(channel, numBytes));
+        case 'poll'
+            % The length first, then the buffer is grown to the message
+            state = value;
+            value = [];
+            if isempty(state)
+                state = struct('buffer', zeros(8, 1, 'uint8'),...
+                    'numRead', 0, 'isDone', false);
+            end
+            stream = sock.getInputStream();
+            channel = java.nio.channels.Channels.newChannel(stream);
+            while ~state.isDone
+                numBytes = min([double(stream.available()),...
+                    numel(state.buffer) - state.numRead]);
+                if numBytes <= 0
+                    break
+                end
+                state.buffer(state.numRead + (1:numBytes)) =...
+                    readBytes(channel, numBytes);
+                state.numRead = state.numRead + numBytes;
+                if state.numRead == 8 && numel(state.buffer) == 8
+                    state.buffer(8 + double(typecast(state.buffer,...
+                        'uint64'))) = 0;
+                elseif state.numRead == numel(state.buffer)
+                    state.isDone = true;
+                end
+            end
+            if state.isDone
+                value = getArrayFromByteStream(state.buffer(9:end));
+            end
+        case 'sendToken'
+            stream = sock.getOutputStream();
+            stream.write(typecast(uint8(value(:)), 'int8'));
+            stream.flush();
+        case 'checkToken'
+            channel = java.nio.channels.Channels.newChannel(...
+                sock.getInputStream());
+            value = isequal(readBytes(channel, numel(value)),...
+                uint8(value(:)));
+        otherwise
+            error('Unknown socket message command ''%s''.', command);
+    end
+end
+
+function bytes = readBytes(channel, numBytes)
+    buffer = java.nio.ByteBuffer.allocate(numBytes);
+    while buffer.hasRemaining()
+        if channel.read(buffer) < 0
+            error('The connection was closed by the other end.');
+        end
+    end
+    bytes = typecast(buffer.array(), 'uint8');
+end
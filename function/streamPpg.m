@@ -0,0 +1,202 @@
+% streamPpg: push a chunk of audio into a streaming PPG extractor and get
+% the PPG frames that became ready. A frame t is emitted once MFCC frame
+% t+lookahead has arrived, and its output is the same as what the batch
+% extractor ('computePpg') would give if the utterance ended at frame
+% t+lookahead, except that the CMVN stats come from a causal window. So the
+% algorithmic latency is the lookahead plus half a window, e.g., 3*5 +
+% 12.5 = 27.5 ms for the default 5 ms MFCCs, plus the chunk size.
+%
+% Syntax: [post, state] = streamPpg(state, wavChunk)
+%         [post, state] = streamPpg(state, wavChunk, isFinal)
+%
+% Inputs:
+%   state: A struct. The stream state from 'initPpgStream' or from the
+%   previous call.
+%   wavChunk: A vector. New audio samples, in 16-bit sample scale, same as
+%   'computeKaldiMfcc'. Can be empty.
+%   isFinal: Set to true for the last chunk, which flushes the remaining
+%   frames. Default to false.
+%
+% Outputs:
+%   post: A K*N single matrix, the N new PPG frames, can be empty.
+%   state: A struct. The updated stream state.
+%
+% Other m-files required: computeKaldiMfcc, accCmvnStats, nnet2Forward
+%
+% Subfunctions: frameStart, normalizeFrame, computePost
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: keep the CMVN window in a fixed-size ring buffer, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function [post, state] = streamPpg(state, wavChunk, isFinal)
+    if nargin < 3
+        isFinal = false;
+    end
+    assert(~state.isFinished,...
+        'The stream has finished, start a new one with initPpgStream.');
+    state.samples = [state.samples; double(wavChunk(:))];
+    state.numSamples = state.numSamples + numel(wavChunk);
+    numSamples = state.numSamples;
+    frameShift = state.frameShift;
+    frameLength = state.frameLength;
+
+    % MFCC frames whose samples have all arrived
+    if state.mfccOpts.snipEdges
+        numReady = 0;
+        if numSamples >= frameLength
+            numReady = 1 + floor((numSamples - frameLength)/frameShift);
+        end
+    else
+        numReady = floor((numSamples + floor(frameShift/2))/frameShift);
+        if ~isFinal
+            numReady = min([numReady, 1 + floor((numSamples -...
+                frameLength - frameStart(state, 0))/frameShift)]);
+            numReady = max([numReady, 0]);
+        end
+    end
+    if numReady > state.nextMfccFrame
+        firstFrame = state.nextMfccFrame;
+        lastFrame = numReady - 1;
+        sampleIdx = frameStart(state, firstFrame):...
+            (frameStart(state, lastFrame) + frameLength - 1);
+        % Reflect at the start, and at the end of the stream
+        sampleIdx(sampleIdx < 0) = -sampleIdx(sampleIdx < 0) - 1;
+        if isFinal
+            isOver = sampleIdx >= numSamples;
+            sampleIdx(isOver) = 2*numSamples - 1 - sampleIdx(isOver);
+            sampleIdx(sampleIdx < 0) = -sampleIdx(sampleIdx < 0) - 1;
+        end
+        segment = state.samples(sampleIdx - state.sampleOffset + 1);
+        segmentOpts = state.mfccOpts;
+        segmentOpts.snipEdges = true; % the segment holds exactly the frames
+        mfcc = computeKaldiMfcc(segment, segmentOpts);
+        state.nextMfccFrame = numReady;
+
+        % Online CMVN, frame by frame
+        feats = zeros(size(mfcc));
+        for ii = 1:size(mfcc, 2)
+            [feats(:, ii), state] = normalizeFrame(state, mfcc(:, ii));
+        end
+        state.feats = [state.feats, feats];
+
+        % Drop the samples that no frame needs anymore
+        keepFrom = min([max([0, frameStart(state, numReady)]), numSamples]);
+        state.samples = state.samples((keepFrom - state.sampleOffset + 1):end);
+        state.sampleOffset = keepFrom;
+    end
+
+    % PPG frames that have enough lookahead
+    lastMfccFrame = state.nextMfccFrame - 1;
+    if isFinal
+        lastPostFrame = lastMfccFrame;
+        state.isFinished = true;
+    else
+        lastPostFrame = lastMfccFrame - state.lookahead;
+    end
+    postFrames = state.nextPostFrame:lastPostFrame;
+    post = computePost(state, postFrames, lastMfccFrame);
+    state.nextPostFrame = max([state.nextPostFrame, lastPostFrame + 1]);
+
+    % Drop the features that no frame needs anymore
+    keepFrom = max([0, state.nextPostFrame - state.model.leftContext +...
+        min(state.nnetContext)]);
+    keepFrom = min([keepFrom, state.featOffset + size(state.feats, 2)]);
+    state.feats = state.feats(:, (keepFrom - state.featOffset + 1):end);
+    state.featOffset = keepFrom;
+end
+
+% First sample (0-based) of a frame, refer to feature-window.cc
+function idx = frameStart(state, frame)
+    idx = frame*state.frameShift;
+    if ~state.mfccOpts.snipEdges
+        idx = idx + floor(state.frameShift/2) - floor(state.frameLength/2);
+    end
+end
+
+% CMVN of one frame with the stats of a causal window, refer to Kaldi's
+% OnlineCmvn
+function [feat, state] = normalizeFrame(state, frame)
+    dim = length(frame);
+    state.cmvnStats = accCmvnStats(frame, state.cmvnStats);
+    if isfinite(state.cmvnWindow)
+        % A ring buffer of the frames in the window, the slot of the
+        % oldest one is overwritten by the new one
+        window = ceil(state.cmvnWindow);
+        if isempty(state.cmvnHistory)
+            state.cmvnHistory = zeros(dim, window);
+        end
+        slot = mod(state.cmvnNumFrames, window) + 1;
+        if state.cmvnNumFrames >= window
+            oldFrame = state.cmvnHistory(:, slot);
+            state.cmvnStats(1, 1:dim) = state.cmvnStats(1, 1:dim) - oldFrame';
+            state.cmvnStats(1, end) = state.cmvnStats(1, end) - 1;
+            state.cmvnStats(2, 1:dim) = state.cmvnStats(2, 1:dim) -...
+                oldFrame'.^2;
+        end
+        state.cmvnHistory(:, slot) = frame;
+        state.cmvnNumFrames = state.cmvnNumFrames + 1;
+    end
+    stats = state.cmvnStats;
+    count = stats(1, end);
+    if ~isempty(state.cmvnPrior) && count < state.cmvnPriorFrames
+        stats = stats + state.cmvnPrior*...
+            ((state.cmvnPriorFrames - count)/state.cmvnPrior(1, end));
+    end
+    cmvnMean = stats(1, 1:dim)'/stats(1, end);
+    feat = frame - cmvnMean;
+    if state.model.normVars
+        cmvnVar = max(stats(2, 1:dim)'/stats(1, end) - cmvnMean.^2, 1e-20);
+        feat = feat./sqrt(cmvnVar);
+    end
+end
+
+% PPGs of the given frames, each one sees the features up to its lookahead
+% and repeats the newest frame beyond that. All the frames go through the
+% LDA and the nnet as one batch.
+function post = computePost(state, postFrames, lastMfccFrame)
+    numPost = length(postFrames);
+    if numPost == 0
+        post = zeros(state.nnet.outputDim, 0, 'single');
+        return
+    end
+    lastSeen = min(postFrames + state.lookahead, lastMfccFrame);
+    nnetContext = state.nnetContext(:);
+    spliceContext = state.spliceContext(:);
+    % Input frames of the nnet splicing, clamped like the nnet padding
+    nnetIdx = bsxfun(@plus, nnetContext, postFrames);
+    nnetIdx = bsxfun(@min, max(nnetIdx, 0), lastSeen);
+    % Input frames of the LDA splicing, clamped like 'splice-feats'
+    lastSeen = reshape(repmat(lastSeen, length(nnetContext), 1), 1, []);
+    featIdx = bsxfun(@plus, spliceContext, nnetIdx(:)');
+    featIdx = bsxfun(@min, max(featIdx, 0), lastSeen);
+    x = state.feats(:, featIdx(:) - state.featOffset + 1);
+    x = reshape(x, [], numel(nnetIdx));
+    lda = state.model.lda;
+    if size(lda, 2) == size(x, 1)
+        x = lda*x;
+    else
+        x = bsxfun(@plus, lda(:, 1:(end-1))*x, lda(:, end));
+    end
+    x = reshape(x, [], numPost);
+    post = nnet2Forward(state.nnet, x);
+end
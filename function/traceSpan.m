@@ -0,0 +1,157 @@
+% traceSpan: record nested, timed spans of a run, e.g., loading, frame
+% pairing, EM iterations, and synthesis, so that we can see where the time
+% goes without a profiler. The trace lives in this function, one per Matlab
+% process, and is off by default, in which case 'begin' and 'end' do
+% nothing. Each span records its wall time, the number of frames it
+% processed, and the peak resident memory of the process while it was
+% open. Use 'writeTrace' to export a trace.
+%
+% Syntax: traceSpan('start')
+%         isOn = traceSpan('isOn')
+%         spanId = traceSpan('begin', name)
+%         traceSpan('end', spanId)
+%         traceSpan('end', spanId, numFrames)
+%         traceSpan('merge', trace, threadId)
+%         trace = traceSpan('stop')
+%
+% Inputs:
+%   command: A string,
+%       - 'start': start a new trace, the old one is discarded
+%       - 'isOn': whether a trace is being recorded
+%       - 'begin': open a span, nested in the innermost open span
+%       - 'end': close a span, and all the spans nested in it
+%       - 'merge': add the spans of a trace recorded elsewhere, e.g., by a
+%       parallel worker, to the current trace, nested in the innermost
+%       open span, and shown as thread 'threadId'
+%       - 'stop': stop recording and get the trace
+%   name: A string. Name of the span, spans with the same name are grouped
+%   in the summary, e.g., 'em/iteration'.
+%   spanId: The output of 'begin', 0 if the trace is off.
+%   numFrames: Number of frames processed in the span. Default to NaN,
+%   i.e., not counted.
+%
+% Outputs:
+%   spanId: An integer. Pass it to 'end', 0 if the trace is off.
+%   trace: A struct,
+%       - startClock: the 'clock' when the trace started
+%       - spans: a struct array with 'name', 'threadId', 'depth',
+%       'startUs', 'durationUs', 'numFrames', and 'peakBytes', where
+%       'startUs' is relative to 'startClock'
+%
+% Other m-files required: getMemoryInfo
+%
+% Subfunctions: newTrace
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: read the memory usage with getMemoryInfo, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function out = traceSpan(command, varargin)
+    persistent trace isOn openSpans startTic
+    if isempty(isOn)
+        isOn = false;
+    end
+    out = [];
+    switch command
+        case 'start'
+            trace = newTrace();
+            isOn = true;
+            openSpans = [];
+            startTic = tic;
+            getMemoryInfo(true);
+        case 'isOn'
+            out = isOn;
+        case 'begin'
+            out = 0;
+            if ~isOn
+                return
+            end
+            % The memory peak so far belongs to all the open spans, then
+            % start a new peak for the new span
+            mem = getMemoryInfo(true);
+            for ii = openSpans
+                trace.spans(ii).peakBytes = max([trace.spans(ii).peakBytes,...
+                    mem.peakBytes]);
+            end
+            span.name = varargin{1};
+            span.threadId = 0;
+            span.depth = length(openSpans);
+            span.startUs = toc(startTic)*1e6;
+            span.durationUs = NaN;
+            span.numFrames = NaN;
+            span.peakBytes = mem.residentBytes;
+            trace.spans(end+1) = span;
+            out = length(trace.spans);
+            openSpans(end+1) = out;
+        case 'end'
+            spanId = varargin{1};
+            if ~isOn || spanId == 0 || ~any(openSpans == spanId)
+                return
+            end
+            nowUs = toc(startTic)*1e6;
+            mem = getMemoryInfo();
+            for ii = openSpans
+                trace.spans(ii).peakBytes = max([trace.spans(ii).peakBytes,...
+                    mem.peakBytes]);
+            end
+            % Close the span, and the ones that were left open in it
+            while ~isempty(openSpans)
+                ii = openSpans(end);
+                openSpans = openSpans(1:(end-1));
+                trace.spans(ii).durationUs = nowUs - trace.spans(ii).startUs;
+                if ii == spanId
+                    break
+                end
+            end
+            if length(varargin) > 1
+                trace.spans(spanId).numFrames = varargin{2};
+            end
+        case 'merge'
+            if ~isOn || isempty(varargin{1}) || isempty(varargin{1}.spans)
+                return
+            end
+            spans = varargin{1}.spans;
+            offsetUs = etime(varargin{1}.startClock, trace.startClock)*1e6;
+            for ii = 1:length(spans)
+                spans(ii).threadId = varargin{2};
+                spans(ii).depth = spans(ii).depth + length(openSpans);
+                spans(ii).startUs = spans(ii).startUs + offsetUs;
+            end
+            trace.spans = [trace.spans, spans];
+        case 'stop'
+            if isOn && ~isempty(openSpans)
+                warning('%d span(s) still open, closing them.',...
+                    length(openSpans));
+                traceSpan('end', openSpans(1));
+            end
+            isOn = false;
+            out = trace;
+        otherwise
+            error('Unknown trace command ''%s''.', command);
+    end
+end
+
+function trace = newTrace()
+    trace.startClock = clock;
+    trace.spans = struct('name', {}, 'threadId', {}, 'depth', {},...
+        'startUs', {}, 'durationUs', {}, 'numFrames', {}, 'peakBytes', {});
+end
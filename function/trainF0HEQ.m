@@ -20,7 +20,7 @@
 %       - cdf: the cumulative distribution function (CDF)
 %       - eqProbEdges: chop the CDF with equal increments
 %
-% Other m-files required: None
+% Other m-files required: findEqProbEdges
 %
 % Subfunctions: None
 %
@@ -28,7 +28,7 @@
 %
 % Author: Guanlong Zhao
 % Email: gzhao@tamu.edu
-% Created: 03/27/2017; Last revision: 04/23/2019
+% Created: 03/27/2017; Last revision: 10/18/2026
 % Revision log:
 %   03/27/2017: function creation, Guanlong Zhao
 %   03/28/2017: bug fixes, Guanlong Zhao
@@ -36,6 +36,7 @@
 %   09/07/2017: fixed a bug, Guanlong Zhao
 %   10/15/2018: treat everything outside of 2 stds (95%) as outlier, GZ
 %   04/23/2019: fix docs, GZ
+%   10/18/2026: find the equal-probability edges with a linear scan, GZ
 
 % Copyright 2017 Guanlong Zhao
 % 
@@ -82,10 +83,7 @@ function params = trainF0HEQ(f0raw, vis)
     
     % Get the values we want
     cdf = cumsum(freq);
-    perCt = 1/numBins:1/numBins:(1-1/numBins);
-    distPerCt = pdist2(perCt', cdf');
-    [v, eqProbBins] = min(distPerCt, [], 2);
-    eqProbEdges = [bins(1), bins(eqProbBins), bins(end)];
+    eqProbEdges = findEqProbEdges(bins, cdf);
     
     % Construct the output struct
     params.data = f0raw;
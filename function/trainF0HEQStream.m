@@ -0,0 +1,195 @@
+% trainF0HEQStream: single-pass, streaming version of trainF0HEQ. Instead
+%  of concatenating all the F0 values of a speaker, the utterances are
+%  split into shards, and each shard accumulates a small mergeable sketch
+%  utterance-by-utterance: the count, sum, and sum of squares of the F0
+%  values, plus a fine fixed-bin histogram over a fixed F0 range. The
+%  shards can be processed by parallel workers, their sketches are merged,
+%  and the HEQ model is derived from the merged sketch. The raw F0 values
+%  are never held in memory together, and they are not saved in the model.
+%
+%  The mean and std used for outlier removal are exact. The histogram is
+%  re-binned from the fine histogram, so 'xMin', 'xMax', and the bin edges
+%  are accurate up to the fine bin width ('Resolution').
+%
+% Syntax: [params, invalidIdx] = trainF0HEQStream(spkrFiles)
+%
+% Inputs:
+%   spkrFiles: A cell array. Each element is a path to a mat file from a
+%   speaker.
+%
+%   [Optional name-value pairs]
+%   'NumWorkers': An interger. How many parallel workers to use. Default to
+%   0, which tells Matlab not to run parallel computing
+%   'Range': F0 values outside of this range (in Hz) are ignored, and the
+%   fine histogram covers this range. Default to [40, 400], see
+%   buildPitchModelGSB
+%   'Resolution': width of the fine histogram bins in Hz. Default to 0.01
+%
+% Outputs:
+%   params: parameters needed to model a speaker's pitch identity, has the
+%   same fields as the output of trainF0HEQ, except for 'data', struct
+%       - xMin: the minimum non-zero pitch, scalar
+%       - xMax: the maximum pitch, scalar
+%       - numBins: number of bins in the histogram, scalar
+%       - bins: the histogram bins, 1*(numBins+1) vector
+%       - freq: the frequency of each bin
+%       - cdf: the cumulative distribution function (CDF)
+%       - eqProbEdges: chop the CDF with equal increments
+%       - numFrames: number of voiced frames seen, scalar
+%   invalidIdx: A numeric array. Indices of files that do not exist.
+%
+% Other m-files required: findEqProbEdges
+%
+% Subfunctions: newSketch, accumulateSketch, mergeSketch, finalizeSketch
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function [params, invalidIdx] = trainF0HEQStream(spkrFiles, varargin)
+    % Input parser
+    p = inputParser;
+    addRequired(p, 'spkrFiles', @iscellstr);
+    addParameter(p, 'NumWorkers', 0, @(x) isnumeric(x) && x>=0);
+    addParameter(p, 'Range', [40, 400],...
+        @(x) isnumeric(x) && length(x)==2 && x(1)<x(2));
+    addParameter(p, 'Resolution', 0.01, @(x) isnumeric(x) && x>0);
+    parse(p, spkrFiles, varargin{:});
+    numWorkers = p.Results.NumWorkers;
+    f0Range = p.Results.Range;
+    resolution = p.Results.Resolution;
+    numBins = 100; % from the reference, same as trainF0HEQ
+
+    % One shard per worker, each shard is a contiguous block of utterances
+    numFiles = length(spkrFiles);
+    numShards = max([1, min([numWorkers, numFiles])]);
+    shardEdges = round(linspace(0, numFiles, numShards+1));
+    shardSketches = cell(numShards, 1);
+    shardInvalid = cell(numShards, 1);
+    parfor (ss = 1:numShards, numWorkers)
+        sketch = newSketch(f0Range, resolution);
+        invalid = [];
+        for ii = (shardEdges(ss)+1):shardEdges(ss+1)
+            fileName = spkrFiles{ii};
+            if ~exist(fileName, 'file')
+                fprintf('Mat file ''%s'' does not exist!\n', fileName);
+                invalid = [invalid, ii];
+                continue;
+            end
+            buffer = load(fileName, 'source');
+            % Ignore unvoiced
+            f0 = buffer.source.f0(logical(buffer.source.vuv));
+            sketch = accumulateSketch(sketch, f0(:));
+        end
+        shardSketches{ss} = sketch;
+        shardInvalid{ss} = invalid;
+    end
+    invalidIdx = [shardInvalid{:}];
+
+    % Merge partial sketches
+    sketch = shardSketches{1};
+    for ss = 2:numShards
+        sketch = mergeSketch(sketch, shardSketches{ss});
+    end
+    params = finalizeSketch(sketch, numBins);
+end
+
+% An empty sketch over a fixed F0 range
+function sketch = newSketch(f0Range, resolution)
+    sketch.range = f0Range;
+    sketch.resolution = resolution;
+    numFine = ceil((f0Range(2) - f0Range(1))/resolution);
+    sketch.counts = zeros(numFine, 1);
+    sketch.n = 0;
+    sketch.sum = 0;
+    sketch.sumSq = 0;
+end
+
+% Add a batch of F0 values (one utterance) to a sketch
+function sketch = accumulateSketch(sketch, f0)
+    % Simple thresholding; Titze, I.R. (1994). Principles of Voice
+    % Production, Prentice Hall (currently published by NCVS.org) (pp. 188)
+    f0 = f0(f0>sketch.range(1) & f0<sketch.range(2));
+    if isempty(f0)
+        return
+    end
+    numFine = length(sketch.counts);
+    fineIdx = floor((f0 - sketch.range(1))/sketch.resolution) + 1;
+    fineIdx = min(max(fineIdx, 1), numFine);
+    sketch.counts = sketch.counts + accumarray(fineIdx, 1, [numFine, 1]);
+    sketch.n = sketch.n + length(f0);
+    sketch.sum = sketch.sum + sum(f0);
+    sketch.sumSq = sketch.sumSq + sum(f0.^2);
+end
+
+% Merge two sketches built over the same range and resolution
+function sketch = mergeSketch(sketch, other)
+    assert(isequal(sketch.range, other.range) &&...
+        sketch.resolution == other.resolution,...
+        'Can only merge sketches with the same range and resolution.');
+    sketch.counts = sketch.counts + other.counts;
+    sketch.n = sketch.n + other.n;
+    sketch.sum = sketch.sum + other.sum;
+    sketch.sumSq = sketch.sumSq + other.sumSq;
+end
+
+% Derive the HEQ model from a sketch, mirrors trainF0HEQ
+function params = finalizeSketch(sketch, numBins)
+    assert(sketch.n > 1, 'Not enough voiced frames to build a model.');
+
+    % Get rid of outliers, 2 std -> 95%
+    f0Mean = sketch.sum/sketch.n;
+    f0Var = (sketch.sumSq - sketch.n*f0Mean^2)/(sketch.n - 1);
+    f0Std = sqrt(max([f0Var, 0]));
+    numFine = length(sketch.counts);
+    centres = sketch.range(1) + ((1:numFine)' - 0.5)*sketch.resolution;
+    validIdx = (centres>(f0Mean-2*f0Std)) & (centres<(f0Mean+2*f0Std)) &...
+        (sketch.counts>0);
+    centres = centres(validIdx);
+    counts = sketch.counts(validIdx);
+    assert(~isempty(centres), 'No valid F0 values after outlier removal.');
+
+    % Re-bin the fine histogram
+    xMin = centres(1);
+    xMax = centres(end);
+    bins = linspace(xMin, xMax, numBins+1);
+    if xMax > xMin
+        binIdx = floor((centres - xMin)/(xMax - xMin)*numBins) + 1;
+    else
+        binIdx = ones(size(centres));
+    end
+    binIdx = min(binIdx, numBins);
+    freq = transpose(accumarray(binIdx, counts, [numBins, 1]));
+    freq = freq/sum(freq);
+
+    % Get the values we want
+    cdf = cumsum(freq);
+
+    % Construct the output struct
+    params.xMin = xMin;
+    params.xMax = xMax;
+    params.numBins = numBins;
+    params.bins = bins;
+    params.freq = freq;
+    params.cdf = cdf;
+    params.eqProbEdges = findEqProbEdges(bins, cdf);
+    params.numFrames = sketch.n;
+end
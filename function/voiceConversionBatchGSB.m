@@ -0,0 +1,176 @@
+% voiceConversionBatchGSB: convert a list of utterances with one warm
+% model. The model-derived quantities are computed once
+% ('warmConversionModel') and sent to each worker once. The utterances are
+% queued longest first and each worker takes the next one as soon as it is
+% free, so that long and short utterances balance across the workers.
+% Reports the throughput in utterances per second and the real-time factor.
+%
+% Syntax: [wavFiles, report] = voiceConversionBatchGSB(uttFiles, gmmMdl, srcPitchMdl, tgtPitchMdl, outputPath)
+%
+% Inputs:
+%   uttFiles: A cell array. Each element is the path to a mat file that
+%   contains the utt struct you would like to convert.
+%   gmmMdl: A struct or a string. The PPG-GMM model, or the path to it.
+%   srcPitchMdl: A struct or a string. The source pitch model, or the path
+%   to it.
+%   tgtPitchMdl: A struct or a string. The target pitch model, or the path
+%   to it.
+%   outputPath: A string. The output dir, each output wav file has the same
+%   name as its mat file.
+%
+%   [Optional name-value pairs]
+%   'SpecCov': 'MLGV' (*) | 'MMSE' | 'MLPG'
+%   'NumWorkers': An interger. How many parallel workers to use. Default to
+%   0, which converts in serial in this Matlab session
+%   'CacheDir': A string. Result cache of the conversions, see
+%   'voiceConversionGSB'. Default to '', no cache
+%
+% Outputs:
+%   wavFiles: A cell array. Each element is a path to a wav file, which is
+%   the accent-converted version of the corresponding mat file
+%   report: A struct,
+%       - numUtts: number of utterances
+%       - wallSec: wall time of the whole batch, without the model loading
+%       - audioSec: total duration of the converted audio
+%       - uttsPerSec: throughput
+%       - rtf: real-time factor, wallSec/audioSec
+%       - utt: a struct array, one per utterance, with 'file', 'numFrames',
+%       'audioSec', and 'convertSec'
+%
+% Other m-files required: tryCreateDir, warmConversionModel,
+% voiceConversionGSB, loadUttGSB
+%
+% Subfunctions: convertOne
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: pass the result cache through, GZ
+%   10/18/2026: compute only the waveform, GZ
+%   10/18/2026: preallocate the futures as a column, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function [wavFiles, report] = voiceConversionBatchGSB(uttFiles, gmmMdl, srcPitchMdl, tgtPitchMdl, outputPath, varargin)
+    p = inputParser;
+    addRequired(p, 'uttFiles', @iscellstr);
+    addRequired(p, 'gmmMdl', @(x) isstruct(x) || ischar(x));
+    addRequired(p, 'srcPitchMdl', @(x) isstruct(x) || ischar(x));
+    addRequired(p, 'tgtPitchMdl', @(x) isstruct(x) || ischar(x));
+    addRequired(p, 'outputPath', @ischar);
+    addParameter(p, 'SpecCov', 'MLGV', @(x) ismember(x,...
+        {'MLGV', 'MLPG', 'MMSE'}));
+    addParameter(p, 'NumWorkers', 0, @(x) isnumeric(x) && x>=0);
+    addParameter(p, 'CacheDir', '', @ischar);
+    parse(p, uttFiles, gmmMdl, srcPitchMdl, tgtPitchMdl, outputPath,...
+        varargin{:});
+    specCov = p.Results.SpecCov;
+    numWorkers = p.Results.NumWorkers;
+    cacheDir = p.Results.CacheDir;
+    numUtts = length(uttFiles);
+    wavFiles = cell(numUtts, 1);
+
+    if ~exist(outputPath, 'dir')
+        tryCreateDir(outputPath);
+    end
+
+    % Load and warm up the models, once for the whole batch
+    if ischar(gmmMdl)
+        gmmMdl = load(gmmMdl);
+    end
+    if ischar(srcPitchMdl)
+        srcPitchMdl = load(srcPitchMdl);
+    end
+    if ischar(tgtPitchMdl)
+        tgtPitchMdl = load(tgtPitchMdl);
+    end
+    if ~isfield(gmmMdl, 'cache')
+        gmmMdl = warmConversionModel(gmmMdl);
+    end
+    models.gmmMdl = gmmMdl;
+    models.srcPitchMdl = srcPitchMdl;
+    models.tgtPitchMdl = tgtPitchMdl;
+
+    % Longest first, the length is read from the mat file header
+    numFrames = zeros(numUtts, 1);
+    for ii = 1:numUtts
+        numFrames(ii) = size(matfile(uttFiles{ii}), 'mcep', 2);
+    end
+    [~, order] = sort(numFrames, 'descend');
+
+    report.numUtts = numUtts;
+    report.utt = struct('file', uttFiles(:), 'numFrames', num2cell(numFrames),...
+        'audioSec', [], 'convertSec', []);
+    numWorkers = min([numWorkers, numUtts]);
+    fprintf('Converting %d utterances with %d worker(s)...\n', numUtts,...
+        numWorkers);
+    startTime = tic;
+    if numWorkers == 0
+        for ii = order(:)'
+            [wavFiles{ii}, report.utt(ii).audioSec,...
+                report.utt(ii).convertSec] = convertOne(uttFiles{ii},...
+                models, specCov, cacheDir, outputPath);
+        end
+    else
+        pool = gcp('nocreate');
+        if isempty(pool) || pool.NumWorkers < numWorkers
+            delete(pool);
+            pool = parpool('local', numWorkers);
+        end
+        % Send the models to each worker once, not with every utterance
+        sharedModels = parallel.pool.Constant(models);
+        futures(numUtts, 1) = parallel.FevalFuture;
+        for jj = 1:numUtts
+            futures(jj) = parfeval(pool, @convertOne, 3,...
+                uttFiles{order(jj)}, sharedModels, specCov, cacheDir,...
+                outputPath);
+        end
+        for jj = 1:numUtts
+            [idx, wavFile, audioSec, convertSec] = fetchNext(futures);
+            ii = order(idx);
+            wavFiles{ii} = wavFile;
+            report.utt(ii).audioSec = audioSec;
+            report.utt(ii).convertSec = convertSec;
+        end
+    end
+    report.wallSec = toc(startTime);
+    report.audioSec = sum([report.utt.audioSec]);
+    report.uttsPerSec = numUtts/report.wallSec;
+    report.rtf = report.wallSec/report.audioSec;
+    fprintf(['Converted %d utterances (%.1f s of audio) in %.1f s: ',...
+        '%.2f utts/s, real-time factor %.3f\n'], numUtts, report.audioSec,...
+        report.wallSec, report.uttsPerSec, report.rtf);
+end
+
+% Convert one utterance and save the wav file
+function [outputFile, audioSec, convertSec] = convertOne(uttFile, models, specCov, cacheDir, outputPath)
+    startTime = tic;
+    if isa(models, 'parallel.pool.Constant')
+        models = models.Value;
+    end
+    utt = loadUttGSB({uttFile}, 'RegExp', '^(?!post)\w');
+    covUtt = voiceConversionGSB(utt, models.gmmMdl, models.srcPitchMdl,...
+        models.tgtPitchMdl, 'SpecCov', specCov, 'CacheDir', cacheDir,...
+        'Outputs', {'wav'});
+    [~, uttName] = fileparts(uttFile);
+    outputFile = fullfile(outputPath, sprintf('%s.wav', uttName));
+    audiowrite(outputFile, covUtt.wav, covUtt.fs);
+    audioSec = length(covUtt.wav)/covUtt.fs;
+    convertSec = toc(startTime);
+end
@@ -5,20 +5,52 @@
 %
 % Inputs:
 %   utt: the source utt to be converted
-%   gmmMdl: the joint GMM spectral model
+%   gmmMdl: the joint GMM spectral model, the per-mixture regressions are
+%   reused if it was warmed up by 'warmConversionModel'
 %   srcPitchMdl: source pitch model
 %   tgtPitchMdl: target pitch model
 %
 %   Name-value pairs:
 %   'SpecCov': 'MLGV' (*) | 'MMSE' | 'MLPG'
+%   'TracePath': A string. Path to a Chrome trace JSON file. If set, the
+%   function records the time of each stage (pitch, spectral solve,
+%   mcep2spec, mfcc, synthesis), saves the trace, and prints a summary
+%   table. Default to '', no trace unless one is already started by the
+%   caller, see 'traceSpan'
+%   'CacheDir': A string. If set, the converted mcep and the converted
+%   utterance are looked up in this result cache first, keyed on the
+%   content of the utt, the models, and the options, and saved there after
+%   they are computed, see 'resultCache'. Default to '', no cache
+%   'CacheSize': A number. Size limit of the cache in bytes. Default to
+%   4 GB
+%   'TopK': A number. If set, only the TopK most likely mixtures of each
+%   frame are used in the spectral conversion, see 'selectGaussians'.
+%   Faster with large models, at a small cost in accuracy, see
+%   'reportGaussianSelection'. Default to [], all the mixtures
+%   'Outputs': A cell array of strings. The outputs to compute, any of
+%   'mcep', 'spec', 'mfcc', and 'wav'. The converted mcep is always
+%   computed, the others only if requested, e.g., {'mcep'} for an
+%   objective evaluation skips the spectrum, the mfcc, and the synthesis.
+%   The outputs that are not requested are left out of 'covUtt' and listed
+%   in 'covUtt.deferred', they can be computed later with
+%   'renderConversion'. Default to all of them
+%   'SkipSilence': true (*) | false. Solve the spectral conversion only on
+%   the speech segments (by 'utt.lab'), plus 'SilenceContext' frames on
+%   each side, and copy the silent frames from the source, spectrum and
+%   mfcc included. The trajectories of 'MLGV' and 'MLPG' do not cross the
+%   segments. false converts every frame and keeps the source mcep on the
+%   silent ones, as before
+%   'SilenceContext': number of silent frames solved on each side of a
+%   speech segment for 'MLGV' and 'MLPG', so that the trajectories settle
+%   before the edges of the speech. Default to 2
 %
 % Outputs:
 %   covUtt: converted utterance
 %   status: 1 for success
 %
 % Other m-files required: pitchConversion, spectralMapping_MLTrajGV,
-% spectralMapping_MMSE, mcep2spec, straight2mfcc, speechSynthesis,
-% static2dynamic
+% spectralMapping_MMSE, renderConversion, static2dynamic, traceSpan,
+% writeTrace, resultCache, selectGaussians
 %
 % Subfunctions: None
 %
@@ -26,7 +58,7 @@
 %
 % Author: Guanlong Zhao
 % Email: gzhao@tamu.edu
-% Created: 04/25/2017; Last revision: 10/24/2018
+% Created: 04/25/2017; Last revision: 10/18/2026
 % Revision log:
 %   04/25/2017: function creation, Guanlong Zhao
 %   05/10/2017: added doc, GZ
@@ -44,6 +76,12 @@
 %   09/12/2017: added 'MLPG' mode, GZ
 %   10/23/2018: change to GSB version, GZ
 %   10/24/2018: add missing dependency, GZ
+%   10/18/2026: add stage-level tracing, GZ
+%   10/18/2026: reuse the regressions of a warmed-up model, GZ
+%   10/18/2026: add the result cache, GZ
+%   10/18/2026: add Gaussian selection, GZ
+%   10/18/2026: compute only the requested outputs, 'Outputs', GZ
+%   10/18/2026: skip the silence, 'SkipSilence', GZ
 
 % Copyright 2017 Guanlong Zhao
 % 
@@ -67,52 +105,157 @@ function [covUtt, status] = voiceConversionGSB(utt, gmmMdl, srcPitchMdl, tgtPitc
     addRequired(p, 'tgtPitchMdl');
     addParameter(p, 'SpecCov', 'MLGV', @(x) ismember(x,...
         {'MLGV', 'MLPG', 'MMSE'}));
+    addParameter(p, 'TracePath', '', @ischar);
+    addParameter(p, 'CacheDir', '', @ischar);
+    addParameter(p, 'CacheSize', 4*2^30, @(x) isnumeric(x) && x>0);
+    addParameter(p, 'TopK', [], @(x) isempty(x) || (isnumeric(x) && x>=1));
+    addParameter(p, 'Outputs', {'mcep', 'spec', 'mfcc', 'wav'},...
+        @(x) all(ismember(cellstr(x), {'mcep', 'spec', 'mfcc', 'wav'})));
+    addParameter(p, 'SkipSilence', true, @islogical);
+    addParameter(p, 'SilenceContext', 2, @(x) isnumeric(x) && x>=0);
     parse(p, utt, gmmMdl, srcPitchMdl, tgtPitchMdl, varargin{:});
     specCov = p.Results.SpecCov;
+    tracePath = p.Results.TracePath;
+    cacheDir = p.Results.CacheDir;
+    cacheSize = p.Results.CacheSize;
+    topK = p.Results.TopK;
+    outputs = sort(cellstr(p.Results.Outputs));
+    isSkipSilence = p.Results.SkipSilence;
+    silenceContext = p.Results.SilenceContext;
     status = 0;
+    isTraceOwner = ~isempty(tracePath) && ~traceSpan('isOn');
+    if isTraceOwner
+        traceSpan('start');
+        traceGuard = onCleanup(@() traceSpan('stop'));
+    end
+    numFrames = size(utt.mcep, 2);
+    rootSpan = traceSpan('begin', 'voiceConversionGSB');
+    
+    % Look up the converted utterance, the PPGs and the lazy file handle do
+    % not affect the conversion
+    isCached = ~isempty(cacheDir);
+    if isCached
+        span = traceSpan('begin', 'cache/lookup');
+        if isfield(gmmMdl, 'cache') && isfield(gmmMdl.cache, 'key')
+            mdlKey = gmmMdl.cache.key;
+        else
+            mdlKey = resultCache('key', gmmMdl);
+        end
+        uttKey = resultCache('key', rmfield(utt,...
+            intersect(fieldnames(utt), {'post', 'matFile'})));
+        mcepKey = resultCache('key', 'mcep', uttKey, mdlKey, specCov,...
+            topK, isSkipSilence, silenceContext);
+        outputKey = resultCache('key', 'output', mcepKey, srcPitchMdl,...
+            tgtPitchMdl, strjoin(outputs, ','));
+        [covUtt, isHit] = resultCache('get', cacheDir, outputKey);
+        traceSpan('end', span, numFrames);
+        if isHit
+            status = 1;
+            traceSpan('end', rootSpan, numFrames);
+            if isTraceOwner
+                writeTrace(traceSpan('stop'), tracePath);
+            end
+            return
+        end
+    end
     
     % Deal with the source signal, AP is just copied from utt
     % Pitch scaling and copy AP
+    span = traceSpan('begin', 'pitch');
     covUtt = pitchConversion(utt, srcPitchMdl, tgtPitchMdl);
+    traceSpan('end', span, numFrames);
     
     % Spectral conversion
     % Prepare input data
     mcepDim = size(utt.mcep, 1);
     testMcep = transpose(static2dynamic(utt.mcep));
     testMcep = testMcep(:, [2:mcepDim, (mcepDim+2):2*mcepDim]);
-    lab = utt.lab;
-    nonSilentFrames = find(~isnan(lab));
+    isSpeech = ~isnan(utt.lab(:)');
+    nonSilentFrames = find(isSpeech);
+    % The frames to solve, the speech segments and their context. The
+    % deltas of the input are taken before the silence is cut out, so they
+    % are right at the edges
+    if ~isSkipSilence
+        isSolved = true(1, numFrames);
+    elseif strcmp(specCov, 'MMSE')
+        isSolved = isSpeech;
+    else
+        isSolved = conv(double(isSpeech),...
+            ones(1, 2*silenceContext+1), 'same') > 0;
+    end
+    solvedFrames = find(isSolved);
+    segEdges = diff([0, isSolved, 0]);
+    segLengths = find(segEdges == -1) - find(segEdges == 1);
+    % Speech frames among the solved ones
+    solvedSpeech = find(isSpeech(solvedFrames));
+    testMcep = testMcep(solvedFrames, :);
     % Perform conversion
-    switch specCov
-        case 'MLGV'
-            % Perform MLPG & GV, output is D*T
-            estMcep = spectralMapping_MLTrajGV(testMcep,...
-                gmmMdl.mix, gmmMdl.targetGVs, nonSilentFrames);
-        case 'MMSE'
-            % Minimize mean-square-error
-            estMcep = spectralMapping_MMSE(testMcep, gmmMdl.mix);
-        case 'MLPG'
-            % Perform MLPG, output is D*T
-            estMcep = spectralMapping_MLPG(testMcep, gmmMdl.mix);
-        otherwise
-            error('Wrong spectral conversion method!');
+    isHit = false;
+    if isCached
+        [estMcep, isHit] = resultCache('get', cacheDir, mcepKey);
+    end
+    if ~isHit && isempty(solvedFrames)
+        % Nothing but silence, copy the source
+        estMcep = utt.mcep;
+    elseif ~isHit
+        cache = [];
+        if isfield(gmmMdl, 'cache')
+            cache = gmmMdl.cache;
+        end
+        span = traceSpan('begin', ['solve/', specCov]);
+        switch specCov
+            case 'MLGV'
+                % Perform MLPG & GV, output is D*T
+                estMcep = spectralMapping_MLTrajGV(testMcep,...
+                    gmmMdl.mix, gmmMdl.targetGVs, solvedSpeech, cache,...
+                    topK, segLengths);
+            case 'MMSE'
+                % Minimize mean-square-error
+                estMcep = spectralMapping_MMSE(testMcep, gmmMdl.mix, cache,...
+                    topK);
+            case 'MLPG'
+                % Perform MLPG, output is D*T
+                estMcep = spectralMapping_MLPG(testMcep, gmmMdl.mix, cache,...
+                    topK, segLengths);
+            otherwise
+                error('Wrong spectral conversion method!');
+        end
+        traceSpan('end', span, length(solvedFrames));
+        % Compile results, ignore conversion performed on silent segments
+        estMcepFinal = utt.mcep;
+        estMcepFinal(2:mcepDim, nonSilentFrames) = estMcep(1:(mcepDim-1), solvedSpeech);
+        estMcep = estMcepFinal;
+        if isCached
+            resultCache('put', cacheDir, mcepKey, estMcep, cacheSize);
+        end
     end
-    % Compile results, ignore conversion performed on silent segments
-    estMcepFinal = utt.mcep;
-    estMcepFinal(2:mcepDim, nonSilentFrames) = estMcep(1:(mcepDim-1), nonSilentFrames);
-    estMcep = estMcepFinal;
 
-    % Cepstrum -> power spectrum
-    covSpec = mcep2spec(estMcep(1:mcepDim, :), utt.alpha, size(utt.spec, 1));
+    % The derived outputs start deferred, the source ones are dropped so
+    % that they are not mistaken for converted ones
     covUtt.mcep = estMcep(1:mcepDim, :);
-    covUtt.mfcc = straight2mfcc(covSpec, covUtt.fs, size(covUtt.mfcc, 1));
-    covSpec(covSpec == 0) = eps; % safe guard
-
-    % Re-synthesis
-    covUtt.spec = covSpec;
+    covUtt.deferred = struct('outputs', {{'spec', 'mfcc', 'wav'}},...
+        'specDim', size(utt.spec, 1), 'mfccDim', size(utt.mfcc, 1),...
+        'silentFrames', [], 'silentSpec', [], 'silentMfcc', []);
+    if isSkipSilence
+        % The silent frames keep the source mcep, and their spectrum and
+        % mfcc are copied from the source instead of being recomputed
+        silentFrames = find(~isSpeech);
+        covUtt.deferred.silentFrames = silentFrames;
+        covUtt.deferred.silentSpec = utt.spec(:, silentFrames);
+        covUtt.deferred.silentMfcc = utt.mfcc(:, silentFrames);
+    end
+    covUtt = rmfield(covUtt, intersect(fieldnames(covUtt),...
+        {'spec', 'mfcc', 'wav'}));
     if strcmp(utt.vocoder, 'WORLD')
-        covUtt.filter.spectrogram = covSpec;
+        covUtt.filter.spectrogram = [];
+    end
+    covUtt = renderConversion(covUtt, outputs);
+    if isCached
+        resultCache('put', cacheDir, outputKey, covUtt, cacheSize);
     end
-    covUtt = speechSynthesis(covUtt);
     status = 1;
+    traceSpan('end', rootSpan, numFrames);
+    if isTraceOwner
+        writeTrace(traceSpan('stop'), tracePath);
+    end
 end
\ No newline at end of file
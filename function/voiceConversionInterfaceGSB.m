@@ -23,13 +23,19 @@
 %   specified, the function will use only one worker. If your input
 %   utterance number is smaller than the workers requested, the function
 %   will only load the needed number of workers
+%   'TracePath': A string. Path to a Chrome trace JSON file. If set, the
+%   function records the time of each stage of each conversion, saves the
+%   trace, and prints a summary table. Spans recorded by parallel workers
+%   are merged into the trace, one thread per utterance. Default to '', no
+%   trace unless one is already started by the caller, see 'traceSpan'
 %
 % Outputs:
 %   wavFiles: A cell array. Each element is a path to a wav file, which is
 %   the accent-converted version of the corresponding mat file
 %   status: 1 for success
 %
-% Other m-files required: tryCreateDir, voiceConversionGSB, loadUttGSB
+% Other m-files required: tryCreateDir, voiceConversionGSB, loadUttGSB,
+% traceSpan, writeTrace, warmConversionModel
 %
 % Subfunctions: None
 %
@@ -37,13 +43,16 @@
 %
 % Author: Guanlong Zhao
 % Email: gzhao@tamu.edu
-% Created: 10/23/2018; Last revision: 12/07/2018
+% Created: 10/23/2018; Last revision: 10/18/2026
 % Revision log:
 %   10/23/2018: function creation, Guanlong Zhao
 %   10/24/2018: add parallel computing support, GZ
 %   11/14/2018: fix a bug that will prevent the function from loading a
 %   parpool, GZ
 %   12/07/2018: fix a weird assumption, GZ
+%   10/18/2026: add stage-level tracing, GZ
+%   10/18/2026: warm up the GMM once for all the utterances, GZ
+%   10/18/2026: compute only the waveform, GZ
 
 % Copyright 2018 Guanlong Zhao
 % 
@@ -75,10 +84,12 @@ function [wavFiles, status] = voiceConversionInterfaceGSB(uttFiles, gmmPath, src
     maxWorkers = clusterPar.NumWorkers;
     addParameter(p, 'NumWorkers', defaultNumWorkers,...
         @(x) x>=0 && x<=maxWorkers);
+    addParameter(p, 'TracePath', '', @ischar);
     parse(p, uttFiles, gmmPath, srcPitchPath, tgtPitchPath, outputPath,...
         varargin{:});
     specCov = p.Results.SpecCov;
     numWorkers = p.Results.NumWorkers;
+    tracePath = p.Results.TracePath;
     status = 0;
     numUtts = length(uttFiles);
     wavFiles = cell(numUtts, 1);
@@ -88,10 +99,22 @@ function [wavFiles, status] = voiceConversionInterfaceGSB(uttFiles, gmmPath, src
         tryCreateDir(outputPath);
     end
     
+    % Tracing
+    isTraceOwner = ~isempty(tracePath) && ~traceSpan('isOn');
+    if isTraceOwner
+        traceSpan('start');
+        traceGuard = onCleanup(@() traceSpan('stop'));
+    end
+    isTraced = traceSpan('isOn');
+    rootSpan = traceSpan('begin', 'voiceConversionInterfaceGSB');
+    
     % Load model files
+    span = traceSpan('begin', 'load/models');
     gmmMdl = load(gmmPath);
     srcPitchMdl = load(srcPitchPath);
     tgtPitchMdl = load(tgtPitchPath);
+    gmmMdl = warmConversionModel(gmmMdl);
+    traceSpan('end', span);
     
     % Setup parallel computing
     % Disable parallel computing if only one utterances
@@ -104,17 +127,39 @@ function [wavFiles, status] = voiceConversionInterfaceGSB(uttFiles, gmmPath, src
         numWorkers = numUtts;
     end
     
-    % Perform conversion
+    % Perform conversion. A worker has its own trace, which is merged into
+    % this one afterwards; in serial mode the spans go here directly
+    span = traceSpan('begin', 'convert');
+    workerTraces = cell(numUtts, 1);
     parfor (ii = 1:numUtts, numWorkers)
+        isWorkerTraced = isTraced && ~isempty(getCurrentTask());
+        if isWorkerTraced
+            traceSpan('start');
+        end
+        loadSpan = traceSpan('begin', 'load');
         utt = loadUttGSB(uttFiles(ii), 'RegExp', '^(?!post)\w');
+        traceSpan('end', loadSpan);
         covUtt = voiceConversionGSB(utt, gmmMdl, srcPitchMdl,...
-            tgtPitchMdl, 'SpecCov', specCov);
+            tgtPitchMdl, 'SpecCov', specCov, 'Outputs', {'wav'});
         
         % Each output file's name is the same as the corresponding mat file
+        writeSpan = traceSpan('begin', 'write');
         [uttDir, uttName, uttExt] = fileparts(uttFiles{ii});
         outputFile = fullfile(outputPath, sprintf('%s.wav', uttName));
         audiowrite(outputFile, covUtt.wav, covUtt.fs);
         wavFiles{ii} = outputFile;
+        traceSpan('end', writeSpan);
+        if isWorkerTraced
+            workerTraces{ii} = traceSpan('stop');
+        end
     end
+    for ii = 1:numUtts
+        traceSpan('merge', workerTraces{ii}, ii);
+    end
+    traceSpan('end', span);
     status = 1;
+    traceSpan('end', rootSpan);
+    if isTraceOwner
+        writeTrace(traceSpan('stop'), tracePath);
+    end
 end
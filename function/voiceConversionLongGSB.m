@@ -0,0 +1,253 @@
+% voiceConversionLongGSB: 'voiceConversionGSB' for long recordings, e.g.,
+% lectures and audiobooks. The trajectory solves of 'MLGV' and 'MLPG' are
+% over the whole utterance, so their memory and time grow much faster than
+% its length. Here the utterance is cut into chunks of about 'ChunkSec',
+% preferably in a silence (by 'utt.lab') or else at the frame with the
+% least energy near the nominal cut, each chunk is converted on its own,
+% with 'OverlapSec' of overlap on each side of a cut, and the converted
+% mcep, spectrum, mfcc, and waveform are crossfaded linearly over the
+% overlap. The chunks are converted in parallel. An utterance that fits in
+% one chunk is converted by 'voiceConversionGSB' as it is.
+%
+% Syntax: [covUtt, status] = voiceConversionLongGSB(utt, gmmMdl, srcPitchMdl, tgtPitchMdl)
+%
+% Inputs:
+%   utt: the source utt to be converted, analyzed with the WORLD vocoder
+%   gmmMdl: the joint GMM spectral model, see 'voiceConversionGSB'
+%   srcPitchMdl: source pitch model
+%   tgtPitchMdl: target pitch model
+%
+%   [Optional name-value pairs]
+%   'ChunkSec': nominal length of a chunk in seconds. Default to 30
+%   'OverlapSec': overlap on each side of a cut in seconds, at least a
+%   frame and at most a third of 'ChunkSec', the length of the crossfade
+%   is twice this. Default to 0.5
+%   'SearchSec': a cut is searched for in this many seconds before the
+%   nominal one. Default to 5
+%   'NumWorkers': number of parallel workers that convert the chunks.
+%   Default to 0, convert them in serial
+%   'Outputs': A cell array of strings. Any of 'mcep', 'spec', 'mfcc', and
+%   'wav', the converted mcep is always there. Unlike 'voiceConversionGSB',
+%   nothing is deferred. Default to {'mcep', 'wav'}
+%   Everything else is passed to 'voiceConversionGSB'.
+%
+% Outputs:
+%   covUtt: converted utterance
+%   status: 1 for success
+%
+% Other m-files required: voiceConversionGSB, pitchConversion
+%
+% Subfunctions: planChunks, sliceUtt, sliceFrames, crossfade
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: a chunk is at least three times the overlap, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function [covUtt, status] = voiceConversionLongGSB(utt, gmmMdl, srcPitchMdl, tgtPitchMdl, varargin)
+    p = inputParser;
+    p.KeepUnmatched = true;
+    addRequired(p, 'utt');
+    addRequired(p, 'gmmMdl');
+    addRequired(p, 'srcPitchMdl');
+    addRequired(p, 'tgtPitchMdl');
+    addParameter(p, 'ChunkSec', 30, @(x) isnumeric(x) && x>0);
+    addParameter(p, 'OverlapSec', 0.5, @(x) isnumeric(x) && x>0);
+    addParameter(p, 'SearchSec', 5, @(x) isnumeric(x) && x>=0);
+    addParameter(p, 'NumWorkers', 0, @(x) isnumeric(x) && x>=0);
+    addParameter(p, 'Outputs', {'mcep', 'wav'},...
+        @(x) all(ismember(cellstr(x), {'mcep', 'spec', 'mfcc', 'wav'})));
+    parse(p, utt, gmmMdl, srcPitchMdl, tgtPitchMdl, varargin{:});
+    outputs = union({'mcep'}, cellstr(p.Results.Outputs));
+    numWorkers = p.Results.NumWorkers;
+    convArgs = [fieldnames(p.Unmatched), struct2cell(p.Unmatched)]';
+    convArgs = [convArgs(:)', {'Outputs', outputs}];
+    assert(strcmp(utt.vocoder, 'WORLD'),...
+        'Chunked conversion supports the WORLD vocoder only.');
+    numFrames = size(utt.mcep, 2);
+    shiftSec = 0;
+    if numFrames > 1
+        shiftSec = utt.source.temporal_positions(2) -...
+            utt.source.temporal_positions(1);
+    end
+    chunkFrames = round(p.Results.ChunkSec/max([shiftSec, eps]));
+    overlapFrames = round(p.Results.OverlapSec/max([shiftSec, eps]));
+    searchFrames = round(p.Results.SearchSec/max([shiftSec, eps]));
+    if numFrames <= chunkFrames
+        [covUtt, status] = voiceConversionGSB(utt, gmmMdl, srcPitchMdl,...
+            tgtPitchMdl, convArgs{:});
+        return
+    end
+    % The last cut is at least an overlap before the end, so a chunk of
+    % three overlaps keeps the cuts two overlaps apart, see 'planChunks'
+    assert(overlapFrames >= 1 && chunkFrames >= 3*overlapFrames,...
+        ['The overlap must be at least a frame, and at most a third of ',...
+        'a chunk.']);
+
+    % Cut the utterance, every chunk is sent to a worker on its own
+    isSilent = false(1, numFrames);
+    if ~isempty(utt.lab)
+        isSilent = isnan(utt.lab(:)');
+    end
+    cuts = planChunks(utt.mcep(1, :), isSilent, chunkFrames,...
+        overlapFrames, searchFrames);
+    numChunks = length(cuts) - 1;
+    firstFrames = max(cuts(1:numChunks) - overlapFrames + 1, 1);
+    lastFrames = min(cuts(2:end) + overlapFrames, numFrames);
+    chunks = cell(numChunks, 1);
+    for ii = 1:numChunks
+        chunks{ii} = sliceUtt(utt, firstFrames(ii):lastFrames(ii),...
+            numFrames, shiftSec);
+    end
+    fprintf('Converting %d chunks with %d worker(s)...\n', numChunks,...
+        numWorkers);
+    results = cell(numChunks, 1);
+    chunkStatus = zeros(numChunks, 1);
+    parfor (ii = 1:numChunks, numWorkers)
+        [chunkUtt, chunkStatus(ii)] = voiceConversionGSB(chunks{ii},...
+            gmmMdl, srcPitchMdl, tgtPitchMdl, convArgs{:});
+        % Only the converted outputs are sent back
+        results{ii} = rmfield(chunkUtt, setdiff(fieldnames(chunkUtt),...
+            outputs));
+        chunks{ii} = [];
+    end
+    clear chunks
+
+    % Crossfade the chunks, the converted F0 is per frame, so it is the
+    % same as converting the whole utterance
+    covUtt = pitchConversion(utt, srcPitchMdl, tgtPitchMdl);
+    covUtt = rmfield(covUtt, intersect(fieldnames(covUtt),...
+        {'spec', 'mfcc', 'wav'}));
+    fadeFrames = 2*overlapFrames*ones(1, numChunks-1);
+    for field = intersect(outputs, {'mcep', 'spec', 'mfcc'})
+        covUtt.(field{1}) = crossfade(results, field{1}, firstFrames,...
+            numFrames, fadeFrames);
+    end
+    if ismember('spec', outputs)
+        covUtt.filter.spectrogram = covUtt.spec;
+    else
+        covUtt.filter.spectrogram = [];
+    end
+    if ismember('wav', outputs)
+        % Chunk 'ii' starts at the time of its first frame
+        firstSamples = round((firstFrames-1)*shiftSec*utt.fs) + 1;
+        numSamples = cellfun(@(x) length(x.wav), results)';
+        lastSamples = firstSamples + numSamples - 1;
+        fadeSamples = max(lastSamples(1:(end-1)) -...
+            firstSamples(2:end) + 1, 0);
+        fadeSamples = min([fadeSamples; numSamples(1:(end-1));...
+            numSamples(2:end)], [], 1);
+        for ii = 1:numChunks
+            results{ii}.wav = results{ii}.wav(:)';
+        end
+        covUtt.wav = crossfade(results, 'wav', firstSamples,...
+            max(lastSamples), fadeSamples)';
+    end
+    status = double(all(chunkStatus == 1));
+end
+
+% The last frame of each chunk, 0 first. A cut is at least twice the
+% overlap after the previous one, so that the crossfades do not overlap,
+% and the silent frames near the nominal cut are preferred. The last cut
+% is at least an overlap before the end, which keeps it twice the overlap
+% after the previous one only if 'chunkFrames' is three overlaps or more.
+function cuts = planChunks(energy, isSilent, chunkFrames, overlapFrames, searchFrames)
+    numFrames = length(energy);
+    cuts = 0;
+    while numFrames - cuts(end) > chunkFrames
+        nominal = cuts(end) + chunkFrames;
+        upper = min([nominal, numFrames - overlapFrames]);
+        lower = min([max([nominal - searchFrames,...
+            cuts(end) + 2*overlapFrames]), upper]);
+        candidates = lower:upper;
+        if any(isSilent(candidates))
+            candidates = candidates(isSilent(candidates));
+        end
+        [~, best] = min(energy(candidates));
+        cuts(end+1) = candidates(best); %#ok<AGROW>
+    end
+    cuts(end+1) = numFrames;
+end
+
+% A chunk of an utt, with the per-frame fields cut to 'frames', and its
+% time starting from 0 so that it is synthesized on its own
+function chunk = sliceUtt(utt, frames, numFrames, shiftSec)
+    chunk = utt;
+    for field = {'mcep', 'spec', 'mfcc', 'lab', 'post'}
+        if isfield(utt, field{1})
+            chunk.(field{1}) = sliceFrames(utt.(field{1}), frames,...
+                numFrames);
+        end
+    end
+    for field = {'source', 'filter'}
+        for subfield = fieldnames(utt.(field{1}))'
+            chunk.(field{1}).(subfield{1}) = sliceFrames(...
+                utt.(field{1}).(subfield{1}), frames, numFrames);
+        end
+        chunk.(field{1}).temporal_positions =...
+            chunk.(field{1}).temporal_positions -...
+            chunk.(field{1}).temporal_positions(1);
+    end
+    firstSample = round((frames(1)-1)*shiftSec*utt.fs) + 1;
+    lastSample = min([round((frames(end)-1)*shiftSec*utt.fs) + 1,...
+        length(utt.wav)]);
+    chunk.wav = utt.wav(firstSample:lastSample);
+    % The alignment is not needed to convert, and can be big
+    for field = {'tg', 'phones', 'words'}
+        if isfield(utt, field{1})
+            chunk.(field{1}) = [];
+        end
+    end
+end
+
+% Cut a per-frame vector or D*T matrix, anything else is kept
+function x = sliceFrames(x, frames, numFrames)
+    if ~isnumeric(x) || isscalar(x)
+        return
+    end
+    if isvector(x) && length(x) == numFrames
+        x = x(frames);
+    elseif size(x, 2) == numFrames
+        x = x(:, frames);
+    end
+end
+
+% Weighted sum of the chunks, each column of the output is covered by one
+% chunk, or by two with linear weights that add up to 1
+function x = crossfade(results, field, firstCols, numCols, fadeCols)
+    numChunks = length(results);
+    x = zeros(size(results{1}.(field), 1), numCols);
+    for ii = 1:numChunks
+        y = results{ii}.(field);
+        len = size(y, 2);
+        weights = ones(1, len);
+        if ii > 1
+            n = fadeCols(ii-1);
+            weights(1:n) = (1:n)/(n+1);
+        end
+        if ii < numChunks
+            n = fadeCols(ii);
+            weights((len-n+1):len) = (n:-1:1)/(n+1);
+        end
+        cols = firstCols(ii):(firstCols(ii) + len - 1);
+        x(:, cols) = x(:, cols) + bsxfun(@times, y, weights);
+    end
+end
@@ -0,0 +1,86 @@
+% warmConversionModel: precompute the per-mixture quantities that the
+% spectral conversion ('spectralMapping_MMSE', 'spectralMapping_MLPG', and
+% 'spectralMapping_MLTrajGV') would otherwise recompute from the GMM for
+% every utterance, i.e., the regression of Y on X and the inverse of the
+% conditional covariance of Y, and attach them to the model. Call it once
+% per model and reuse the output for any number of conversions.
+%
+% Syntax: gmmMdl = warmConversionModel(gmmMdl)
+%
+% Inputs:
+%   gmmMdl: A struct. The joint GMM spectral model from 'buildGMMmodelGSB',
+%   X and Y have the same dimension.
+%
+% Outputs:
+%   gmmMdl: A struct. The same model with a 'cache' field,
+%       - regression: a Dy*Dx*M array, E(y|x,m) = regression(:,:,m)*x +
+%       bias(:,m)
+%       - bias: a Dy*M matrix
+%       - DyInv: a Dy*Dy*M array, the inverse of cov(y|x,m)
+%       - key: the content hash of the model, used as part of the result
+%       cache keys, see 'resultCache'
+%
+% Other m-files required: resultCache
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+%   10/18/2026: add the model hash, GZ
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function gmmMdl = warmConversionModel(gmmMdl)
+    if isfield(gmmMdl, 'cache')
+        gmmMdl = rmfield(gmmMdl, 'cache');
+    end
+    cache.key = resultCache('key', gmmMdl);
+    mix = gmmMdl.mix;
+    numMix = mix.ncentres;
+    xInd = 1:(mix.nin/2);
+    yInd = (mix.nin/2 + 1):mix.nin;
+    xDim = length(xInd);
+    yDim = length(yInd);
+    
+    cache.regression = zeros(yDim, xDim, numMix);
+    cache.bias = zeros(yDim, numMix);
+    cache.DyInv = zeros(yDim, yDim, numMix);
+    for ii = 1:numMix
+        muX = mix.centres(ii, xInd)';
+        muY = mix.centres(ii, yInd)';
+        switch mix.covar_type
+            case 'full'
+                covYX = mix.covars(yInd, xInd, ii);
+                covXX = mix.covars(xInd, xInd, ii);
+                covXY = mix.covars(xInd, yInd, ii);
+                covYY = mix.covars(yInd, yInd, ii);
+                regression = covYX/covXX;
+                cache.DyInv(:, :, ii) = inv(covYY - regression*covXY);
+            case 'diag'
+                regression = zeros(yDim, xDim);
+                cache.DyInv(:, :, ii) = diag(1./mix.covars(ii, yInd));
+            otherwise
+                error('Unsupported covariance type ''%s''.', mix.covar_type);
+        end
+        cache.regression(:, :, ii) = regression;
+        cache.bias(:, ii) = muY - regression*muX;
+    end
+    gmmMdl.cache = cache;
+end
@@ -0,0 +1,82 @@
+% writeArk: write matrices (e.g., the PPGs of many utts) to a Kaldi binary
+% ark file and its scp index, as float matrices or as Kaldi compressed
+% matrices, with the native writer 'mexarkwrite'. 'cm' is what Kaldi uses
+% for compressed features, about 4x smaller than 'float'; 'cm2' is about 2x
+% smaller with a much smaller error. The ark and the scp appear only after
+% everything has been written. Read them back with 'readArk'; Kaldi tools
+% can read them too.
+%
+% Syntax: offsets = writeArk(arkFile, keys, mats)
+%
+% Inputs:
+%   arkFile: A string. Path to the output ark file, overwritten.
+%   keys: A cell array of N strings. Utterance ids, without whitespace.
+%   mats: A cell array of N matrices. Each one is D*T, one frame per
+%   column, as 'utt.post'.
+%
+%   [Optional name-value pairs]
+%   'Format': 'float' (*) | 'cm' | 'cm2'
+%   'ScpFile': A string. Path to the scp file, default to the ark path with
+%   '.ark' replaced by '.scp' (or '.scp' appended), '' for no scp
+%
+% Outputs:
+%   offsets: A N*1 vector. The byte offset of each matrix in the ark, as in
+%   the scp.
+%
+% Other m-files required: mexarkwrite (compiled, see
+% script/installArkWriter.m), tryCreateDir
+%
+% Subfunctions: None
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function offsets = writeArk(arkFile, keys, mats, varargin)
+    p = inputParser;
+    addRequired(p, 'arkFile', @ischar);
+    addRequired(p, 'keys', @iscellstr);
+    addRequired(p, 'mats', @iscell);
+    addParameter(p, 'Format', 'float', @(x) ismember(x,...
+        {'float', 'cm', 'cm2'}));
+    addParameter(p, 'ScpFile', [], @(x) isempty(x) || ischar(x));
+    parse(p, arkFile, keys, mats, varargin{:});
+    format = p.Results.Format;
+    scpFile = p.Results.ScpFile;
+    if isnumeric(scpFile)
+        scpFile = regexprep(arkFile, '\.ark$', '');
+        scpFile = [scpFile, '.scp'];
+    end
+    assert(numel(keys) == numel(mats),...
+        'Need one key per matrix, got %d keys and %d matrices.',...
+        numel(keys), numel(mats));
+    assert(~any(cellfun(@(x) isempty(x) || any(isspace(x)), keys)),...
+        'The keys cannot be empty or contain whitespace.');
+    if exist('mexarkwrite', 'file') ~= 3
+        error(['mexarkwrite is not compiled, run ',...
+            'script/installArkWriter.m first.']);
+    end
+    arkDir = fileparts(arkFile);
+    if ~isempty(arkDir) && ~exist(arkDir, 'dir')
+        tryCreateDir(arkDir);
+    end
+    offsets = mexarkwrite(arkFile, scpFile, keys(:), mats(:), format);
+end
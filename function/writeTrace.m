@@ -0,0 +1,131 @@
+% writeTrace: export a trace from 'traceSpan' as a Chrome trace-event JSON
+% file, which can be opened in chrome://tracing or https://ui.perfetto.dev,
+% and print a summary table of the spans grouped by name.
+%
+% Syntax: summary = writeTrace(trace)
+%         summary = writeTrace(trace, jsonPath)
+%
+% Inputs:
+%   trace: A struct. Output of traceSpan('stop').
+%   jsonPath: A string. Path to the JSON file, will overwrite the existing
+%   file. Default to '', which only prints the summary.
+%
+% Outputs:
+%   summary: A struct array, one per span name, in the order they first
+%   started, with 'name', 'count', 'totalSec', 'meanMs', 'maxMs',
+%   'numFrames', 'framesPerSec', and 'peakMB'.
+%
+% Other m-files required: tryCreateDir
+%
+% Subfunctions: escapeJson
+%
+% MAT-file required: None
+%
+% Author: Guanlong Zhao
+% Email: gzhao@tamu.edu
+% Created: 10/18/2026; Last revision: 10/18/2026
+% Revision log:
+%   10/18/2026: function creation, Guanlong Zhao
+
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+function summary = writeTrace(trace, jsonPath)
+    if nargin < 2
+        jsonPath = '';
+    end
+    spans = trace.spans;
+    numSpans = length(spans);
+
+    % Chrome trace events, one complete ('X') event per span
+    if ~isempty(jsonPath)
+        outputDir = fileparts(jsonPath);
+        if ~isempty(outputDir) && ~exist(outputDir, 'dir')
+            tryCreateDir(outputDir);
+        end
+        fid = fopen(jsonPath, 'w');
+        if fid < 0
+            error('Cannot write the trace to %s.', jsonPath);
+        end
+        fprintf(fid, '{"displayTimeUnit": "ms", "traceEvents": [\n');
+        for ii = 1:numSpans
+            args = '';
+            if ~isnan(spans(ii).numFrames)
+                args = sprintf('"frames": %d, ', spans(ii).numFrames);
+            end
+            if ~isnan(spans(ii).peakBytes)
+                args = sprintf('%s"peak_mb": %.1f, ', args,...
+                    spans(ii).peakBytes/2^20);
+            end
+            args = sprintf('%s"depth": %d', args, spans(ii).depth);
+            separator = ',';
+            if ii == numSpans
+                separator = '';
+            end
+            fprintf(fid, ['{"name": "%s", "cat": "vc", "ph": "X", ',...
+                '"ts": %.0f, "dur": %.0f, "pid": 0, "tid": %d, ',...
+                '"args": {%s}}%s\n'], escapeJson(spans(ii).name),...
+                spans(ii).startUs, spans(ii).durationUs,...
+                spans(ii).threadId, args, separator);
+        end
+        fprintf(fid, ']}\n');
+        fclose(fid);
+        fprintf('Trace saved to %s\n', jsonPath);
+    end
+
+    % Group the spans by name
+    [names, firstIdx, groupIdx] = unique({spans.name}, 'stable');
+    numGroups = length(names);
+    summary = struct('name', names(:), 'count', [], 'totalSec', [],...
+        'meanMs', [], 'maxMs', [], 'numFrames', [], 'framesPerSec', [],...
+        'peakMB', []);
+    for ii = 1:numGroups
+        group = spans(groupIdx == ii);
+        durations = [group.durationUs]/1e6;
+        frames = [group.numFrames];
+        summary(ii).count = length(group);
+        summary(ii).totalSec = sum(durations);
+        summary(ii).meanMs = mean(durations)*1000;
+        summary(ii).maxMs = max(durations)*1000;
+        summary(ii).numFrames = sum(frames(~isnan(frames)));
+        summary(ii).framesPerSec = NaN;
+        if any(~isnan(frames))
+            summary(ii).framesPerSec = summary(ii).numFrames/...
+                sum(durations(~isnan(frames)));
+        end
+        summary(ii).peakMB = max([group.peakBytes])/2^20;
+    end
+
+    % Print the table, indented by the depth of the first span of a name
+    if numSpans > 0
+        wallSec = (max([spans.startUs] + [spans.durationUs]) -...
+            min([spans.startUs]))/1e6;
+    end
+    fprintf('%-32s %7s %10s %6s %10s %10s %12s %9s\n', 'Span', 'Count',...
+        'Total (s)', 'Wall%', 'Mean (ms)', 'Max (ms)', 'Frames/s',...
+        'Peak (MB)');
+    for ii = 1:numGroups
+        name = [repmat('  ', 1, spans(firstIdx(ii)).depth), names{ii}];
+        fprintf('%-32s %7d %10.3f %6.1f %10.2f %10.2f %12.1f %9.1f\n',...
+            name, summary(ii).count, summary(ii).totalSec,...
+            100*summary(ii).totalSec/wallSec, summary(ii).meanMs,...
+            summary(ii).maxMs, summary(ii).framesPerSec,...
+            summary(ii).peakMB);
+    end
+end
+
+function str = escapeJson(str)
+    str = strrep(str, '\', '\\');
+    str = strrep(str, '"', '\"');
+end
@@ -0,0 +1,617 @@
+/******************************************************************
+ * benchNativeKernels: microbenchmark of the native kernels used by the
+ * spectral features, i.e., freqt, frqtr, theq, mgc2sp/fftr (in
+ * mexmcep2spec.c), the HTK to Kaldi ark converter htk2ark, and the
+ * buffered ark writer of mexarkwrite.c (float, 'CM', and 'CM2'). The
+ * spectral kernels are timed twice, the generic kernel and the fixed-shape
+ * one of fixedKernels.h (the ones ending in '/fixed'), and their outputs
+ * are compared first. The
+ * kernels are built from the same sources as the mex files, without
+ * Matlab, and driven by synthetic data at the settings used by
+ * spec2mcep.m and mcep2spec.m: 513 frequency bins (FFT length 1024),
+ * 24th order mel-cepstra, and alpha in [0.31, 0.554].
+ *
+ * Each benchmark prints one JSON object per line to stdout,
+ *   {"bench": ..., "alpha": ..., "frames": ..., "seconds": ...,
+ *    "frames_per_sec": ..., "ns_per_frame": ..., "allocs": ...,
+ *    "alloc_bytes": ..., "frees": ..., "mb_per_sec": ...}
+ * 'allocs', 'alloc_bytes', and 'frees' count the heap allocations made by
+ * the kernel code itself (malloc, calloc, and realloc, which counts as one
+ * allocation of the new size) during the timed loop, after one warm-up
+ * call (stdio buffers are not counted, so htk2ark, which only uses stdio,
+ * reports none). 'mb_per_sec' is the input plus output
+ * bytes of the kernel per second. The comparisons print
+ *   {"check": ..., "alpha": ..., "max_abs_diff": ...}
+ *
+ * Usage: benchNativeKernels [num_frames] [num_htk_files]
+ *   num_frames: frames per kernel benchmark, default to 20000
+ *   num_htk_files: synthetic HTK files converted by htk2ark, default to
+ *   200, each one has 1000 frames of 40-dim features; the ark writer
+ *   writes the same number of utterances of the same size
+ *
+ * Compilation (from this folder):
+ *   gcc -std=c99 -O2 -Wall benchNativeKernels.c -o benchNativeKernels -lm
+ *
+ * Guanlong Zhao (gzhao@tamu.edu)
+ * Created: 10/18/2026
+ * Last Modified: 10/18/2026
+ * Revision log:
+ *  10/18/2026: function creation, GZ
+ *  10/18/2026: add the ark writer, GZ
+ *  10/18/2026: time and check the fixed-shape kernels, GZ
+ *  10/18/2026: count malloc and realloc too, GZ
+ *  10/18/2026: fftr has no fixed-shape kernel any more, GZ
+ *
+ * Copyright 2026 Guanlong Zhao
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+****************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/* Allocation counters, the kernel sources below allocate with malloc,
+   calloc, and realloc */
+static long benchAllocs = 0;
+static long benchAllocBytes = 0;
+static long benchFrees = 0;
+
+static void *benchCalloc(size_t num, size_t size)
+{
+   benchAllocs++;
+   benchAllocBytes += (long) (num * size);
+   return calloc(num, size);
+}
+
+static void *benchMalloc(size_t size)
+{
+   benchAllocs++;
+   benchAllocBytes += (long) size;
+   return malloc(size);
+}
+
+static void *benchRealloc(void *ptr, size_t size)
+{
+   benchAllocs++;
+   benchAllocBytes += (long) size;
+   return realloc(ptr, size);
+}
+
+static void benchFree(void *ptr)
+{
+   if (ptr != NULL)
+      benchFrees++;
+   free(ptr);
+}
+
+#define malloc benchMalloc
+#define calloc benchCalloc
+#define realloc benchRealloc
+#define free benchFree
+
+/* The kernel sources share helper names, so each one gets a prefix */
+#define getmem freqt_getmem
+#define dgetmem freqt_dgetmem
+#define fillz freqt_fillz
+#define movem freqt_movem
+#include "../dependency/mcep-sptk-matlab/freqt.c"
+#undef getmem
+#undef dgetmem
+#undef fillz
+#undef movem
+
+#define getmem frqtr_getmem
+#define dgetmem frqtr_dgetmem
+#define fillz frqtr_fillz
+#define movem frqtr_movem
+#include "../dependency/mcep-sptk-matlab/frqtr.c"
+#undef getmem
+#undef dgetmem
+#undef fillz
+#undef movem
+
+#include "../dependency/mcep-sptk-matlab/theq.c"
+
+#define getmem mcep2spec_getmem
+#define dgetmem mcep2spec_dgetmem
+#define fillz mcep2spec_fillz
+#define movem mcep2spec_movem
+#define freqt mcep2spec_freqt
+#include "../dependency/mcep-sptk-matlab/mexmcep2spec.c"
+#undef getmem
+#undef dgetmem
+#undef fillz
+#undef movem
+#undef freqt
+
+/* htk2ark.c is third-party code, gcc cannot tell that two of its locals
+   are always set before they are used */
+#define main htk2ark_main
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include "../dependency/kaldi2matlab/htk2ark.c"
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#undef main
+
+#include "../dependency/kaldi2matlab/mexarkwrite.c"
+
+#undef malloc
+#undef calloc
+#undef realloc
+#undef free
+
+#define NUM_BINS 513 /* spectrum bins */
+#define FFT_LENGTH 1024 /* (NUM_BINS - 1)*2 */
+#define ORDER 24 /* mel-cepstrum order */
+#define NUM_ALPHAS 3
+
+static const double alphas[NUM_ALPHAS] = {0.31, 0.42, 0.554};
+
+/* A small deterministic generator, so runs are comparable */
+static unsigned long benchSeed = 12345;
+
+static double benchRand(void)
+{
+   benchSeed = benchSeed * 1103515245UL + 12345UL;
+   return ((benchSeed >> 16) & 0x7fff) / 32768.0 - 0.5;
+}
+
+static double benchNow(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void resetCounters(void)
+{
+   benchAllocs = 0;
+   benchAllocBytes = 0;
+   benchFrees = 0;
+}
+
+static void report(const char *bench, const double alpha, const long frames,
+                   const double seconds, const double bytesPerFrame)
+{
+   printf("{\"bench\": \"%s\", \"alpha\": %.3f, \"frames\": %ld, "
+          "\"seconds\": %.6f, \"frames_per_sec\": %.1f, "
+          "\"ns_per_frame\": %.1f, \"allocs\": %ld, \"alloc_bytes\": %ld, "
+          "\"frees\": %ld, \"mb_per_sec\": %.2f}\n",
+          bench, alpha, frames, seconds, frames / seconds,
+          seconds * 1e9 / frames, benchAllocs, benchAllocBytes, benchFrees,
+          bytesPerFrame * frames / seconds / 1e6);
+   fflush(stdout);
+}
+
+/* Synthetic cepstra that decay with the quefrency, like real speech */
+static void fillCepstra(double *c, const int n, const long frames)
+{
+   long i;
+
+   for (i = 0; i < n * frames; i++)
+      c[i] = benchRand() / (1.0 + (double) (i % n));
+}
+
+/* spec2mcep.m: cepstrum (513) -> mel-cepstrum (order 24) */
+static void benchFreqtAnalysis(const long frames, const double alpha,
+                               const int isFixed)
+{
+   const int n = NUM_BINS;
+   double *in = malloc(sizeof(double) * n * frames);
+   double out[ORDER + 1];
+   double t0;
+   long f;
+
+   fillCepstra(in, n, frames);
+   freqt(in, NUM_BINS - 1, out, ORDER, alpha);
+   resetCounters();
+   t0 = benchNow();
+   if (isFixed)
+      for (f = 0; f < frames; f++)
+         freqt512to24(in + f * n, out, alpha);
+   else
+      for (f = 0; f < frames; f++)
+         freqt(in + f * n, NUM_BINS - 1, out, ORDER, alpha);
+   report(isFixed ? "freqt_analysis/fixed" : "freqt_analysis", alpha,
+          frames, benchNow() - t0, sizeof(double) * (NUM_BINS + ORDER + 1));
+   free(in);
+}
+
+/* spec2mcep.m: mel-cepstrum (order 24) -> cepstrum (512) */
+static void benchFreqtSynthesis(const long frames, const double alpha,
+                                const int isFixed)
+{
+   const int n = ORDER + 1;
+   double *in = malloc(sizeof(double) * n * frames);
+   double out[FFT_LENGTH / 2 + 1];
+   double t0;
+   long f;
+
+   fillCepstra(in, n, frames);
+   freqt(in, ORDER, out, FFT_LENGTH / 2, -alpha);
+   resetCounters();
+   t0 = benchNow();
+   if (isFixed)
+      for (f = 0; f < frames; f++)
+         freqt24to512(in + f * n, out, -alpha);
+   else
+      for (f = 0; f < frames; f++)
+         freqt(in + f * n, ORDER, out, FFT_LENGTH / 2, -alpha);
+   report(isFixed ? "freqt_synthesis/fixed" : "freqt_synthesis", alpha,
+          frames, benchNow() - t0,
+          sizeof(double) * (ORDER + 1 + FFT_LENGTH / 2 + 1));
+   free(in);
+}
+
+/* spec2mcep.m: IFFT (1024) -> r(k) (order 48) */
+static void benchFrqtr(const long frames, const double alpha,
+                       const int isFixed)
+{
+   const int n = FFT_LENGTH;
+   double *in = malloc(sizeof(double) * n * frames);
+   double out[2 * ORDER + 1];
+   double t0;
+   long f;
+
+   fillCepstra(in, n, frames);
+   frqtr(in, FFT_LENGTH - 1, out, 2 * ORDER, alpha);
+   resetCounters();
+   t0 = benchNow();
+   if (isFixed)
+      for (f = 0; f < frames; f++)
+         frqtr1023to48(in + f * n, out, alpha);
+   else
+      for (f = 0; f < frames; f++)
+         frqtr(in + f * n, FFT_LENGTH - 1, out, 2 * ORDER, alpha);
+   report(isFixed ? "frqtr/fixed" : "frqtr", alpha, frames,
+          benchNow() - t0, sizeof(double) * (FFT_LENGTH + 2 * ORDER + 1));
+   free(in);
+}
+
+/* A diagonally dominant Toeplitz plus Hankel system, alpha shapes the
+   decay */
+static void fillTheq(double *t, double *h, double *b, const int n,
+                     const double alpha)
+{
+   int i;
+
+   for (i = 0; i < n; i++) {
+      t[i] = (i == 0 ? 4.0 : 0.0) + pow(alpha, i) * (1.0 + 0.1 * benchRand());
+      b[i] = benchRand();
+   }
+   for (i = 0; i < 2 * n - 1; i++)
+      h[i] = 0.1 * pow(alpha, abs(i - n + 1)) * benchRand();
+}
+
+/* spec2mcep.m: one Newton-Raphson step, (T + H) a = b with n = 25 */
+static void benchTheq(const long frames, const double alpha,
+                      const int isFixed)
+{
+   const int n = ORDER + 1;
+   double t[ORDER + 1], h[2 * ORDER + 1], b[ORDER + 1], a[ORDER + 1];
+   double t0;
+   long f;
+
+   fillTheq(t, h, b, n, alpha);
+   theq(t, h, a, b, n, 1.0e-6);
+   resetCounters();
+   t0 = benchNow();
+   for (f = 0; f < frames; f++) {
+      b[f % n] += 1.0e-9; /* keep the compiler honest */
+      if (isFixed)
+         theq25(t, h, a, b, 1.0e-6);
+      else
+         theq(t, h, a, b, n, 1.0e-6);
+   }
+   report(isFixed ? "theq/fixed" : "theq", alpha, frames, benchNow() - t0,
+          sizeof(double) * (n + 2 * n - 1 + n + n));
+}
+
+/* mcep2spec.m: mel-cepstrum (order 24) -> log spectrum, without the exp */
+static void benchMgc2sp(const long frames, const double alpha)
+{
+   const int n = ORDER + 1;
+   double *in = malloc(sizeof(double) * n * frames);
+   double x[FFT_LENGTH], y[FFT_LENGTH];
+   double t0;
+   long f;
+
+   fillCepstra(in, n, frames);
+   mgc2sp(in, ORDER, alpha, 0.0, x, y, FFT_LENGTH);
+   resetCounters();
+   t0 = benchNow();
+   for (f = 0; f < frames; f++)
+      mgc2sp(in + f * n, ORDER, alpha, 0.0, x, y, FFT_LENGTH);
+   report("mgc2sp", alpha, frames, benchNow() - t0,
+          sizeof(double) * (n + NUM_BINS));
+   free(in);
+}
+
+/* The real FFT inside mgc2sp, alpha does not matter */
+static void benchFftr(const long frames)
+{
+   double *in = malloc(sizeof(double) * FFT_LENGTH * 4);
+   double x[FFT_LENGTH], y[FFT_LENGTH];
+   double t0;
+   long f;
+
+   fillCepstra(in, FFT_LENGTH, 4);
+   resetCounters();
+   t0 = benchNow();
+   for (f = 0; f < frames; f++) {
+      memcpy(x, in + (f % 4) * FFT_LENGTH, sizeof(x));
+      fftr(x, y, FFT_LENGTH);
+   }
+   report("fftr", 0.0, frames, benchNow() - t0,
+          sizeof(double) * 3 * FFT_LENGTH);
+   free(in);
+}
+
+/* mcep2spec.m: the whole mex call, mel-cepstrum -> 513-bin spectrum */
+static void benchMcep2spec(const long frames, const double alpha,
+                           const int isFixed)
+{
+   const int n = ORDER + 1;
+   double *in = malloc(sizeof(double) * n * frames);
+   double sp[NUM_BINS];
+   double t0;
+   long f;
+
+   fillCepstra(in, n, frames);
+   mexmcep2spec(in, ORDER, alpha, 0.0, sp, FFT_LENGTH);
+   mcep2specGeneric(in, ORDER, alpha, 0.0, sp, FFT_LENGTH);
+   resetCounters();
+   t0 = benchNow();
+   if (isFixed)
+      for (f = 0; f < frames; f++)
+         mexmcep2spec(in + f * n, ORDER, alpha, 0.0, sp, FFT_LENGTH);
+   else
+      for (f = 0; f < frames; f++)
+         mcep2specGeneric(in + f * n, ORDER, alpha, 0.0, sp, FFT_LENGTH);
+   report(isFixed ? "mcep2spec/fixed" : "mcep2spec", alpha, frames,
+          benchNow() - t0, sizeof(double) * (n + NUM_BINS));
+   free(in);
+}
+
+static double maxAbsDiff(const double *x, const double *y, const int n)
+{
+   double d = 0.0;
+   int i;
+
+   for (i = 0; i < n; i++)
+      if (fabs(x[i] - y[i]) > d || isnan(x[i] - y[i]))
+         d = fabs(x[i] - y[i]);
+   return d;
+}
+
+static void reportCheck(const char *check, const double alpha,
+                        const double diff)
+{
+   printf("{\"check\": \"%s\", \"alpha\": %.3f, \"max_abs_diff\": %g}\n",
+          check, alpha, diff);
+   fflush(stdout);
+}
+
+/* The fixed-shape kernels against the generic ones on the same input */
+static void checkFixed(const double alpha)
+{
+   double in[FFT_LENGTH], x1[FFT_LENGTH], x2[FFT_LENGTH];
+   double t[ORDER + 1], h[2 * ORDER + 1], b[ORDER + 1];
+
+   fillCepstra(in, FFT_LENGTH, 1);
+   freqt(in, NUM_BINS - 1, x1, ORDER, alpha);
+   freqt512to24(in, x2, alpha);
+   reportCheck("freqt_analysis", alpha, maxAbsDiff(x1, x2, ORDER + 1));
+
+   freqt(in, ORDER, x1, FFT_LENGTH / 2, -alpha);
+   freqt24to512(in, x2, -alpha);
+   reportCheck("freqt_synthesis", alpha,
+               maxAbsDiff(x1, x2, FFT_LENGTH / 2 + 1));
+
+   frqtr(in, FFT_LENGTH - 1, x1, 2 * ORDER, alpha);
+   frqtr1023to48(in, x2, alpha);
+   reportCheck("frqtr", alpha, maxAbsDiff(x1, x2, 2 * ORDER + 1));
+
+   fillTheq(t, h, b, ORDER + 1, alpha);
+   theq(t, h, x1, b, ORDER + 1, 1.0e-6);
+   theq25(t, h, x2, b, 1.0e-6);
+   reportCheck("theq", alpha, maxAbsDiff(x1, x2, ORDER + 1));
+
+   /* Not bit for bit, c[0] goes through exp and log in the generic one */
+   mcep2specGeneric(in, ORDER, alpha, 0.0, x1, FFT_LENGTH);
+   mexmcep2spec(in, ORDER, alpha, 0.0, x2, FFT_LENGTH);
+   reportCheck("mcep2spec", alpha, maxAbsDiff(x1, x2, NUM_BINS));
+}
+
+/* Write a big-endian HTK feature file */
+static void writeHtk(const char *fileName, const int numFrames, const int dim)
+{
+   FILE *fid = fopen(fileName, "wb");
+   unsigned char header[12];
+   unsigned char sample[4];
+   int i, j;
+   float value;
+   unsigned int bits;
+   const unsigned int period = 50000; /* 5 ms in 100 ns */
+
+   if (fid == NULL) {
+      fprintf(stderr, "Cannot write %s!\n", fileName);
+      exit(1);
+   }
+   header[0] = (numFrames >> 24) & 0xff;
+   header[1] = (numFrames >> 16) & 0xff;
+   header[2] = (numFrames >> 8) & 0xff;
+   header[3] = numFrames & 0xff;
+   header[4] = (period >> 24) & 0xff;
+   header[5] = (period >> 16) & 0xff;
+   header[6] = (period >> 8) & 0xff;
+   header[7] = period & 0xff;
+   header[8] = ((dim * 4) >> 8) & 0xff;
+   header[9] = (dim * 4) & 0xff;
+   header[10] = 0;
+   header[11] = 9; /* USER */
+   fwrite(header, 1, 12, fid);
+   for (i = 0; i < numFrames; i++) {
+      for (j = 0; j < dim; j++) {
+         value = (float) benchRand();
+         memcpy(&bits, &value, 4);
+         sample[0] = (bits >> 24) & 0xff;
+         sample[1] = (bits >> 16) & 0xff;
+         sample[2] = (bits >> 8) & 0xff;
+         sample[3] = bits & 0xff;
+         fwrite(sample, 1, 4, fid);
+      }
+   }
+   fclose(fid);
+}
+
+/* htk2ark over a list of synthetic HTK files */
+static void benchHtk2ark(const int numFiles)
+{
+   const int numFrames = 1000, dim = 40;
+   char tempDir[] = "/tmp/htk2arkbenchXXXXXX";
+   char fileName[1000], listName[1000], arkName[1000], scpName[1000];
+   char *argv[3];
+   FILE *list;
+   double t0, seconds;
+   int i, status;
+
+   if (mkdtemp(tempDir) == NULL) {
+      fprintf(stderr, "Cannot create a temp dir!\n");
+      exit(1);
+   }
+   sprintf(listName, "%s/list.txt", tempDir);
+   sprintf(arkName, "%s/feats.ark", tempDir);
+   sprintf(scpName, "%s/feats.scp", tempDir);
+   list = fopen(listName, "w");
+   for (i = 0; i < numFiles; i++) {
+      sprintf(fileName, "%s/utt_%04d.fea", tempDir, i);
+      writeHtk(fileName, numFrames, dim);
+      fprintf(list, "%s\n", fileName);
+   }
+   fclose(list);
+
+   argv[0] = "htk2ark";
+   argv[1] = listName;
+   argv[2] = arkName;
+   resetCounters();
+   t0 = benchNow();
+   status = htk2ark_main(3, argv);
+   seconds = benchNow() - t0;
+   if (status != 0)
+      fprintf(stderr, "htk2ark failed with status %d!\n", status);
+   report("htk2ark", 0.0, (long) numFiles * numFrames, seconds,
+          2.0 * sizeof(float) * dim);
+
+   for (i = 0; i < numFiles; i++) {
+      sprintf(fileName, "%s/utt_%04d.fea", tempDir, i);
+      remove(fileName);
+   }
+   remove(listName);
+   remove(arkName);
+   remove(scpName);
+   rmdir(tempDir);
+}
+
+/* The ark writer of mexarkwrite.c, same utterances as htk2ark */
+static void benchArkWrite(const int numFiles, const int format,
+                          const char *name)
+{
+   const int numFrames = 1000, dim = 40;
+   char tempDir[] = "/tmp/arkwritebenchXXXXXX";
+   char arkName[1000], key[64];
+   float *data, *work;
+   ArkWriter w;
+   double t0, seconds;
+   long i;
+   int n;
+
+   if (mkdtemp(tempDir) == NULL) {
+      fprintf(stderr, "Cannot create a temp dir!\n");
+      exit(1);
+   }
+   sprintf(arkName, "%s/feats.ark", tempDir);
+   data = (float *) malloc(sizeof(float) * numFrames * dim);
+   work = (float *) malloc(sizeof(float) * numFrames);
+   for (i = 0; i < (long) numFrames * dim; i++)
+      data[i] = (float) sin(0.01 * i) + (float) rand() / RAND_MAX;
+
+   resetCounters();
+   t0 = benchNow();
+   if (arkOpen(&w, arkName, ARK_BUFFER_SIZE) != 0) {
+      fprintf(stderr, "Cannot write %s!\n", arkName);
+      exit(1);
+   }
+   for (n = 0; n < numFiles; n++) {
+      sprintf(key, "utt_%04d", n);
+      if (arkWriteMatrix(&w, key, data, numFrames, dim, format, work) < 0)
+         fprintf(stderr, "%s failed on %s!\n", name, key);
+   }
+   if (arkClose(&w) != 0)
+      fprintf(stderr, "%s failed to close %s!\n", name, arkName);
+   seconds = benchNow() - t0;
+   report(name, 0.0, (long) numFiles * numFrames, seconds,
+          sizeof(float) * dim);
+
+   free(data);
+   free(work);
+   remove(arkName);
+   rmdir(tempDir);
+}
+
+int main(int argc, char *argv[])
+{
+   long frames = 20000;
+   int numHtkFiles = 200;
+   int i, isFixed;
+
+   if (argc > 1)
+      frames = atol(argv[1]);
+   if (argc > 2)
+      numHtkFiles = atoi(argv[2]);
+   if (frames < 1 || numHtkFiles < 1) {
+      fprintf(stderr, "Usage: %s [num_frames] [num_htk_files]\n", argv[0]);
+      return 2;
+   }
+
+   for (i = 0; i < NUM_ALPHAS; i++)
+      checkFixed(alphas[i]);
+   for (i = 0; i < NUM_ALPHAS; i++) {
+      for (isFixed = 0; isFixed <= 1; isFixed++) {
+         benchFreqtAnalysis(frames, alphas[i], isFixed);
+         benchFreqtSynthesis(frames, alphas[i], isFixed);
+         benchFrqtr(frames, alphas[i], isFixed);
+         benchTheq(frames, alphas[i], isFixed);
+         benchMcep2spec(frames, alphas[i], isFixed);
+      }
+      benchMgc2sp(frames, alphas[i]);
+   }
+   benchFftr(frames);
+   benchHtk2ark(numHtkFiles);
+   benchArkWrite(numHtkFiles, ARK_FLOAT, "arkwrite/float");
+   benchArkWrite(numHtkFiles, ARK_CM, "arkwrite/cm");
+   benchArkWrite(numHtkFiles, ARK_CM2, "arkwrite/cm2");
+
+   return 0;
+}
@@ -0,0 +1,105 @@
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+% Test writeArk and readArk
+% - Legacy: readArk reads the float arks of arkwrite
+% - Float: exact round trip, through the ark and through the scp
+% - Compressed: 'cm' and 'cm2' round trips within their quantization
+
+function tests = arkIOTest
+    tests = functiontests(localfunctions);
+end
+
+function setup(testCase)
+    rng(0);
+    testCase.TestData.keys = {'utt_a'; 'utt_b'; 'utt_c'};
+    post = {rand(40, 300), rand(40, 7), rand(40, 3)};
+    for ii = 1:length(post)
+        post{ii} = bsxfun(@rdivide, post{ii}, sum(post{ii}, 1));
+    end
+    testCase.TestData.post = post(:);
+    testCase.TestData.arkFile = [tempname, '.ark'];
+    testCase.TestData.scpFile = strrep(testCase.TestData.arkFile, '.ark',...
+        '.scp');
+end
+
+function teardown(testCase)
+    if exist(testCase.TestData.arkFile, 'file')
+        delete(testCase.TestData.arkFile);
+    end
+    if exist(testCase.TestData.scpFile, 'file')
+        delete(testCase.TestData.scpFile);
+    end
+end
+
+function testReadArkLegacy(testCase)
+    post = testCase.TestData.post;
+    keys = testCase.TestData.keys;
+    numFrames = cellfun(@(x) size(x, 2), post);
+    lastRow = cumsum(numFrames);
+    header = [keys, num2cell(numFrames), num2cell(40*ones(3, 1)),...
+        num2cell(lastRow - numFrames + 1), num2cell(lastRow)];
+    features = transpose(cat(2, post{:}));
+    arkwrite(testCase.TestData.arkFile, header, features);
+    [readKeys, mats] = readArk(testCase.TestData.arkFile);
+    verifyEqual(testCase, readKeys, keys);
+    for ii = 1:3
+        verifyEqual(testCase, mats{ii}, single(post{ii}));
+    end
+end
+
+function testWriteArkFloat(testCase)
+    assumeEqual(testCase, exist('mexarkwrite', 'file'), 3);
+    post = testCase.TestData.post;
+    keys = testCase.TestData.keys;
+    offsets = writeArk(testCase.TestData.arkFile, keys, post);
+    verifySize(testCase, offsets, [3, 1]);
+    [readKeys, mats] = readArk(testCase.TestData.arkFile);
+    verifyEqual(testCase, readKeys, keys);
+    for ii = 1:3
+        verifyEqual(testCase, mats{ii}, single(post{ii}));
+    end
+    [readKeys, mats] = readArk(testCase.TestData.scpFile, 'Keys',...
+        {'utt_c', 'utt_a'});
+    verifyEqual(testCase, readKeys, {'utt_c'; 'utt_a'});
+    verifyEqual(testCase, mats{1}, single(post{3}));
+    verifyEqual(testCase, mats{2}, single(post{1}));
+end
+
+function testWriteArkCompressed(testCase)
+    assumeEqual(testCase, exist('mexarkwrite', 'file'), 3);
+    post = testCase.TestData.post;
+    keys = testCase.TestData.keys;
+    writeArk(testCase.TestData.arkFile, keys, post, 'Format', 'float');
+    floatInfo = dir(testCase.TestData.arkFile);
+    for format = {'cm2', 'cm'}
+        writeArk(testCase.TestData.arkFile, keys, post, 'Format',...
+            format{1});
+        [~, mats] = readArk(testCase.TestData.scpFile);
+        for ii = 1:3
+            range = max(post{ii}(:)) - min(post{ii}(:));
+            if strcmp(format{1}, 'cm2')
+                tol = range/65535;
+            else
+                % One byte within the column quantiles
+                tol = range/32;
+            end
+            verifyEqual(testCase, double(mats{ii}), post{ii}, 'AbsTol',...
+                tol);
+        end
+        info = dir(testCase.TestData.arkFile);
+        verifyLessThan(testCase, info.bytes, floatInfo.bytes/1.9);
+    end
+    verifyLessThan(testCase, info.bytes, floatInfo.bytes/3.5);
+end
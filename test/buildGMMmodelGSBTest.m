@@ -13,6 +13,14 @@
 % limitations under the License.
 
 % Test buildGMMmodelGSB
+% - Target index: pairing against a 'pairingIndex' is the same as against
+%   the prepared target, and many sources can be trained against it
+% - Checkpoints: a run resumes from the EM and data checkpoints, and a
+%   corrupted checkpoint is not used
+% - Checkpoints: the EM converges at the same iteration as a run without
+%   checkpoints, and a converged run is not trained again when resumed
+% - Checkpoints: a resumed run writes to the other slot than the latest
+%   checkpoint
 
 function tests = buildGMMmodelGSBTest
     tests = functiontests(localfunctions);
@@ -54,4 +62,145 @@ function testBuildGMMmodelGSBnormal(testCase)
         testCase.TestData.tgtMats, testCase.TestData.outputPath);
     verifyTrue(testCase, logical(status));
     verifyTrue(testCase, logical(exist(modelPath, 'file')));
-end
\ No newline at end of file
+end
+function testBuildGMMmodelGSBtrace(testCase)
+    tracePath = fullfile(testCase.TestData.outputDir, 'trace.json');
+    [~, status] = buildGMMmodelGSB(testCase.TestData.srcMats,...
+        testCase.TestData.tgtMats, testCase.TestData.outputPath,...
+        'NumIter', 3, 'TracePath', tracePath);
+    verifyTrue(testCase, logical(status));
+    verifyTrue(testCase, logical(exist(tracePath, 'file')));
+    % The trace has one span per stage and split, netlab's EM is one span
+    trace = fileread(tracePath);
+    for stage = {'load', 'prepare', 'pair/split', 'gv', 'em/netlab',...
+            'save'}
+        verifyNotEmpty(testCase, strfind(trace, ['"', stage{1}, '"']));
+    end
+    % The trace is stopped afterwards
+    verifyFalse(testCase, traceSpan('isOn'));
+end
+
+function testBuildGMMmodelGSBpostStore(testCase)
+    storeDir = fullfile(testCase.TestData.outputDir, 'store');
+    [modelPath, status] = buildGMMmodelGSB(testCase.TestData.srcMats,...
+        testCase.TestData.tgtMats, testCase.TestData.outputPath,...
+        'NumIter', 3, 'PostStore', storeDir);
+    verifyTrue(testCase, logical(status));
+    verifyTrue(testCase, logical(exist(modelPath, 'file')));
+    % The stores are removed after the pairing
+    verifyEmpty(testCase, dir(fullfile(storeDir, '*.bin')));
+end
+
+function testBuildGMMmodelGSBtargetIndex(testCase)
+    indexDir = fullfile(testCase.TestData.outputDir, 'index');
+    tgtMats = testCase.TestData.tgtMats;
+    verifyFalse(testCase, pairingIndex('isValid', indexDir, tgtMats));
+    tgtIndex = pairingIndex('build', tgtMats, indexDir);
+    verifyTrue(testCase, pairingIndex('isValid', indexDir, tgtMats));
+    verifyFalse(testCase, pairingIndex('isValid', indexDir,...
+        tgtMats(2:end)));
+    
+    % The index pairs the same as the prepared target PPGs
+    srcUtts = loadUttGSB(testCase.TestData.srcMats);
+    tgtUtts = loadUttGSB(tgtMats);
+    [~, srcPost] = prepareDataGMM(srcUtts);
+    [tgtMcep, tgtPost, tgtLab] = prepareDataGMM(tgtUtts);
+    verifyEqual(testCase, tgtIndex.mcep, tgtMcep);
+    verifyEqual(testCase, tgtIndex.lab, tgtLab);
+    verifyEqual(testCase, readFrames(tgtIndex.post), tgtPost);
+    [mapToSrc, mapToTgt] = framePairingPPG(srcPost, tgtPost);
+    [indexToSrc, indexToTgt] = framePairingPPG(srcPost, tgtIndex, 'auto',...
+        false, 'MemoryBudget', 2^20);
+    verifyEqual(testCase, indexToSrc, mapToSrc);
+    verifyEqual(testCase, indexToTgt, mapToTgt);
+    
+    % Many sources against the index, without the target files
+    modelPaths = {fullfile(testCase.TestData.outputDir, 'model1.mat'),...
+        fullfile(testCase.TestData.outputDir, 'model2.mat')};
+    [modelPaths, status] = buildGMMmodelBatchGSB(...
+        {testCase.TestData.srcMats, testCase.TestData.srcMats(1:2)}, {},...
+        indexDir, modelPaths, 'InMemory', true, 'NumIter', 3);
+    verifyEqual(testCase, status, [1; 1]);
+    verifyTrue(testCase, all(cellfun(@(x) exist(x, 'file') == 2,...
+        modelPaths)));
+end
+
+function testBuildGMMmodelGSBcheckpoint(testCase)
+    checkpointDir = fullfile(testCase.TestData.outputDir, 'checkpoint');
+    args = {testCase.TestData.srcMats, testCase.TestData.tgtMats,...
+        testCase.TestData.outputPath, 'NumIter', 4, 'Epsilon', 0,...
+        'EMPrecision', 'double', 'CheckpointDir', checkpointDir,...
+        'CheckpointEvery', 2};
+    [modelPath, status] = buildGMMmodelGSB(args{:});
+    verifyTrue(testCase, logical(status));
+    refModel = load(modelPath);
+    for file = {'pairing.mat', 'features.bin', 'features.mat',...
+            'em_1.mat', 'em_2.mat'}
+        verifyTrue(testCase, logical(exist(fullfile(checkpointDir,...
+            file{1}), 'file')));
+    end
+    
+    % Resumed from the last EM checkpoint, nothing left to train
+    [modelPath, status] = buildGMMmodelGSB(args{:});
+    verifyTrue(testCase, logical(status));
+    model = load(modelPath);
+    verifyEqual(testCase, model.errlog, refModel.errlog);
+    verifyEqual(testCase, model.mix.centres, refModel.mix.centres);
+    
+    % A corrupted EM checkpoint is skipped for the other one, and the EM
+    % goes on from its iteration
+    fid = fopen(fullfile(checkpointDir, 'em_2.mat'), 'r+');
+    fseek(fid, 200, 'bof');
+    fwrite(fid, zeros(1, 64, 'uint8'));
+    fclose(fid);
+    [modelPath, status] = buildGMMmodelGSB(args{:}, 'NumIter', 6);
+    verifyTrue(testCase, logical(status));
+    model = load(modelPath);
+    verifyLength(testCase, model.errlog, 6);
+    verifyEqual(testCase, model.errlog(1:2), refModel.errlog(1:2),...
+        'RelTol', 1e-10);
+end
+
+
+function testBuildGMMmodelGSBcheckpointConverged(testCase)
+    checkpointDir = fullfile(testCase.TestData.outputDir, 'checkpoint');
+    args = {testCase.TestData.srcMats, testCase.TestData.tgtMats,...
+        testCase.TestData.outputPath, 'NumIter', 50, 'Epsilon', 1,...
+        'EMPrecision', 'double'};
+    [modelPath, status] = buildGMMmodelGSB(args{:});
+    verifyTrue(testCase, logical(status));
+    refModel = load(modelPath);
+    
+    % Convergence is tested across the chunks of 3 iterations
+    args = [args, {'CheckpointDir', checkpointDir, 'CheckpointEvery', 3}];
+    [modelPath, status] = buildGMMmodelGSB(args{:});
+    verifyTrue(testCase, logical(status));
+    model = load(modelPath);
+    verifyEqual(testCase, model.errlog, refModel.errlog, 'RelTol', 1e-10);
+    verifyEqual(testCase, model.mix.centres, refModel.mix.centres,...
+        'AbsTol', 1e-10);
+    
+    % A converged run is resumed as it is
+    [modelPath, status] = buildGMMmodelGSB(args{:});
+    verifyTrue(testCase, logical(status));
+    model = load(modelPath);
+    verifyEqual(testCase, model.errlog, refModel.errlog, 'RelTol', 1e-10);
+end
+
+function testBuildGMMmodelGSBcheckpointSlots(testCase)
+    checkpointDir = fullfile(testCase.TestData.outputDir, 'checkpoint');
+    args = {testCase.TestData.srcMats, testCase.TestData.tgtMats,...
+        testCase.TestData.outputPath, 'Epsilon', 0, 'EMPrecision',...
+        'double', 'CheckpointDir', checkpointDir, 'CheckpointEvery', 2};
+    % The latest checkpoint is in slot 1, the resumed run keeps it
+    [~, status] = buildGMMmodelGSB(args{:}, 'NumIter', 2);
+    verifyTrue(testCase, logical(status));
+    verifyFalse(testCase, logical(exist(fullfile(checkpointDir,...
+        'em_2.mat'), 'file')));
+    [~, status] = buildGMMmodelGSB(args{:}, 'NumIter', 4);
+    verifyTrue(testCase, logical(status));
+    slot1 = load(fullfile(checkpointDir, 'em_1.mat'));
+    slot2 = load(fullfile(checkpointDir, 'em_2.mat'));
+    verifyLength(testCase, slot1.errlog, 2);
+    verifyLength(testCase, slot2.errlog, 4);
+end
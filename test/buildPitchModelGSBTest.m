@@ -53,4 +53,30 @@ function testBuildPitchModelGSBlog(testCase)
         testCase.TestData.outputPath, 'Mode', 'log');
     verifyTrue(testCase, logical(status));
     verifyTrue(testCase, logical(exist(modelPath, 'file')));
-end
\ No newline at end of file
+end
+
+function testBuildPitchModelGSBheqStreaming(testCase)
+    [modelPath, status] = buildPitchModelGSB(testCase.TestData.mats,...
+        testCase.TestData.outputPath, 'Mode', 'heq', 'Streaming', 1);
+    verifyTrue(testCase, logical(status));
+    verifyTrue(testCase, logical(exist(modelPath, 'file')));
+    
+    % Should not keep the data, and the edges should be within one bin of
+    % the in-memory model
+    streamMdl = load(modelPath);
+    verifyFalse(testCase, isfield(streamMdl, 'data'));
+    refMdl = trainF0HEQ(collectF0(testCase.TestData.mats));
+    binWidth = (refMdl.xMax - refMdl.xMin)/refMdl.numBins;
+    verifyEqual(testCase, streamMdl.eqProbEdges, refMdl.eqProbEdges,...
+        'AbsTol', binWidth + 0.1);
+end
+
+function f0 = collectF0(mats)
+    utts = loadUttGSB(mats, 'VarList', {'source'});
+    f0 = [];
+    for ii = 1:length(utts)
+        validF0s = utts(ii).source.f0(logical(utts(ii).source.vuv));
+        f0 = [f0; validF0s(:)];
+    end
+    f0 = f0(f0>40 & f0<400);
+end
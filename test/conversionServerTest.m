@@ -0,0 +1,142 @@
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+% Test conversionServer and conversionClient, the server runs as a separate
+% local Matlab process
+%   - a wav is converted, and the second job hits the model cache
+%   - the latency metrics are reported
+%   - a client that stalls in the middle of its request does not hold up
+%   the others
+%   - the server stops on request
+%   - on a pool, a job is converted by a worker, and a job that arrives
+%   when the queue is full is rejected
+
+function tests = conversionServerTest
+    tests = functiontests(localfunctions);
+end
+
+function setupOnce(testCase)
+    testCase.TestData.port = startServer('''NumWorkers'', 0');
+    testCase.TestData.modelPaths = {...
+        fullfile(pwd, 'data/model/acoustic/ppg_gmm_model.mat'),...
+        fullfile(pwd, 'data/model/pitch/src_model.mat'),...
+        fullfile(pwd, 'data/model/pitch/tgt_model.mat')};
+    [testCase.TestData.wav, testCase.TestData.fs] =...
+        audioread('data/src/recordings/pitch_0001.wav');
+end
+
+function teardownOnce(testCase)
+    try
+        conversionClient('stop', testCase.TestData.port);
+    catch
+        % Already stopped
+    end
+    testCase.TestData = [];
+end
+
+function testConversionServer(testCase)
+    port = testCase.TestData.port;
+    modelPaths = testCase.TestData.modelPaths;
+    for ii = 1:2
+        [wav, fs, info] = conversionClient('convert', port,...
+            testCase.TestData.wav, testCase.TestData.fs, modelPaths{:});
+        verifyEqual(testCase, fs, 16000);
+        verifyFalse(testCase, isempty(wav));
+        verifyEqual(testCase, sum(isnan(wav)), 0);
+        verifyGreaterThanOrEqual(testCase, info.serviceSec, 0);
+    end
+    stats = conversionClient('stats', port);
+    verifyEqual(testCase, stats.numDone, 2);
+    verifyEqual(testCase, stats.numRejected, 0);
+    verifyEqual(testCase, stats.modelMisses, 1);
+    verifyEqual(testCase, stats.modelHits, 1);
+    verifyEqual(testCase, stats.numModels, 1);
+    verifyTrue(testCase, isfinite(stats.p99total));
+    verifyGreaterThanOrEqual(testCase, stats.p99total, stats.p50total);
+end
+
+function testConversionServerBadModel(testCase)
+    % A failed job is reported to its client, and the server keeps going
+    port = testCase.TestData.port;
+    verifyError(testCase, @() conversionClient('convert', port,...
+        testCase.TestData.wav, testCase.TestData.fs, 'no_such_model.mat',...
+        'no_such_model.mat', 'no_such_model.mat'), ?MException);
+    stats = conversionClient('stats', port);
+    verifyGreaterThanOrEqual(testCase, stats.numFailed, 1);
+end
+
+function testConversionServerStalledClient(testCase)
+    port = testCase.TestData.port;
+    % Half of a length prefix, and nothing more
+    stalled = java.net.Socket('127.0.0.1', port);
+    stalledGuard = onCleanup(@() stalled.close());
+    stream = stalled.getOutputStream();
+    stream.write(int8([1, 0, 0, 0]));
+    stream.flush();
+    pause(0.2);
+    timer = tic;
+    stats = conversionClient('stats', port);
+    verifyLessThan(testCase, toc(timer), 5);
+    verifyTrue(testCase, isfield(stats, 'numDone'));
+end
+
+function testConversionServerPoolBackpressure(testCase)
+    port = startServer('''NumWorkers'', 1, ''QueueSize'', 0');
+    stopGuard = onCleanup(@() conversionClient('stop', port));
+    modelPaths = testCase.TestData.modelPaths;
+    message = struct('command', 'convert', 'wav', testCase.TestData.wav,...
+        'fs', testCase.TestData.fs, 'gmmMdl', modelPaths{1},...
+        'srcPitchMdl', modelPaths{2}, 'tgtPitchMdl', modelPaths{3},...
+        'textGrid', '');
+    % The first job takes the only worker, and there is no room to wait
+    sock = java.net.Socket('127.0.0.1', port);
+    sockGuard = onCleanup(@() sock.close());
+    sock.setSoTimeout(600*1000);
+    socketMessage('send', sock, message);
+    pause(1);
+    verifyError(testCase, @() conversionClient('convert', port,...
+        testCase.TestData.wav, testCase.TestData.fs, modelPaths{:}),...
+        'conversionClient:rejected');
+    % The first job is converted on the pool
+    result = socketMessage('receive', sock);
+    verifyEqual(testCase, result.status, 'ok');
+    verifyEqual(testCase, result.fs, 16000);
+    verifyFalse(testCase, isempty(result.wav));
+    verifyEqual(testCase, sum(isnan(result.wav)), 0);
+    stats = conversionClient('stats', port);
+    verifyEqual(testCase, stats.numDone, 1);
+    verifyEqual(testCase, stats.numRejected, 1);
+    verifyEqual(testCase, stats.numAccepted, 1);
+end
+
+% Start a server in a new Matlab process, and wait for its port
+function port = startServer(extraArgs)
+    portFile = [tempname, '.port'];
+    serverCmd = sprintf(['try, addpath(genpath(''%s'')); ',...
+        'cd(''%s''); conversionServer(''PortFile'', ''%s'', %s); ',...
+        'catch err, disp(getReport(err)); end; exit'],...
+        fileparts(fileparts(which('conversionServer'))), pwd, portFile,...
+        extraArgs);
+    system(sprintf(['"%s" -nodisplay -nosplash -nodesktop -r "%s" ',...
+        '> /dev/null 2>&1 &'], fullfile(matlabroot, 'bin', 'matlab'),...
+        serverCmd));
+    timer = tic;
+    while ~exist(portFile, 'file') && toc(timer) < 300
+        pause(1);
+    end
+    assert(logical(exist(portFile, 'file')),...
+        'The conversion server did not start.');
+    port = load(portFile);
+    delete(portFile);
+end
@@ -15,6 +15,8 @@
 % Test data prep
 % - Serial mode: run on one core
 % - Parallel mode: run on multiple cores
+% - Resume mode: a rerun skips the utterances that are already done
+% - PPG engines: the in-process PPGs agree with the Kaldi PPGs
 
 function tests = dataPrepTest
     tests = functiontests(localfunctions);
@@ -77,4 +79,44 @@ function testDataPrepParallel(testCase)
     for ii = 1:testCase.TestData.numWavs
         verifyTrue(testCase, logical(exist(matList{ii}, 'file')));
     end
-end
\ No newline at end of file
+end
+
+function testDataPrepResume(testCase)
+    matList = dataPrep(testCase.TestData.wavList,...
+        testCase.TestData.transFile, testCase.TestData.outputDir,...
+        'NumWorkers', 8, 'StartTime', testCase.TestData.startTime,...
+        'EndTime', testCase.TestData.endTime);
+    matInfo = cellfun(@dir, matList);
+    
+    % Simulate a crash in the middle of the corpus
+    delete(matList{end});
+    rerunMatList = dataPrep(testCase.TestData.wavList,...
+        testCase.TestData.transFile, testCase.TestData.outputDir,...
+        'NumWorkers', 8, 'StartTime', testCase.TestData.startTime,...
+        'EndTime', testCase.TestData.endTime);
+    verifyEqual(testCase, rerunMatList, matList);
+    rerunMatInfo = cellfun(@dir, rerunMatList);
+    % Finished utterances are not processed again
+    verifyEqual(testCase, [rerunMatInfo(1:end-1).datenum],...
+        [matInfo(1:end-1).datenum]);
+end
+
+function testDataPrepPpgEngines(testCase)
+    nativeMatList = dataPrep(testCase.TestData.wavList,...
+        testCase.TestData.transFile, testCase.TestData.outputDir,...
+        'NumWorkers', 8, 'StartTime', testCase.TestData.startTime,...
+        'EndTime', testCase.TestData.endTime, 'PpgEngine', 'native');
+    nativePost = cellfun(@(x) load(x, 'post'), nativeMatList);
+    kaldiMatList = dataPrep(testCase.TestData.wavList,...
+        testCase.TestData.transFile, testCase.TestData.outputDir,...
+        'NumWorkers', 8, 'StartTime', testCase.TestData.startTime,...
+        'EndTime', testCase.TestData.endTime, 'PpgEngine', 'kaldi');
+    verifyEqual(testCase, kaldiMatList, nativeMatList);
+    % Kaldi dithers the audio, so only the decisions are compared
+    for ii = 1:length(kaldiMatList)
+        kaldiPost = load(kaldiMatList{ii}, 'post');
+        [~, nativeIdx] = max(nativePost(ii).post, [], 1);
+        [~, kaldiIdx] = max(kaldiPost.post, [], 1);
+        verifyGreaterThan(testCase, mean(nativeIdx == kaldiIdx), 0.9);
+    end
+end
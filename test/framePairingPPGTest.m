@@ -0,0 +1,169 @@
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+% Test framePairingPPG
+% - Tiling: a small memory budget tiles both sides, same pairing
+% - Fixed split: a numeric split size is kept as the source batch
+% - Frame store: file-backed PPGs give the same pairing as in memory
+% - Phone buckets: frames are only paired within their phone, fewer
+%   divergences, and the same pairing as the exhaustive search on PPGs
+%   that are peaked at their phone
+% - Out of core: both sides from frame stores under a small budget, with
+%   and without reading ahead, give the same pairing and costs, ties too
+% - Prefetch: the plan reports whether the tiles were read ahead, off in
+%   memory, and off with a warning if the background reads failed
+
+function tests = framePairingPPGTest
+    tests = functiontests(localfunctions);
+end
+
+function setup(testCase)
+    rng(0);
+    srcPost = rand(40, 1500);
+    tgtPost = rand(40, 1200);
+    testCase.TestData.srcPost = bsxfun(@rdivide, srcPost, sum(srcPost, 1));
+    testCase.TestData.tgtPost = bsxfun(@rdivide, tgtPost, sum(tgtPost, 1));
+end
+
+function testFramePairingPPGtiling(testCase)
+    srcPost = testCase.TestData.srcPost;
+    tgtPost = testCase.TestData.tgtPost;
+    [mapToSrc, mapToTgt, ~, ~, plan] = framePairingPPG(srcPost, tgtPost);
+    verifyEqual(testCase, plan.numTiles, 1);
+    
+    % The whole KL divergence matrix is about 14 MB, give it 2 MB
+    [tiledToSrc, tiledToTgt, ~, ~, tiledPlan] = framePairingPPG(srcPost,...
+        tgtPost, 'auto', true, 'MemoryBudget', 2*2^20);
+    verifyGreaterThan(testCase, tiledPlan.numTiles, 1);
+    verifyLessThan(testCase, tiledPlan.tgtTile, size(tgtPost, 2));
+    verifyLessThanOrEqual(testCase, tiledPlan.estimatedBytes, 2*2^20);
+    verifyEqual(testCase, tiledToSrc, mapToSrc);
+    verifyEqual(testCase, tiledToTgt, mapToTgt);
+end
+
+function testFramePairingPPGfixedSplit(testCase)
+    [~, ~, ~, ~, plan] = framePairingPPG(testCase.TestData.srcPost,...
+        testCase.TestData.tgtPost, 500);
+    verifyEqual(testCase, plan.srcTile, 500);
+    verifyEqual(testCase, plan.tgtTile, size(testCase.TestData.tgtPost, 2));
+end
+
+function testFramePairingPPGstore(testCase)
+    srcPost = testCase.TestData.srcPost;
+    tgtPost = testCase.TestData.tgtPost;
+    storeFile = [tempname, '.bin'];
+    fid = fopen(storeFile, 'w');
+    fwrite(fid, tgtPost, 'double');
+    fclose(fid);
+    tgtStore = struct('file', storeFile, 'precision', 'double',...
+        'dim', size(tgtPost, 1), 'numFrames', size(tgtPost, 2));
+    verifyEqual(testCase, readFrames(tgtStore, 11, 20), tgtPost(:, 11:20));
+    
+    [mapToSrc, mapToTgt] = framePairingPPG(srcPost, tgtPost);
+    [storeToSrc, storeToTgt] = framePairingPPG(srcPost, tgtStore, 'auto',...
+        false, 'MemoryBudget', 2*2^20);
+    delete(storeFile);
+    verifyEqual(testCase, storeToSrc, mapToSrc);
+    verifyEqual(testCase, storeToTgt, mapToTgt);
+end
+
+function testFramePairingPPGbuckets(testCase)
+    rng(0);
+    numPhones = 5;
+    srcLab = randi(numPhones, 1, 1500);
+    tgtLab = randi(numPhones, 1, 1200);
+    % PPG dimensions grouped by phone, each frame peaked at its own phone
+    srcPost = peakedPost(testCase.TestData.srcPost, srcLab, numPhones);
+    tgtPost = peakedPost(testCase.TestData.tgtPost, tgtLab, numPhones);
+    [mapToSrc, mapToTgt, ~, ~, plan] = framePairingPPG(srcPost, tgtPost);
+    [bucketToSrc, bucketToTgt, ~, ~, bucketPlan] = framePairingPPG(...
+        srcPost, tgtPost, 'auto', false, 'SrcLabels', srcLab,...
+        'TgtLabels', tgtLab, 'MemoryBudget', 2*2^20);
+    verifyEqual(testCase, bucketPlan.numBuckets, numPhones);
+    verifyLessThan(testCase, bucketPlan.numDivergences,...
+        plan.numDivergences/(numPhones - 1));
+    verifyEqual(testCase, srcLab, tgtLab(bucketToSrc));
+    verifyEqual(testCase, tgtLab, srcLab(bucketToTgt));
+    verifyEqual(testCase, bucketToSrc, mapToSrc);
+    verifyEqual(testCase, bucketToTgt, mapToTgt);
+    
+    % A phone without target frames falls back to all the frames
+    tgtLab(tgtLab == 1) = 2;
+    [bucketToSrc, ~, ~, ~, bucketPlan] = framePairingPPG(srcPost,...
+        tgtPost, 'auto', false, 'SrcLabels', srcLab, 'TgtLabels', tgtLab);
+    verifyEqual(testCase, bucketPlan.numFallback, sum(srcLab == 1));
+    verifyEqual(testCase, bucketToSrc(srcLab == 1), mapToSrc(srcLab == 1));
+end
+
+function testFramePairingPPGoutOfCore(testCase)
+    srcPost = testCase.TestData.srcPost;
+    % Repeated target frames, ties go to the earlier frame
+    tgtPost = testCase.TestData.tgtPost(:, [1:1200, 1:300]);
+    srcStore = writeStore(srcPost);
+    tgtStore = writeStore(tgtPost);
+    [mapToSrc, mapToTgt, srcCost, tgtCost] = framePairingPPG(srcPost,...
+        tgtPost);
+    for isPrefetch = [false, true]
+        [storeToSrc, storeToTgt, storeSrcCost, storeTgtCost, plan] =...
+            framePairingPPG(srcStore, tgtStore, 'auto', false,...
+            'MemoryBudget', 2^20, 'Prefetch', isPrefetch);
+        verifyGreaterThan(testCase, plan.numTiles, 4);
+        verifyLessThan(testCase, plan.tgtTile, size(tgtPost, 2));
+        verifyLessThanOrEqual(testCase, plan.estimatedBytes, 2^20);
+        verifyEqual(testCase, storeToSrc, mapToSrc);
+        verifyEqual(testCase, storeToTgt, mapToTgt);
+        verifyEqual(testCase, storeSrcCost, srcCost, 'AbsTol', 1e-12);
+        verifyEqual(testCase, storeTgtCost, tgtCost, 'AbsTol', 1e-12);
+    end
+    delete(srcStore.file, tgtStore.file);
+end
+
+function testFramePairingPPGprefetch(testCase)
+    srcPost = testCase.TestData.srcPost;
+    tgtPost = testCase.TestData.tgtPost;
+    % Nothing to read ahead in memory
+    [~, ~, ~, ~, plan] = framePairingPPG(srcPost, tgtPost, 'auto', false,...
+        'Prefetch', true);
+    verifyFalse(testCase, plan.prefetch);
+    
+    srcStore = writeStore(srcPost);
+    storeGuard = onCleanup(@() delete(srcStore.file));
+    [~, ~, ~, ~, plan] = framePairingPPG(srcStore, tgtPost, 'auto',...
+        false, 'MemoryBudget', 2^20, 'Prefetch', false);
+    verifyFalse(testCase, plan.prefetch);
+    % On unless the background reads failed, which is warned about
+    lastwarn('');
+    [~, ~, ~, ~, plan] = framePairingPPG(srcStore, tgtPost, 'auto',...
+        false, 'MemoryBudget', 2^20, 'Prefetch', true);
+    [~, warnId] = lastwarn();
+    verifyEqual(testCase, plan.prefetch,...
+        ~strcmp(warnId, 'framePairingPPG:prefetch'));
+end
+
+function post = peakedPost(post, lab, numPhones)
+    dimsPerPhone = size(post, 1)/numPhones;
+    for ii = 1:numPhones
+        dims = (1:dimsPerPhone) + (ii-1)*dimsPerPhone;
+        post(dims, lab == ii) = post(dims, lab == ii) + 1;
+    end
+    post = bsxfun(@rdivide, post, sum(post, 1));
+end
+
+function store = writeStore(post)
+    store = struct('file', [tempname, '.bin'], 'precision', 'double',...
+        'dim', size(post, 1), 'numFrames', size(post, 2));
+    fid = fopen(store.file, 'w');
+    fwrite(fid, post, 'double');
+    fclose(fid);
+end
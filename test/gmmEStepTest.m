@@ -0,0 +1,79 @@
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+% Test gmmEStep, gmmMStep, gmmemLogDomain, and reportEStepParity
+
+function tests = gmmEStepTest
+    tests = functiontests(localfunctions);
+end
+
+function setup(testCase)
+    rng(0);
+    x = [randn(600, 6); bsxfun(@plus, 0.5*randn(600, 6), 3*ones(1, 6))];
+    options = foptions_netlab;
+    options(1) = -1;
+    options(5) = 1;
+    options(14) = 5;
+    testCase.TestData.x = x;
+    testCase.TestData.options = options;
+    testCase.TestData.diagMix = gmminit(gmm(6, 4, 'diag'), x, options);
+    testCase.TestData.fullMix = gmminit(gmm(6, 4, 'full'), x, options);
+end
+
+function testGmmEStepMatchesGmmem(testCase)
+    x = testCase.TestData.x;
+    options = testCase.TestData.options;
+    for mix = {testCase.TestData.diagMix, testCase.TestData.fullMix}
+        [refMix, ~, refErrlog] = gmmem(mix{1}, x, options);
+        % Small blocks, to cover the accumulation over blocks
+        [logMix, ~, logErrlog] = gmmemLogDomain(mix{1}, x, options,...
+            'Precision', 'double', 'BlockSize', 500);
+        verifyEqual(testCase, logErrlog, refErrlog, 'RelTol', 1e-8);
+        verifyEqual(testCase, logMix.centres, refMix.centres,...
+            'AbsTol', 1e-8);
+        verifyEqual(testCase, logMix.covars, refMix.covars, 'AbsTol', 1e-8);
+        verifyEqual(testCase, logMix.priors, refMix.priors, 'AbsTol', 1e-8);
+    end
+end
+
+function testGmmEStepSingle(testCase)
+    x = testCase.TestData.x;
+    for mix = {testCase.TestData.diagMix, testCase.TestData.fullMix}
+        ref = gmmEStep(mix{1}, x, 'double');
+        stats = gmmEStep(mix{1}, x, 'single');
+        % Log likelihood parity, statistics still in double
+        verifyEqual(testCase, stats.logLik, ref.logLik, 'RelTol', 1e-5);
+        verifyEqual(testCase, stats.N, ref.N, 'RelTol', 1e-4);
+        verifyClass(testCase, stats.F, 'double');
+    end
+end
+
+function testGmmEStepFarFrame(testCase)
+    % A frame far from every Gaussian underflows in netlab, not here
+    x = [testCase.TestData.x; 1e3*ones(1, 6)];
+    mix = testCase.TestData.diagMix;
+    stats = gmmEStep(mix, x, 'single');
+    verifyFalse(testCase, any(isnan(stats.F(:))));
+    verifyEqual(testCase, sum(stats.N), size(x, 1), 'RelTol', 1e-10);
+    verifyTrue(testCase, isfinite(stats.logLik));
+end
+
+function testReportEStepParity(testCase)
+    report = reportEStepParity(testCase.TestData.diagMix,...
+        testCase.TestData.x);
+    verifyEqual(testCase, {report.path.name}, {'netlab', 'double',...
+        'single'});
+    verifyLessThan(testCase, abs([report.path.relLogLikDiff]), 1e-5);
+    verifyGreaterThan(testCase, report.speedup, 0);
+end
@@ -0,0 +1,132 @@
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+% Test gmmemDistributed, the workers run as separate local Matlab processes
+%   - a worker without the token is dropped, and a message longer than the
+%   limit is not read
+
+function tests = gmmemDistributedTest
+    tests = functiontests(localfunctions);
+end
+
+function setup(testCase)
+    rng(0);
+    x = [randn(600, 4); bsxfun(@plus, 0.5*randn(600, 4), [3, 3, 0, 0])];
+    options = foptions_netlab;
+    options(1) = -1;
+    options(5) = 1;
+    options(14) = 5;
+    mix = gmminit(gmm(4, 3, 'diag'), x, options);
+    testCase.TestData.x = x;
+    testCase.TestData.options = options;
+    testCase.TestData.mix = mix;
+end
+
+function testGmmemDistributedDiag(testCase)
+    x = testCase.TestData.x;
+    options = testCase.TestData.options;
+    mix = testCase.TestData.mix;
+    [refMix, ~, refErrlog] = gmmem(mix, x, options);
+    [distMix, ~, distErrlog] = gmmemDistributed(mix, x, options,...
+        'NumWorkers', 3);
+    % Same model as the single-process EM
+    verifyEqual(testCase, distErrlog, refErrlog, 'RelTol', 1e-8);
+    verifyEqual(testCase, distMix.centres, refMix.centres, 'AbsTol', 1e-8);
+    verifyEqual(testCase, distMix.covars, refMix.covars, 'AbsTol', 1e-8);
+    verifyEqual(testCase, distMix.priors, refMix.priors, 'AbsTol', 1e-8);
+end
+
+function testGmmemDistributedFull(testCase)
+    x = testCase.TestData.x;
+    options = testCase.TestData.options;
+    mix = gmminit(gmm(4, 3, 'full'), x, options);
+    refMix = gmmem(mix, x, options);
+    distMix = gmmemDistributed(mix, x, options, 'NumWorkers', 2);
+    verifyEqual(testCase, distMix.covars, refMix.covars, 'AbsTol', 1e-8);
+end
+
+function testGmmemDistributedLostWorker(testCase)
+    x = testCase.TestData.x;
+    options = testCase.TestData.options;
+    mix = testCase.TestData.mix;
+    refMix = gmmem(mix, x, options);
+    
+    % Three workers started by hand, one of them dies in the 3rd E-step.
+    % The coordinator listens on any free port, and the workers read it
+    % from its port file.
+    portFile = [tempname, '.port'];
+    portGuard = onCleanup(@() delete(portFile));
+    startWorker(portFile, '');
+    startWorker(portFile, '');
+    startWorker(portFile, ', ''FailAfter'', 2');
+    distMix = gmmemDistributed(mix, x, options, 'NumWorkers', 3,...
+        'Port', 0, 'PortFile', portFile, 'Spawn', false,...
+        'ConnectTimeout', 120);
+    % Its shard is redone by the others, and the model is the same
+    verifyEqual(testCase, distMix.centres, refMix.centres, 'AbsTol', 1e-8);
+    verifyEqual(testCase, distMix.covars, refMix.covars, 'AbsTol', 1e-8);
+end
+
+function testGmmemDistributedToken(testCase)
+    x = testCase.TestData.x;
+    options = testCase.TestData.options;
+    mix = testCase.TestData.mix;
+    refMix = gmmem(mix, x, options);
+    
+    % A worker with a wrong token does not take a shard
+    portFile = [tempname, '.port'];
+    portGuard = onCleanup(@() delete(portFile));
+    startWorker(portFile, ', ''Token'', ''not-the-token''');
+    startWorker(portFile, '');
+    startWorker(portFile, '');
+    distMix = gmmemDistributed(mix, x, options, 'NumWorkers', 2,...
+        'Port', 0, 'PortFile', portFile, 'Spawn', false,...
+        'ConnectTimeout', 120);
+    verifyEqual(testCase, distMix.centres, refMix.centres, 'AbsTol', 1e-8);
+    verifyEqual(testCase, distMix.covars, refMix.covars, 'AbsTol', 1e-8);
+end
+
+function testSocketMessageLimits(testCase)
+    server = java.net.ServerSocket(0, 1,...
+        java.net.InetAddress.getLoopbackAddress());
+    serverGuard = onCleanup(@() server.close());
+    client = java.net.Socket('127.0.0.1', server.getLocalPort());
+    clientGuard = onCleanup(@() client.close());
+    peer = server.accept();
+    peerGuard = onCleanup(@() peer.close());
+    peer.setSoTimeout(10000);
+    
+    socketMessage('sendToken', client, 'abc');
+    verifyTrue(testCase, socketMessage('checkToken', peer, 'abc'));
+    socketMessage('sendToken', client, 'abd');
+    verifyFalse(testCase, socketMessage('checkToken', peer, 'abc'));
+    
+    socketMessage('send', client, struct('x', 1:10));
+    value = socketMessage('receive', peer, 1e4);
+    verifyEqual(testCase, value.x, 1:10);
+    socketMessage('send', client, zeros(1, 1e4));
+    verifyError(testCase, @() socketMessage('receive', peer, 1e4),...
+        ?MException);
+end
+
+function startWorker(portFile, extraArgs)
+    workerCmd = sprintf(['try, addpath(''%s'', ''%s''); ',...
+        'gmmWorker(''127.0.0.1'', ''%s''%s); catch err, ',...
+        'disp(getReport(err)); end; exit'],...
+        fileparts(which('gmmWorker')), fileparts(which('gmmpost')),...
+        portFile, extraArgs);
+    system(sprintf(['"%s" -nodisplay -nosplash -nodesktop -r "%s" ',...
+        '> /dev/null 2>&1 &'], fullfile(matlabroot, 'bin', 'matlab'),...
+        workerCmd));
+end
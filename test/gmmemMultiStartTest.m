@@ -0,0 +1,107 @@
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+% Test gmmemMultiStart
+%   - one start is the same as 'gmminit' and 'gmmemLogDomain'
+%   - the starts are halved at each rung, and the best one is kept
+%   - the starts run on a pool are the same as the serial ones, also when
+%   every start converges before the last rung
+
+function tests = gmmemMultiStartTest
+    tests = functiontests(localfunctions);
+end
+
+function setup(testCase)
+    rng(0);
+    x = [randn(600, 4); bsxfun(@plus, 0.5*randn(600, 4), [3, 3, 0, 0]);...
+        bsxfun(@plus, 0.3*randn(300, 4), [0, -3, 2, 0])];
+    options = foptions_netlab;
+    options(1) = -1;
+    options(3) = 0;
+    options(5) = 1;
+    options(14) = 16;
+    testCase.TestData.x = x;
+    testCase.TestData.options = options;
+end
+
+function testGmmemMultiStartOneStart(testCase)
+    x = testCase.TestData.x;
+    options = testCase.TestData.options;
+    rng(5, 'twister');
+    refMix = gmminit(gmm(4, 3, 'diag'), x, options);
+    [refMix, ~, refErrlog] = gmmemLogDomain(refMix, x, options,...
+        'Precision', 'double');
+    [mix, ~, errlog] = gmmemMultiStart(gmm(4, 3, 'diag'), x, options,...
+        'NumStarts', 1, 'NumWorkers', 0, 'Seed', 5);
+    verifyEqual(testCase, errlog, refErrlog, 'RelTol', 1e-10);
+    verifyEqual(testCase, mix.centres, refMix.centres, 'AbsTol', 1e-10);
+    verifyEqual(testCase, mix.covars, refMix.covars, 'AbsTol', 1e-10);
+end
+
+function testGmmemMultiStartHalving(testCase)
+    x = testCase.TestData.x;
+    options = testCase.TestData.options;
+    [mix, options, errlog, report] = gmmemMultiStart(gmm(4, 3, 'diag'),...
+        x, options, 'NumStarts', 4, 'NumWorkers', 0);
+    verifyEqual(testCase, report.rungs, [4, 8, 16]);
+    % 2 starts are stopped at the first rung, 1 at the second
+    verifyEqual(testCase, sort([report.starts.stoppedAt]), [0, 1, 1, 2]);
+    best = report.starts([report.starts.isBest]);
+    verifyEqual(testCase, numel(best), 1);
+    verifyEqual(testCase, best.errlog, errlog);
+    verifyEqual(testCase, options(8), errlog(end));
+    verifyEqual(testCase, length(errlog), 16);
+    % The best start is no worse than the others at the last common rung
+    for start = report.starts(~[report.starts.isBest])
+        verifyLessThanOrEqual(testCase, errlog(start.numIters),...
+            start.errlog(end) + 1e-8);
+    end
+    verifyEqual(testCase, sum(mix.priors), 1, 'AbsTol', 1e-10);
+end
+
+function testGmmemMultiStartPool(testCase)
+    x = testCase.TestData.x;
+    options = testCase.TestData.options;
+    [serialMix, ~, serialErrlog, serialReport] = gmmemMultiStart(...
+        gmm(4, 3, 'diag'), x, options, 'NumStarts', 4, 'NumWorkers', 0);
+    [poolMix, ~, poolErrlog, poolReport] = gmmemMultiStart(...
+        gmm(4, 3, 'diag'), x, options, 'NumStarts', 4, 'NumWorkers', 2);
+    verifyEqual(testCase, poolErrlog, serialErrlog, 'RelTol', 1e-10);
+    verifyEqual(testCase, poolMix.centres, serialMix.centres,...
+        'AbsTol', 1e-10);
+    verifyEqual(testCase, poolMix.covars, serialMix.covars,...
+        'AbsTol', 1e-10);
+    verifyEqual(testCase, [poolReport.starts.stoppedAt],...
+        [serialReport.starts.stoppedAt]);
+    verifyEqual(testCase, [poolReport.starts.isBest],...
+        [serialReport.starts.isBest]);
+end
+
+function testGmmemMultiStartPoolConverged(testCase)
+    x = testCase.TestData.x;
+    options = testCase.TestData.options;
+    % Every start stops at its 2nd iteration, so the last rungs have
+    % nothing left to train
+    options(3) = 1e6;
+    [serialMix, ~, serialErrlog, serialReport] = gmmemMultiStart(...
+        gmm(4, 3, 'diag'), x, options, 'NumStarts', 4, 'NumWorkers', 0);
+    [poolMix, ~, poolErrlog, poolReport] = gmmemMultiStart(...
+        gmm(4, 3, 'diag'), x, options, 'NumStarts', 4, 'NumWorkers', 2);
+    verifyLength(testCase, serialErrlog, 2);
+    verifyEqual(testCase, poolErrlog, serialErrlog, 'RelTol', 1e-10);
+    verifyEqual(testCase, poolMix.centres, serialMix.centres,...
+        'AbsTol', 1e-10);
+    verifyEqual(testCase, [poolReport.starts.numIters],...
+        [serialReport.starts.numIters]);
+end
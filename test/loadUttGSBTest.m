@@ -0,0 +1,85 @@
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+% Test loadUttGSB and getUttField
+%   - a lazy field read by 'getUttField' is the same as an eager load
+%   - 'getUttField' errors on a missing field of a utt that is not lazy
+%   - parallel and serial loading give the same container and invalidIdx
+
+function tests = loadUttGSBTest
+    tests = functiontests(localfunctions);
+end
+
+function setup(testCase)
+    rng(0);
+    outputDir = tempname;
+    mkdir(outputDir);
+    numUtts = 4;
+    uttsPath = cell(numUtts, 1);
+    for ii = 1:numUtts
+        numFrames = 50 + 10*ii;
+        utt = struct();
+        utt.name = sprintf('utt_%d', ii);
+        utt.mcep = randn(25, numFrames);
+        utt.post = rand(40, numFrames, 'single');
+        utt.lab = randi(40, 1, numFrames);
+        uttsPath{ii} = fullfile(outputDir, sprintf('utt_%d.mat', ii));
+        save(uttsPath{ii}, '-struct', 'utt');
+    end
+    testCase.TestData.outputDir = outputDir;
+    testCase.TestData.uttsPath = uttsPath;
+end
+
+function teardown(testCase)
+    if exist(testCase.TestData.outputDir, 'dir')
+        rmdir(testCase.TestData.outputDir, 's');
+    end
+    testCase.TestData = [];
+end
+
+function testLoadUttGSBLazy(testCase)
+    uttsPath = testCase.TestData.uttsPath;
+    eager = loadUttGSB(uttsPath);
+    lazy = loadUttGSB(uttsPath, 'RegExp', '^(?!post)\w', 'Lazy', true);
+    verifyFalse(testCase, isfield(lazy, 'post'));
+    verifyTrue(testCase, isfield(lazy, 'matFile'));
+    for ii = 1:length(uttsPath)
+        % A lazy field is read from the file, a loaded one is as it is
+        verifyEqual(testCase, getUttField(lazy(ii), 'post'), eager(ii).post);
+        verifyEqual(testCase, getUttField(lazy(ii), 'mcep'), eager(ii).mcep);
+        verifyEqual(testCase, lazy(ii).lab, eager(ii).lab);
+    end
+end
+
+function testGetUttFieldMissing(testCase)
+    utt = loadUttGSB(testCase.TestData.uttsPath(1), 'VarList', {'mcep'});
+    verifyFalse(testCase, isfield(utt, 'matFile'));
+    verifyError(testCase, @() getUttField(utt, 'post'), ?MException);
+    verifyEqual(testCase, size(getUttField(utt, 'mcep'), 1), 25);
+end
+
+function testLoadUttGSBParallel(testCase)
+    uttsPath = testCase.TestData.uttsPath;
+    % A missing file in the middle
+    uttsPath = [uttsPath(1:2); {fullfile(testCase.TestData.outputDir,...
+        'missing.mat')}; uttsPath(3:end)];
+    [serialUtts, serialInvalid] = loadUttGSB(uttsPath);
+    [parallelUtts, parallelInvalid] = loadUttGSB(uttsPath, 'NumWorkers', 2);
+    verifyEqual(testCase, serialInvalid, 3);
+    verifyEqual(testCase, parallelInvalid, serialInvalid);
+    verifyEqual(testCase, numel(serialUtts), length(uttsPath) - 1);
+    verifyEqual(testCase, parallelUtts, serialUtts);
+    verifyEqual(testCase, {parallelUtts.name},...
+        {'utt_1', 'utt_2', 'utt_3', 'utt_4'});
+end
@@ -0,0 +1,111 @@
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+% Test resultCache
+
+function tests = resultCacheTest
+    tests = functiontests(localfunctions);
+end
+
+function setup(testCase)
+    testCase.TestData.cacheDir = 'data/temp/result_cache_test';
+    if exist(testCase.TestData.cacheDir, 'dir')
+        rmdir(testCase.TestData.cacheDir, 's');
+    end
+end
+
+function teardown(testCase)
+    if exist(testCase.TestData.cacheDir, 'dir')
+        rmdir(testCase.TestData.cacheDir, 's');
+    end
+end
+
+function testResultCacheKey(testCase)
+    key = resultCache('key', 'mcep', struct('a', 1), 'MLGV');
+    verifyEqual(testCase, length(key), 32);
+    % Same content, same key
+    verifyEqual(testCase, key,...
+        resultCache('key', 'mcep', struct('a', 1), 'MLGV'));
+    % Different content or different split, different key
+    verifyNotEqual(testCase, key,...
+        resultCache('key', 'mcep', struct('a', 2), 'MLGV'));
+    verifyNotEqual(testCase, resultCache('key', 'ab', 'c'),...
+        resultCache('key', 'a', 'bc'));
+end
+
+function testHashContentParts(testCase)
+    cacheDir = testCase.TestData.cacheDir;
+    mkdir(cacheDir);
+    files = fullfile(cacheDir, {'a.txt', 'b.txt'});
+    writeText(files{1}, 'ab');
+    writeText(files{2}, 'c');
+    key = hashContent(files);
+    verifyEqual(testCase, length(key), 32);
+    verifyEqual(testCase, key, hashContent(files));
+    % Moving bytes between the files, or into the extra string, changes
+    % the key
+    writeText(files{1}, 'a');
+    writeText(files{2}, 'bc');
+    verifyNotEqual(testCase, hashContent(files), key);
+    verifyNotEqual(testCase, hashContent(files(1), 'bc'),...
+        hashContent(files));
+    % A missing file is not the same as a file holding its path
+    missing = fullfile(cacheDir, 'missing.txt');
+    writeText(files{1}, missing);
+    verifyNotEqual(testCase, hashContent(files(1)), hashContent({missing}));
+end
+
+function testResultCacheGetPut(testCase)
+    cacheDir = testCase.TestData.cacheDir;
+    key = resultCache('key', 'test');
+    [value, isHit] = resultCache('get', cacheDir, key);
+    verifyFalse(testCase, isHit);
+    verifyEmpty(testCase, value);
+    
+    resultCache('put', cacheDir, key, magic(4));
+    [value, isHit] = resultCache('get', cacheDir, key);
+    verifyTrue(testCase, isHit);
+    verifyEqual(testCase, value, magic(4));
+end
+
+function testResultCacheEviction(testCase)
+    cacheDir = testCase.TestData.cacheDir;
+    keys = cell(1, 3);
+    for ii = 1:3
+        keys{ii} = resultCache('key', 'test', ii);
+        resultCache('put', cacheDir, keys{ii}, rand(100));
+        pause(1.1); % the file times have a resolution of one second
+    end
+    % Use the first entry, so the second is the least recently used
+    [~, isHit] = resultCache('get', cacheDir, keys{1});
+    verifyTrue(testCase, isHit);
+    pause(1.1);
+    
+    % Room for about three entries
+    entry = dir(fullfile(cacheDir, keys{1}(1:2), [keys{1}, '.mat']));
+    resultCache('put', cacheDir, resultCache('key', 'test', 4), rand(100),...
+        3.5*entry.bytes);
+    [~, isHit] = resultCache('get', cacheDir, keys{2});
+    verifyFalse(testCase, isHit);
+    [~, isHit] = resultCache('get', cacheDir, keys{1});
+    verifyTrue(testCase, isHit);
+    [~, isHit] = resultCache('get', cacheDir, keys{3});
+    verifyTrue(testCase, isHit);
+end
+
+function writeText(path, text)
+    fid = fopen(path, 'w');
+    fwrite(fid, text);
+    fclose(fid);
+end
@@ -0,0 +1,169 @@
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+% Test initPpgStream, streamPpg, and reportPpgStreamDrift, with a small
+% random model of the same structure as the Kaldi nnet2 model
+%   - with the CMVN stats of the whole utterance as the prior, and enough
+%   lookahead, the streamed PPGs are the batch PPGs of 'computePpg', for
+%   any chunk size
+%   - the drift report measures the same, and is bounded with a causal
+%   window
+%   - online CMVN: the window keeps the stats of the last frames in a
+%   buffer that does not grow with the stream, and the prior only changes
+%   the frames before it is warmed up
+
+function tests = streamPpgTest
+    tests = functiontests(localfunctions);
+end
+
+function setup(testCase)
+    rng(0);
+    model.mfccOpts = struct('sampleFrequency', 16000, 'frameShift', 5,...
+        'snipEdges', false, 'useEnergy', false);
+    model.normVars = false;
+    model.leftContext = 4;
+    model.rightContext = 4;
+    spliceDim = 13*9;
+    model.lda = [randn(40, spliceDim)/sqrt(spliceDim), randn(40, 1)];
+    nnet.components = {...
+        struct('type', 'SpliceComponent', 'Context', -2:2),...
+        struct('type', 'AffineComponent', 'LinearParams',...
+        randn(50, 200)/sqrt(200), 'BiasParams', zeros(50, 1)),...
+        struct('type', 'TanhComponent'),...
+        struct('type', 'AffineComponent', 'LinearParams',...
+        4*randn(20, 50)/sqrt(50), 'BiasParams', zeros(20, 1)),...
+        struct('type', 'SoftmaxComponent')};
+    nnet.inputDim = 40;
+    nnet.outputDim = 20;
+    nnet.leftContext = 2;
+    nnet.rightContext = 2;
+    model.nnet = nnet;
+    wavFile = fullfile(pwd, 'data/src/recordings/pitch_0001.wav');
+    wav = audioread(wavFile);
+    wav = wav(:, 1)*32768;
+    mfcc = computeKaldiMfcc(wav, model.mfccOpts);
+    testCase.TestData.model = model;
+    testCase.TestData.wavFile = wavFile;
+    testCase.TestData.wav = wav;
+    testCase.TestData.mfcc = mfcc;
+    testCase.TestData.cmvnStats = accCmvnStats(mfcc);
+    % The LDA splicing and the nnet splicing
+    testCase.TestData.lookahead = 6;
+end
+
+function teardown(testCase)
+    testCase.TestData = [];
+end
+
+function testStreamPpgMatchesBatch(testCase)
+    model = testCase.TestData.model;
+    cmvnStats = testCase.TestData.cmvnStats;
+    ref = computePpg(testCase.TestData.mfcc, model, cmvnStats);
+    % A prior of many frames is the same as the stats of the whole utterance
+    streamOpts = {'Lookahead', testCase.TestData.lookahead,...
+        'CmvnWindow', Inf, 'CmvnPrior', cmvnStats, 'CmvnPriorFrames', 1e12};
+    for chunkSize = [37, 160, 4000]
+        post = streamAll(initPpgStream(model, streamOpts{:}),...
+            testCase.TestData.wav, chunkSize);
+        verifyClass(testCase, post, 'single');
+        verifyEqual(testCase, size(post), size(ref));
+        verifyEqual(testCase, post, ref, 'AbsTol', single(1e-4));
+    end
+end
+
+function testStreamPpgDriftReport(testCase)
+    model = testCase.TestData.model;
+    wavFile = testCase.TestData.wavFile;
+    cmvnStats = testCase.TestData.cmvnStats;
+    lookahead = testCase.TestData.lookahead;
+    ref = computePpg(testCase.TestData.mfcc, model, cmvnStats);
+
+    % No drift when the stream has the stats of the whole utterance
+    report = reportPpgStreamDrift({wavFile}, model, 'Reference', {ref},...
+        'Lookahead', lookahead, 'CmvnWindow', Inf, 'CmvnPrior', cmvnStats,...
+        'CmvnPriorFrames', 1e12);
+    verifyEqual(testCase, report.utt(1).numFrames, size(ref, 2));
+    verifyLessThan(testCase, report.maxAbsDiff, 1e-4);
+    verifyEqual(testCase, report.argmaxAgreement, 1);
+    verifyEqual(testCase, report.latencyMs, lookahead*5 + 12.5,...
+        'AbsTol', 1e-10);
+
+    % A causal window drifts, the reference is computed by the report
+    report = reportPpgStreamDrift({wavFile}, model, 'Lookahead', lookahead);
+    verifyEqual(testCase, report.utt(1).numFrames, size(ref, 2));
+    verifyGreaterThan(testCase, report.meanAbsDiff, 0);
+    verifyLessThanOrEqual(testCase, report.meanAbsDiff, report.maxAbsDiff);
+    verifyLessThanOrEqual(testCase, report.maxAbsDiff, 1);
+    verifyGreaterThanOrEqual(testCase, report.meanSymKL, 0);
+    verifyGreaterThanOrEqual(testCase, report.argmaxAgreement, 0);
+    verifyLessThanOrEqual(testCase, report.argmaxAgreement, 1);
+end
+
+function testStreamPpgCmvnWindow(testCase)
+    model = testCase.TestData.model;
+    mfcc = testCase.TestData.mfcc;
+    window = 50;
+    state = initPpgStream(model, 'CmvnWindow', window);
+    [~, state] = streamPpg(state, testCase.TestData.wav(1:24000));
+    numFrames = state.nextMfccFrame;
+    verifyGreaterThan(testCase, numFrames, window);
+    % The frames inside the audio so far are the same as the batch ones
+    refStats = accCmvnStats(mfcc(:, (numFrames-window+1):numFrames));
+    verifyEqual(testCase, state.cmvnStats(1, end), window);
+    verifyEqual(testCase, state.cmvnStats, refStats,...
+        'AbsTol', 1e-8*max(abs(refStats(:))));
+    % The window does not grow with the stream
+    verifySize(testCase, state.cmvnHistory, [size(mfcc, 1), window]);
+    wav = testCase.TestData.wav;
+    [~, state] = streamPpg(state, wav(24001:min(32000, end)));
+    verifyGreaterThan(testCase, state.nextMfccFrame, numFrames);
+    verifySize(testCase, state.cmvnHistory, [size(mfcc, 1), window]);
+    numFrames = state.nextMfccFrame;
+    refStats = accCmvnStats(mfcc(:, (numFrames-window+1):numFrames));
+    verifyEqual(testCase, state.cmvnStats, refStats,...
+        'AbsTol', 1e-8*max(abs(refStats(:))));
+end
+
+function testStreamPpgCmvnWarmUp(testCase)
+    model = testCase.TestData.model;
+    wav = testCase.TestData.wav;
+    priorFrames = 100;
+    noPrior = streamAll(initPpgStream(model, 'CmvnWindow', Inf), wav, 160);
+    withPrior = streamAll(initPpgStream(model, 'CmvnWindow', Inf,...
+        'CmvnPrior', testCase.TestData.cmvnStats,...
+        'CmvnPriorFrames', priorFrames), wav, 160);
+    verifyEqual(testCase, size(withPrior), size(noPrior));
+    verifyGreaterThan(testCase, size(noPrior, 2), 2*priorFrames);
+    % The prior changes the first frames
+    verifyGreaterThan(testCase,...
+        max(max(abs(withPrior(:, 1:10) - noPrior(:, 1:10)))), 0);
+    % and nothing once every spliced frame has the stats of 'priorFrames'
+    % frames or more
+    firstSame = priorFrames + model.leftContext + 2 + 1;
+    verifyEqual(testCase, withPrior(:, firstSame:end),...
+        noPrior(:, firstSame:end), 'AbsTol', single(1e-6));
+end
+
+% Push a wav into a stream in chunks, and collect the PPGs
+function post = streamAll(state, wav, chunkSize)
+    numSamples = length(wav);
+    numChunks = ceil(numSamples/chunkSize);
+    chunks = cell(1, numChunks);
+    for cc = 1:numChunks
+        chunkIdx = ((cc-1)*chunkSize + 1):min([cc*chunkSize, numSamples]);
+        [chunks{cc}, state] = streamPpg(state, wav(chunkIdx),...
+            cc == numChunks);
+    end
+    post = [chunks{:}];
+end
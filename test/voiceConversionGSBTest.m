@@ -62,4 +62,129 @@ function testVoiceConversionGSBmmse(testCase)
     isValidWav = sum(isnan(covUtt.wav)) == 0;
     verifyTrue(testCase, isValidWav);
     verifyTrue(testCase, logical(status));
-end
\ No newline at end of file
+end
+
+function testVoiceConversionGSBcache(testCase)
+    cacheDir = 'data/temp/vc_cache_test';
+    if exist(cacheDir, 'dir')
+        rmdir(cacheDir, 's');
+    end
+    cleanup = onCleanup(@() rmdir(cacheDir, 's'));
+    args = {testCase.TestData.utt, testCase.TestData.gmmMdl,...
+        testCase.TestData.srcPitchMdl, testCase.TestData.tgtPitchMdl,...
+        'SpecCov', 'MLPG', 'CacheDir', cacheDir};
+    coldUtt = voiceConversionGSB(args{:});
+    [warmUtt, status] = voiceConversionGSB(args{:});
+    verifyTrue(testCase, logical(status));
+    verifyEqual(testCase, warmUtt.wav, coldUtt.wav);
+    verifyEqual(testCase, warmUtt.mcep, coldUtt.mcep);
+end
+
+function testVoiceConversionGSBtopK(testCase)
+    args = {testCase.TestData.utt, testCase.TestData.gmmMdl,...
+        testCase.TestData.srcPitchMdl, testCase.TestData.tgtPitchMdl,...
+        'SpecCov', 'MLGV'};
+    numMix = testCase.TestData.gmmMdl.mix.ncentres;
+    fullUtt = voiceConversionGSB(args{:});
+    allUtt = voiceConversionGSB(args{:}, 'TopK', numMix);
+    verifyEqual(testCase, allUtt.mcep, fullUtt.mcep);
+    [topUtt, status] = voiceConversionGSB(args{:}, 'TopK', 4);
+    verifyTrue(testCase, logical(status));
+    verifyTrue(testCase, sum(isnan(topUtt.wav)) == 0);
+    verifyEqual(testCase, topUtt.mcep, fullUtt.mcep, 'AbsTol', 0.1);
+end
+
+function testVoiceConversionGSBoutputs(testCase)
+    args = {testCase.TestData.utt, testCase.TestData.gmmMdl,...
+        testCase.TestData.srcPitchMdl, testCase.TestData.tgtPitchMdl,...
+        'SpecCov', 'MMSE'};
+    fullUtt = voiceConversionGSB(args{:});
+    verifyFalse(testCase, isfield(fullUtt, 'deferred'));
+    [mcepUtt, status] = voiceConversionGSB(args{:}, 'Outputs', {'mcep'});
+    verifyTrue(testCase, logical(status));
+    verifyEqual(testCase, mcepUtt.mcep, fullUtt.mcep);
+    verifyFalse(testCase, any(isfield(mcepUtt, {'spec', 'mfcc', 'wav'})));
+    verifyEqual(testCase, sort(mcepUtt.deferred.outputs),...
+        {'mfcc', 'spec', 'wav'});
+    % The deferred outputs are the same when computed later
+    wavUtt = renderConversion(mcepUtt, {'wav'});
+    verifyEqual(testCase, wavUtt.wav, fullUtt.wav);
+    verifyFalse(testCase, isfield(wavUtt, 'spec'));
+    allUtt = renderConversion(wavUtt, {'spec', 'mfcc'});
+    verifyFalse(testCase, isfield(allUtt, 'deferred'));
+    verifyEqual(testCase, allUtt.mfcc, fullUtt.mfcc);
+    verifyEqual(testCase, allUtt.spec, fullUtt.spec);
+end
+
+function testVoiceConversionGSBskipSilence(testCase)
+    utt = testCase.TestData.utt;
+    args = {utt, testCase.TestData.gmmMdl, testCase.TestData.srcPitchMdl,...
+        testCase.TestData.tgtPitchMdl};
+    isSilent = isnan(utt.lab);
+    % Frame by frame, cutting the silence out changes nothing on speech
+    fullUtt = voiceConversionGSB(args{:}, 'SpecCov', 'MMSE',...
+        'SkipSilence', false);
+    [skipUtt, status] = voiceConversionGSB(args{:}, 'SpecCov', 'MMSE');
+    verifyTrue(testCase, logical(status));
+    verifyEqual(testCase, skipUtt.mcep, fullUtt.mcep, 'AbsTol', 1e-10);
+    verifyEqual(testCase, skipUtt.spec(:, isSilent), utt.spec(:, isSilent));
+    verifyEqual(testCase, skipUtt.spec(:, ~isSilent),...
+        fullUtt.spec(:, ~isSilent), 'AbsTol', 1e-10);
+    verifyTrue(testCase, sum(isnan(skipUtt.wav)) == 0);
+    % The trajectories only move near the edges of the speech
+    fullUtt = voiceConversionGSB(args{:}, 'SpecCov', 'MLPG',...
+        'SkipSilence', false, 'Outputs', {'mcep'});
+    skipUtt = voiceConversionGSB(args{:}, 'SpecCov', 'MLPG',...
+        'Outputs', {'mcep'});
+    verifyEqual(testCase, skipUtt.mcep(:, isSilent), utt.mcep(:, isSilent));
+    verifyEqual(testCase, skipUtt.mcep, fullUtt.mcep, 'AbsTol', 0.1);
+    % Segments of the trajectory matrix are independent
+    verifyEqual(testCase, full(generateW(5, 3, [2, 3])),...
+        full(blkdiag(generateW(2, 3), generateW(3, 3))));
+end
+
+function testSelectGaussians(testCase)
+    mix = testCase.TestData.gmmMdl.mix;
+    xDim = mix.nin/2;
+    x = mix.centres(1:10, 1:xDim) + 0.01;
+    [idx, post] = selectGaussians(mix, x, 3);
+    verifySize(testCase, idx, [10, 3]);
+    verifyEqual(testCase, sum(post, 2), ones(10, 1), 'AbsTol', 1e-10);
+    verifyTrue(testCase, all(all(diff(post, 1, 2) <= 0)));
+    % The best mixture matches the exact posteriors of all the mixtures
+    logProb = gmmLogDensity(mix, x, 1:xDim, repmat(1:mix.ncentres, 10, 1));
+    [~, best] = max(logProb, [], 2);
+    verifyEqual(testCase, idx(:, 1), best);
+    % Frames away from the centres: the diagonal pre-score is only an
+    % approximation, so check the recall against exhaustive scoring
+    rng(0);
+    numFrames = 200;
+    comp = randi(mix.ncentres, numFrames, 1);
+    x = mix.centres(comp, 1:xDim);
+    for t = 1:numFrames
+        if strcmp(mix.covar_type, 'full')
+            x(t, :) = x(t, :) + randn(1, xDim)*...
+                chol(mix.covars(1:xDim, 1:xDim, comp(t)));
+        else
+            x(t, :) = x(t, :) + randn(1, xDim).*...
+                sqrt(mix.covars(comp(t), 1:xDim));
+        end
+    end
+    k = 3;
+    idx = selectGaussians(mix, x, k);
+    logProb = gmmLogDensity(mix, x, 1:xDim,...
+        repmat(1:mix.ncentres, numFrames, 1));
+    [~, exact] = sort(logProb, 2, 'descend');
+    exact = exact(:, 1:k);
+    recall = 0;
+    for t = 1:numFrames
+        recall = recall + numel(intersect(idx(t, :), exact(t, :)));
+    end
+    recall = recall/(numFrames*k);
+    verifyGreaterThanOrEqual(testCase, recall, 0.9);
+    verifyGreaterThanOrEqual(testCase, mean(idx(:, 1) == exact(:, 1)),...
+        0.95);
+    % A shortlist of all the mixtures is exhaustive scoring
+    idx = selectGaussians(mix, x, k, 'Shortlist', mix.ncentres);
+    verifyEqual(testCase, idx, exact);
+end
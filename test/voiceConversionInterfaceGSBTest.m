@@ -86,4 +86,37 @@ function testVoiceConversionInterfaceGSBmultipleUttParallel(testCase)
     end
     % Status is valid
     verifyTrue(testCase, logical(status));
-end
\ No newline at end of file
+end
+function testVoiceConversionBatchGSB(testCase)
+    testUtts = {'data/src/cache/mat/gsb_0001.mat',...
+        'data/src/cache/mat/gsb_0002.mat',...
+        'data/src/cache/mat/gsb_0003.mat'};
+    
+    [wavFiles, report] = voiceConversionBatchGSB(testUtts,...
+        testCase.TestData.gmmPath, testCase.TestData.srcPitchPath,...
+        testCase.TestData.tgtPitchPath, testCase.TestData.outputPath,...
+        'NumWorkers', 2);
+    
+    for ii = 1:length(wavFiles)
+        % Wav is saved, in the input order
+        [~, uttName] = fileparts(testUtts{ii});
+        verifyEqual(testCase, wavFiles{ii},...
+            fullfile(testCase.TestData.outputPath, [uttName, '.wav']));
+        verifyTrue(testCase, logical(exist(wavFiles{ii}, 'file')));
+    end
+    verifyEqual(testCase, report.numUtts, 3);
+    verifyGreaterThan(testCase, report.rtf, 0);
+end
+
+function testWarmConversionModel(testCase)
+    gmmMdl = load(testCase.TestData.gmmPath);
+    srcPitchMdl = load(testCase.TestData.srcPitchPath);
+    tgtPitchMdl = load(testCase.TestData.tgtPitchPath);
+    utt = loadUttGSB({'data/src/cache/mat/gsb_0001.mat'});
+    
+    % The warm model gives the same conversion as the cold one
+    coldUtt = voiceConversionGSB(utt, gmmMdl, srcPitchMdl, tgtPitchMdl);
+    warmUtt = voiceConversionGSB(utt, warmConversionModel(gmmMdl),...
+        srcPitchMdl, tgtPitchMdl);
+    verifyEqual(testCase, warmUtt.mcep, coldUtt.mcep, 'AbsTol', 1e-8);
+end
@@ -0,0 +1,87 @@
+% Copyright 2026 Guanlong Zhao
+% 
+% Licensed under the Apache License, Version 2.0 (the "License");
+% you may not use this file except in compliance with the License.
+% You may obtain a copy of the License at
+% 
+%     http://www.apache.org/licenses/LICENSE-2.0
+% 
+% Unless required by applicable law or agreed to in writing, software
+% distributed under the License is distributed on an "AS IS" BASIS,
+% WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+% See the License for the specific language governing permissions and
+% limitations under the License.
+
+% Test voiceConversionLongGSB
+%   - an utterance that fits in a chunk is converted as it is
+%   - the chunks cover the whole utterance, and the crossfaded mcep is
+%   close to the one of the whole utterance
+%   - chunks as short as three overlaps are crossfaded without a gain
+%   error, and shorter ones are rejected
+
+function tests = voiceConversionLongGSBTest
+    tests = functiontests(localfunctions);
+end
+
+function setupOnce(testCase)
+    testUttPath = 'data/src/cache/mat/gsb_0001.mat';
+    testCase.TestData.utt = loadUttGSB({testUttPath},...
+        'RegExp', '^(?!post)\w');
+    testCase.TestData.gmmMdl = load('data/model/acoustic/ppg_gmm_model.mat');
+    testCase.TestData.srcPitchMdl = load('data/model/pitch/src_model.mat');
+    testCase.TestData.tgtPitchMdl = load('data/model/pitch/tgt_model.mat');
+end
+
+function teardownOnce(testCase)
+    testCase.TestData = [];
+end
+
+function testVoiceConversionLongGSBOneChunk(testCase)
+    utt = testCase.TestData.utt;
+    args = {testCase.TestData.gmmMdl, testCase.TestData.srcPitchMdl,...
+        testCase.TestData.tgtPitchMdl, 'SpecCov', 'MMSE'};
+    refUtt = voiceConversionGSB(utt, args{:}, 'Outputs', {'mcep', 'wav'});
+    [longUtt, status] = voiceConversionLongGSB(utt, args{:});
+    verifyTrue(testCase, logical(status));
+    verifyEqual(testCase, longUtt.mcep, refUtt.mcep);
+    verifyEqual(testCase, longUtt.wav, refUtt.wav);
+end
+
+function testVoiceConversionLongGSBChunks(testCase)
+    utt = testCase.TestData.utt;
+    args = {testCase.TestData.gmmMdl, testCase.TestData.srcPitchMdl,...
+        testCase.TestData.tgtPitchMdl, 'SpecCov', 'MLPG'};
+    refUtt = voiceConversionGSB(utt, args{:}, 'Outputs', {'mcep', 'wav'});
+    % Chunks of a second, much shorter than the utterance
+    [longUtt, status] = voiceConversionLongGSB(utt, args{:},...
+        'ChunkSec', 1, 'OverlapSec', 0.1, 'SearchSec', 0.3,...
+        'Outputs', {'mcep', 'mfcc', 'wav'});
+    verifyTrue(testCase, logical(status));
+    verifySize(testCase, longUtt.mcep, size(utt.mcep));
+    verifySize(testCase, longUtt.mfcc, size(utt.mfcc));
+    verifyEqual(testCase, longUtt.mcep, refUtt.mcep, 'AbsTol', 0.1);
+    verifyEqual(testCase, sum(isnan(longUtt.wav)), 0);
+    verifyLessThanOrEqual(testCase,...
+        abs(length(longUtt.wav) - length(refUtt.wav)), 1);
+end
+
+function testVoiceConversionLongGSBShortChunks(testCase)
+    utt = testCase.TestData.utt;
+    args = {testCase.TestData.gmmMdl, testCase.TestData.srcPitchMdl,...
+        testCase.TestData.tgtPitchMdl, 'SpecCov', 'MMSE'};
+    refUtt = voiceConversionGSB(utt, args{:}, 'Outputs', {'mcep', 'wav'});
+    % Less than three overlaps, the cuts could be closer than the crossfade
+    verifyError(testCase, @() voiceConversionLongGSB(utt, args{:},...
+        'ChunkSec', 0.25, 'OverlapSec', 0.1), ?MException);
+    % The shortest chunks allowed, the MMSE estimate is per frame, so the
+    % chunks are close to the whole utterance unless the crossfade weights
+    % do not add up to 1
+    [longUtt, status] = voiceConversionLongGSB(utt, args{:},...
+        'ChunkSec', 0.3, 'OverlapSec', 0.1, 'SearchSec', 0.1);
+    verifyTrue(testCase, logical(status));
+    verifySize(testCase, longUtt.mcep, size(utt.mcep));
+    verifyEqual(testCase, longUtt.mcep, refUtt.mcep, 'AbsTol', 0.1);
+    verifyEqual(testCase, sum(isnan(longUtt.wav)), 0);
+    verifyEqual(testCase, rms(longUtt.wav), rms(refUtt.wav),...
+        'RelTol', 0.1);
+end